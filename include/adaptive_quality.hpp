@@ -0,0 +1,90 @@
+/**
+ * @file adaptive_quality.hpp
+ * @brief Frame-budget controller that trades edge-map quality for latency in steps
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "latency_histogram.hpp"
+#include <chrono>
+#include <cstddef>
+
+namespace sobel {
+
+/**
+ * @brief Processing tiers, cheapest last; each tier keeps the savings of the ones above it
+ */
+enum class QualityTier {
+    Full,             // Configured kernel, L2 magnitude, full resolution
+    L1Magnitude,      // |gx| + |gy| instead of sqrt(gx^2 + gy^2)
+    Kernel3x3,        // 3x3 kernel regardless of the configured size
+    HalfResolution    // Filter a 2x2-averaged frame, upsample the edge map
+};
+
+constexpr std::size_t kQualityTierCount = 4;
+
+/**
+ * @brief Printable tier name
+ */
+const char* qualityTierName(QualityTier tier);
+
+/**
+ * @brief Budget and hysteresis of the adaptive quality mode
+ */
+struct AdaptiveQualityConfig {
+    bool enabled = false;
+    std::chrono::nanoseconds budget = kDefaultFrameDeadline;
+    std::size_t window = 8;          // Frames averaged (and held) before a tier change without a miss
+    double downshift_ratio = 0.9;    // Step down when the recent mean exceeds this share of the budget
+    double upshift_ratio = 0.5;      // Step up when the recent mean stays below this share
+    QualityTier lowest_tier = QualityTier::HalfResolution;
+};
+
+/**
+ * @brief Chooses the tier of the next frame from the times of recent ones
+ *
+ * The recent mean is an exponential moving average over about `window`
+ * frames, restarted at every tier change so a new tier is judged on its own
+ * frames. A frame over budget steps down at once; otherwise the tier only
+ * changes after `window` frames in it. Stepping up needs a mean well below
+ * the budget (upshift_ratio < downshift_ratio), and a step up that has to be
+ * undone within `window` frames doubles the hold before the next try (up to
+ * 64 windows), so a tier just too slow for the budget is not retried every
+ * few frames.
+ */
+class QualityController {
+public:
+    /**
+     * @throws std::invalid_argument for a non-positive budget, an empty window
+     *         or ratios outside 0 < upshift_ratio < downshift_ratio
+     */
+    explicit QualityController(const AdaptiveQualityConfig& config = AdaptiveQualityConfig());
+
+    const AdaptiveQualityConfig& config() const { return config_; }
+    QualityTier tier() const { return tier_; }
+
+    /**
+     * @brief Account the frame just processed at tier() and return the tier for the next one
+     */
+    QualityTier update(std::chrono::nanoseconds frameTime);
+
+    /**
+     * @brief Back to full quality with no history
+     */
+    void reset();
+
+private:
+    void changeTier(QualityTier tier);
+
+    AdaptiveQualityConfig config_;
+    QualityTier tier_ = QualityTier::Full;
+    std::size_t framesInTier_ = 0;
+    std::size_t upHold_ = 0;          // Frames required before stepping up
+    bool steppedUp_ = false;          // The current tier was entered by stepping up
+    double meanNs_ = 0.0;
+};
+
+} // namespace sobel
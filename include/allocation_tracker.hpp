@@ -0,0 +1,162 @@
+/**
+ * @file allocation_tracker.hpp
+ * @brief Heap allocation accounting attributed to pipeline stages
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "stage_timer.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Stage attribution is compiled in unless the build sets SOBEL_ALLOC_TRACKING=0. The counting global
+// operator new/delete live in allocation_hooks.cpp (the sobel_alloc_hooks object library), which only
+// programs that want the accounting link; sobel_core itself leaves the allocator alone.
+#ifndef SOBEL_ALLOC_TRACKING
+#define SOBEL_ALLOC_TRACKING 1
+#endif
+
+namespace sobel {
+
+/**
+ * @brief Heap activity of one stage (or a whole call)
+ */
+struct AllocationStats {
+    uint64_t count = 0;           // operator new calls
+    uint64_t bytes = 0;           // Bytes requested
+    uint64_t peakLiveBytes = 0;   // Highest net bytes held since the recording began
+
+    void merge(const AllocationStats& other) {
+        count += other.count;
+        bytes += other.bytes;
+        peakLiveBytes = other.peakLiveBytes > peakLiveBytes ? other.peakLiveBytes : peakLiveBytes;
+    }
+};
+
+using AllocationStages = std::array<AllocationStats, kPipelineStageCount>;
+
+/**
+ * @brief True when the counting operator new/delete are linked into the program
+ */
+bool allocationTrackingEnabled();
+
+/**
+ * @brief Bytes currently allocated through operator new by the whole process (0 without the hooks)
+ */
+uint64_t heapLiveBytes();
+
+// Called by the allocation hooks
+void markAllocationHooksInstalled() noexcept;
+void recordHeapAllocation(std::size_t bytes) noexcept;
+void recordHeapFree(std::size_t bytes) noexcept;
+
+/**
+ * @brief Records the heap activity of the calling thread between begin() and end()
+ *
+ * Allocations are attributed to the stage set by the innermost
+ * ScopedAllocationStage (allocations outside any stage only count towards
+ * total()). Live bytes are net of frees on the same thread since begin(),
+ * so peakLiveBytes is the extra memory a call needs on top of what the
+ * caller already holds. Recorders nest; only the innermost one records.
+ */
+class AllocationRecorder {
+public:
+    AllocationRecorder() = default;
+    ~AllocationRecorder();
+
+    AllocationRecorder(const AllocationRecorder&) = delete;
+    AllocationRecorder& operator=(const AllocationRecorder&) = delete;
+    // The counts move over; a recording source stops recording and the target starts idle
+    AllocationRecorder(AllocationRecorder&& other) noexcept;
+    AllocationRecorder& operator=(AllocationRecorder&& other) noexcept;
+
+    /**
+     * @brief Clear the counts and start recording on the calling thread
+     */
+    void begin();
+
+    /**
+     * @brief Stop recording (no-op when not recording)
+     */
+    void end();
+
+    const AllocationStages& stages() const { return stages_; }
+    const AllocationStats& total() const { return total_; }
+
+    // Called by the allocation hooks
+    void onAllocate(std::size_t bytes, int stage);
+    void onFree(std::size_t bytes);
+
+private:
+    AllocationStages stages_{};
+    AllocationStats total_;
+    int64_t liveBytes_ = 0;
+    bool active_ = false;
+    AllocationRecorder* previous_ = nullptr;
+};
+
+/**
+ * @brief Recorder and stage the calling thread's allocations go to
+ */
+struct AllocationContext {
+    AllocationRecorder* recorder = nullptr;
+    int stage = -1;
+};
+
+/**
+ * @brief The calling thread's allocation context (for handing to fork-join helpers)
+ */
+AllocationContext currentAllocationContext() noexcept;
+
+/**
+ * @brief Records the calling thread's allocations into `context` for its scope
+ *
+ * Lets the workers of a fork-join loop count towards the recorder of the thread
+ * that forked it: every worker, the forking thread included, opens one with the
+ * forking thread's context, and the shared recorder is then updated under a
+ * lock. The forking thread must not allocate outside such a scope until the
+ * loop has joined.
+ */
+class ScopedAllocationContext {
+public:
+    explicit ScopedAllocationContext(const AllocationContext& context) noexcept;
+    ~ScopedAllocationContext();
+
+    ScopedAllocationContext(const ScopedAllocationContext&) = delete;
+    ScopedAllocationContext& operator=(const ScopedAllocationContext&) = delete;
+
+private:
+    AllocationContext previous_;
+    bool previousShared_;
+};
+
+/**
+ * @brief Attributes allocations on the calling thread to `stage` for its scope
+ */
+class ScopedAllocationStage {
+public:
+    explicit ScopedAllocationStage(PipelineStage stage);
+    ~ScopedAllocationStage();
+
+    ScopedAllocationStage(const ScopedAllocationStage&) = delete;
+    ScopedAllocationStage& operator=(const ScopedAllocationStage&) = delete;
+
+private:
+    int previous_;
+};
+
+} // namespace sobel
+
+#if SOBEL_ALLOC_TRACKING
+#define SOBEL_ALLOC_CONCAT_(a, b) a##b
+#define SOBEL_ALLOC_NAME_(line) SOBEL_ALLOC_CONCAT_(sobelAllocStage_, line)
+#define SOBEL_ALLOC_STAGE(stage) ::sobel::ScopedAllocationStage SOBEL_ALLOC_NAME_(__LINE__)(stage)
+#define SOBEL_ALLOC_CONTEXT(context) ::sobel::ScopedAllocationContext SOBEL_ALLOC_NAME_(__LINE__)(context)
+#else
+#define SOBEL_ALLOC_STAGE(stage) ((void)0)
+#define SOBEL_ALLOC_CONTEXT(context) ((void)(context))
+#endif
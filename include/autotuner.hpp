@@ -0,0 +1,132 @@
+/**
+ * @file autotuner.hpp
+ * @brief Per-host tuning of kernel level, band height and thread count with a persistent wisdom file
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "benchmark_harness.hpp"
+#include "sobel_engine.hpp"
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sobel {
+
+struct SobelConfig;
+
+/**
+ * @brief How SobelFilterSIMD executes a frame
+ */
+struct TuningParameters {
+    SimdLevel level = SimdLevel::Scalar;
+    std::size_t band_height = 0;   // Rows per work item handed to a thread (0 = whole frame)
+    unsigned threads = 1;          // Worker threads per frame (0 = hardware concurrency)
+};
+
+/**
+ * @brief Printable level name ("Scalar", "SSE4.1", "AVX2")
+ */
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief True when `level` is compiled in and supported by this CPU
+ */
+bool isSimdLevelUsable(SimdLevel level);
+
+/**
+ * @brief Tuned parameters for one host and resolution
+ */
+struct WisdomEntry {
+    std::string cpu;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    TuningParameters parameters;
+    double medianNs = 0.0;   // Frame time of the winner when it was tuned
+};
+
+/**
+ * @brief Wisdom file used by OptimizationLevel::AUTO: $SOBEL_WISDOM, else "sobel_wisdom.tsv"
+ */
+std::string defaultWisdomPath();
+
+/**
+ * @brief Load a wisdom file (missing file = no wisdom)
+ * @throws std::runtime_error on malformed lines
+ */
+std::vector<WisdomEntry> loadWisdom(const std::string& path);
+
+/**
+ * @brief Merge an entry into a wisdom file, replacing the one for the same CPU and resolution
+ * @throws std::runtime_error if the file cannot be written
+ */
+void saveWisdom(const std::string& path, const WisdomEntry& entry);
+
+/**
+ * @brief Entry for this CPU and resolution, if any
+ */
+std::optional<TuningParameters> findWisdom(const std::vector<WisdomEntry>& wisdom, const std::string& cpu,
+                                           std::size_t width, std::size_t height);
+
+/**
+ * @brief Lookup used by AUTO filters
+ *
+ * The default wisdom file is read once, on first use; unreadable or
+ * malformed files count as empty. Entries whose level this CPU cannot run
+ * are ignored.
+ */
+std::optional<TuningParameters> lookupWisdom(std::size_t width, std::size_t height);
+
+/**
+ * @brief Replace the process-wide wisdom used by lookupWisdom() with the contents of `path`
+ * @return Number of entries loaded (0 for a missing or malformed file)
+ */
+std::size_t reloadWisdom(const std::string& path);
+
+/**
+ * @brief Candidate space and timing budget of a tuning run
+ *
+ * Empty lists pick defaults: every usable level; 1, 2, 4, ... up to the
+ * hardware concurrency; band heights of 16, 64 and 256 rows plus whole
+ * frames. Band heights are only varied for multi-threaded candidates,
+ * since a single thread walks the frame in order either way.
+ */
+struct AutotuneOptions {
+    std::vector<SimdLevel> levels;
+    std::vector<std::size_t> band_heights;
+    std::vector<unsigned> thread_counts;
+    BenchmarkOptions bench;
+
+    AutotuneOptions() {
+        bench.warmup_time = std::chrono::milliseconds(20);
+        bench.target_time = std::chrono::milliseconds(150);
+        bench.min_iterations = 10;
+    }
+};
+
+/**
+ * @brief Timing of one candidate
+ */
+struct TuningCandidate {
+    TuningParameters parameters;
+    BenchmarkStats stats;
+};
+
+struct AutotuneResult {
+    TuningParameters best;
+    double bestMedianNs = 0.0;
+    std::vector<TuningCandidate> candidates;
+};
+
+/**
+ * @brief Time every candidate on a synthetic frame of the target size and pick the fastest median
+ * @throws std::invalid_argument for an empty resolution
+ */
+AutotuneResult autotune(std::size_t width, std::size_t height, const SobelConfig& config,
+                        const AutotuneOptions& options = AutotuneOptions());
+
+} // namespace sobel
@@ -0,0 +1,180 @@
+/**
+ * @file benchmark_harness.hpp
+ * @brief Auto-calibrating micro-benchmark harness with robust statistics
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sobel {
+
+/**
+ * @brief Controls warm-up, calibration and sample count
+ *
+ * Warm-up runs for at least `warmup_time` (long enough for the core to leave
+ * its idle frequency), then the sample count is chosen so sampling takes
+ * about `target_time`, clamped to [min_iterations, max_iterations].
+ */
+struct BenchmarkOptions {
+    std::chrono::milliseconds warmup_time{200};
+    std::chrono::milliseconds target_time{1000};
+    std::size_t min_iterations = 50;      // Enough samples for a meaningful p99
+    std::size_t max_iterations = 100000;
+    std::size_t iterations = 0;           // Fixed sample count (0 = auto-calibrate)
+    int pin_cpu = -1;                     // Pin the calling thread to this CPU (-1 = no pinning)
+};
+
+/**
+ * @brief Summary statistics of per-iteration wall times (nanoseconds)
+ */
+struct BenchmarkStats {
+    std::size_t iterations = 0;
+    double min = 0.0;
+    double median = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;     // Sample standard deviation
+    std::vector<double> samples;
+};
+
+/**
+ * @brief One named benchmark result plus its workload description
+ */
+struct BenchmarkRecord {
+    std::string name;            // e.g. "simd"
+    std::string implementation;  // e.g. "AVX2"
+    int kernelSize = 5;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    BenchmarkStats stats;
+
+    double pixelsPerSecond() const {
+        return stats.median > 0.0 ? static_cast<double>(width * height) * 1e9 / stats.median : 0.0;
+    }
+};
+
+/**
+ * @brief Compute statistics from raw samples
+ * @param samples Per-iteration times in nanoseconds (consumed)
+ * @return Statistics; percentiles use linear interpolation between ranks
+ */
+BenchmarkStats computeStats(std::vector<double> samples);
+
+/**
+ * @brief Warm up, calibrate and time `body`, one sample per call
+ * @param body Work to measure
+ * @param options Warm-up, calibration and pinning options
+ * @return Statistics over the timed samples
+ */
+BenchmarkStats runBenchmark(const std::function<void()>& body, const BenchmarkOptions& options = BenchmarkOptions());
+
+/**
+ * @brief Pin the calling thread to one CPU
+ * @return false when pinning is unsupported or refused
+ */
+bool pinCurrentThread(int cpu);
+
+/**
+ * @brief CPU brand string (e.g. from CPUID), "unknown" when unavailable
+ */
+std::string cpuModelName();
+
+/**
+ * @brief Data cache sizes in bytes (0 when unknown)
+ */
+struct CacheHierarchy {
+    std::size_t l1d = 0;
+    std::size_t l2 = 0;
+    std::size_t llc = 0;
+
+    /**
+     * @brief Smallest level that holds `bytes`: "L1", "L2", "LLC" or "DRAM"
+     */
+    const char* levelFor(std::size_t bytes) const;
+};
+
+/**
+ * @brief Cache sizes of CPU 0 (sysfs on Linux, GetLogicalProcessorInformation on Windows)
+ */
+CacheHierarchy detectCacheHierarchy();
+
+/**
+ * @brief Human-readable frequency scaling state (governor, turbo) for the report
+ */
+std::string frequencyScalingInfo(int cpu = 0);
+
+/**
+ * @brief Key identifying a benchmark across runs: CPU model, name, implementation, kernel and size
+ */
+std::string baselineKey(const std::string& cpu, const BenchmarkRecord& record);
+
+/**
+ * @brief A stored benchmark result and the CPU it was measured on
+ */
+struct BaselineEntry {
+    std::string cpu;
+    BenchmarkRecord record;
+};
+
+/**
+ * @brief Load a baseline file (missing file = empty baseline)
+ * @throws std::runtime_error on malformed lines
+ */
+std::vector<BaselineEntry> loadBaseline(const std::string& path);
+
+/**
+ * @brief Merge records into a baseline file, replacing entries with the same key
+ * @throws std::runtime_error if the file cannot be written
+ */
+void saveBaseline(const std::string& path, const std::string& cpu, const std::vector<BenchmarkRecord>& records);
+
+/**
+ * @brief One-sided Mann-Whitney U test that `current` tends to be larger than `baseline`
+ * @return p-value from the tie-corrected normal approximation (1.0 for empty inputs)
+ */
+double mannWhitneySlowerPValue(const std::vector<double>& baseline, const std::vector<double>& current);
+
+/**
+ * @brief Outcome of comparing one record against the baseline
+ */
+struct RegressionCheck {
+    std::string key;
+    bool hasBaseline = false;
+    double baselineMedian = 0.0;   // ns
+    double currentMedian = 0.0;    // ns
+    double change = 0.0;           // currentMedian / baselineMedian - 1
+    double pValue = 1.0;
+    bool regressed = false;        // slower beyond threshold and statistically significant
+};
+
+/**
+ * @brief Compare records against baseline entries for the same CPU
+ * @param threshold Relative median slowdown that counts as a regression (0.05 = 5%)
+ * @param alpha Significance level of the Mann-Whitney test
+ */
+std::vector<RegressionCheck> compareToBaseline(const std::vector<BaselineEntry>& baseline, const std::string& cpu,
+                                               const std::vector<BenchmarkRecord>& records,
+                                               double threshold, double alpha);
+
+/**
+ * @brief Write records as a JSON document with a small environment header
+ */
+void writeBenchmarkJson(std::ostream& out, const std::vector<BenchmarkRecord>& records);
+
+/**
+ * @brief Write records as CSV, one row per record
+ */
+void writeBenchmarkCsv(std::ostream& out, const std::vector<BenchmarkRecord>& records);
+
+} // namespace sobel
@@ -0,0 +1,128 @@
+/**
+ * @file canny.hpp
+ * @brief Gradient orientation and Canny edge stages over streamed gradient rows
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "sobel_engine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace sobel {
+
+/**
+ * @brief Gradient direction quantized to four bins (image y axis points down)
+ */
+enum class GradientDirection : uint8_t {
+    Horizontal = 0,   // |angle| < 22.5 degrees
+    Diagonal45 = 1,   // Gx and Gy share a sign
+    Vertical = 2,     // |angle| > 67.5 degrees
+    Diagonal135 = 3   // Gx and Gy have opposite signs
+};
+
+/**
+ * @brief Configuration for the Canny stage
+ *
+ * Thresholds are on the classic 3x3 Sobel magnitude scale: magnitudes from
+ * larger kernels are divided by their extra gain, so the same thresholds
+ * work for every kernel size.
+ */
+struct CannyConfig {
+    float low_threshold = 50.0f;   // Weak edge threshold
+    float high_threshold = 150.0f; // Strong edge threshold
+
+    CannyConfig() = default;
+
+    CannyConfig(float low, float high) : low_threshold(low), high_threshold(high) {}
+};
+
+// tan(22.5 deg) and tan(67.5 deg) in 1/1024 fixed point
+constexpr int32_t kTan22_5Q10 = 424;
+constexpr int32_t kTan67_5Q10 = 2472;
+
+/**
+ * @brief Quantize the gradient direction without atan2
+ *
+ * Compares |Gy| against |Gx| scaled by tan(22.5) and tan(67.5), then uses
+ * the sign of Gx * Gy to pick the diagonal. Valid for |G| < 2^19.
+ *
+ * @param gx X gradient
+ * @param gy Y gradient
+ * @return Direction bin
+ */
+inline GradientDirection quantizeDirection(int32_t gx, int32_t gy) {
+    const int32_t ax = std::abs(gx);
+    const int32_t ay = std::abs(gy) << 10;
+    if (ay <= ax * kTan22_5Q10) return GradientDirection::Horizontal;
+    if (ay > ax * kTan67_5Q10) return GradientDirection::Vertical;
+    return (gx ^ gy) >= 0 ? GradientDirection::Diagonal45 : GradientDirection::Diagonal135;
+}
+
+/**
+ * @brief Quantize the directions of one gradient row
+ * @param level Instruction set to use
+ * @param gx X gradients
+ * @param gy Y gradients
+ * @param width Number of pixels
+ * @param direction Output GradientDirection values (width entries)
+ */
+void orientationRow(SimdLevel level, const int32_t* gx, const int32_t* gy, std::size_t width,
+                    uint8_t* direction);
+
+/**
+ * @brief Non-maximum suppression and double thresholding for one row
+ *
+ * Each pixel is compared with its two neighbours along the quantized
+ * gradient direction. The magnitude rows must have readable entries at
+ * index -1 and `width` (zero for pixels outside the image).
+ *
+ * @param level Instruction set to use
+ * @param above Magnitudes of the previous row
+ * @param center Magnitudes of the current row
+ * @param below Magnitudes of the next row
+ * @param gx X gradients of the current row
+ * @param gy Y gradients of the current row
+ * @param width Number of pixels
+ * @param low Weak threshold (same units as the magnitudes)
+ * @param high Strong threshold (same units as the magnitudes)
+ * @param state Output: 0 suppressed, 1 weak, 2 strong
+ */
+void nonMaximumSuppressionRow(SimdLevel level, const float* above, const float* center, const float* below,
+                              const int32_t* gx, const int32_t* gy, std::size_t width,
+                              float low, float high, uint8_t* state);
+
+/**
+ * @brief Promote weak pixels connected to strong ones (8-connectivity)
+ *
+ * Uses an explicit stack seeded with every strong pixel, so the cost is
+ * linear in the number of pixels and there is no recursion.
+ *
+ * @param level Instruction set used for the seed scan
+ * @param state Pointer to pixel (0, 0) of a state map with a one-pixel zero border
+ * @param stride Row stride of the state map
+ * @param width Image width
+ * @param height Image height
+ * @param stack Reusable work stack
+ */
+void hysteresis(SimdLevel level, uint8_t* state, std::ptrdiff_t stride, std::size_t width,
+                std::size_t height, std::vector<uint8_t*>& stack);
+
+/**
+ * @brief Write 255 for strong pixels and 0 elsewhere
+ * @param level Instruction set to use
+ * @param state Pointer to pixel (0, 0) of the state map
+ * @param stride Row stride of the state map
+ * @param width Image width
+ * @param height Image height
+ * @param output Row-major output (width * height)
+ */
+void finalizeEdges(SimdLevel level, const uint8_t* state, std::ptrdiff_t stride, std::size_t width,
+                   std::size_t height, uint8_t* output);
+
+} // namespace sobel
@@ -0,0 +1,211 @@
+/**
+ * @file convolution_engine.hpp
+ * @brief Runtime-configurable integer convolution with separability detection
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "image.hpp"
+#include "sobel_engine.hpp"
+#include "sobel_kernels.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sobel {
+
+/**
+ * @brief How pixels outside the image are treated by convolution
+ */
+enum class BorderMode {
+    Replicate,  // Clamp coordinates to the nearest edge pixel
+    Zero        // Treat outside pixels as 0
+};
+
+/**
+ * @brief Integer convolution kernel with odd width and height
+ */
+class ConvolutionKernel {
+public:
+    /**
+     * @brief Construct kernel from row-major coefficients
+     * @param width Kernel width (odd)
+     * @param height Kernel height (odd)
+     * @param coefficients width * height coefficients, row-major
+     * @throws std::invalid_argument if dimensions are even/zero or sizes mismatch
+     */
+    ConvolutionKernel(std::size_t width, std::size_t height, std::vector<int> coefficients);
+
+    /**
+     * @brief Construct kernel from a square compile-time Sobel kernel
+     */
+    template<int N>
+    static ConvolutionKernel fromArray(const SobelKernel<N>& kernel) {
+        std::vector<int> coefficients;
+        coefficients.reserve(N * N);
+        for (const auto& row : kernel) {
+            coefficients.insert(coefficients.end(), row.begin(), row.end());
+        }
+        return ConvolutionKernel(N, N, std::move(coefficients));
+    }
+
+    /**
+     * @brief NxN Sobel kernels (N = 3, 5 or 7)
+     * @throws std::invalid_argument for other sizes
+     */
+    static ConvolutionKernel sobelX(int size);
+    static ConvolutionKernel sobelY(int size);
+
+    /**
+     * @brief 3x3 Scharr kernels ([3 10 3] smoothing, [-1 0 1] derivative)
+     */
+    static ConvolutionKernel scharrX();
+    static ConvolutionKernel scharrY();
+
+    std::size_t width() const noexcept { return width_; }
+    std::size_t height() const noexcept { return height_; }
+    int at(std::size_t x, std::size_t y) const { return coefficients_[y * width_ + x]; }
+    const std::vector<int>& coefficients() const noexcept { return coefficients_; }
+
+private:
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<int> coefficients_;
+};
+
+/**
+ * @brief Implementation chosen for a kernel
+ */
+enum class ConvolutionPath {
+    Separable,   // Column pass then row pass, int32 accumulation
+    DenseInt16,  // Full 2D taps, worst case fits int16
+    DenseInt32   // Full 2D taps, int32 accumulation
+};
+
+/**
+ * @brief Convolution engine that analyses a kernel once and picks the fastest path
+ *
+ * On construction the kernel is tested for rank 1. A separable kernel is
+ * factored into integer column and row vectors and runs as two 1D passes.
+ * Otherwise the dense path accumulates in int16 when the worst-case response
+ * for 8-bit input fits, and in int32 when it does not.
+ */
+class ConvolutionEngine {
+public:
+    /**
+     * @brief Analyse kernel and select the convolution path
+     * @param kernel Convolution kernel
+     */
+    explicit ConvolutionEngine(const ConvolutionKernel& kernel);
+
+    /**
+     * @brief Force a specific path (for testing and benchmarking)
+     * @param path Desired path
+     * @throws std::invalid_argument if the kernel cannot use that path
+     */
+    void setPath(ConvolutionPath path);
+
+    ConvolutionPath path() const noexcept { return path_; }
+    bool isSeparable() const noexcept { return separable_; }
+    const ConvolutionKernel& kernel() const noexcept { return kernel_; }
+
+    /**
+     * @brief Integer factors with kernel(x, y) == columnFactor[y] * rowFactor[x]
+     * @note Empty when the kernel is not separable
+     */
+    const std::vector<int>& rowFactor() const noexcept { return rowFactor_; }
+    const std::vector<int>& columnFactor() const noexcept { return columnFactor_; }
+
+    /**
+     * @brief Largest |response| reachable from 8-bit input
+     */
+    int32_t worstCaseResponse() const noexcept { return worstCase_; }
+
+    /**
+     * @brief Halo (in pixels) the row API needs on every side
+     */
+    std::size_t halo() const noexcept;
+
+    /**
+     * @brief Number of int32 scratch elements convolveRow needs for `width`
+     */
+    std::size_t scratchSize(std::size_t width) const noexcept;
+
+    /**
+     * @brief Convolve one output row of a haloed 8-bit buffer
+     * @param level Instruction set to use
+     * @param src Pointer to the first pixel of the row (halo() pixels available around it)
+     * @param stride Row stride in bytes
+     * @param width Number of output pixels
+     * @param output Output row (width + kRowSlack entries)
+     * @param scratch Scratch buffer of scratchSize(width) entries
+     */
+    void convolveRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride,
+                     std::size_t width, int32_t* output, int32_t* scratch) const;
+
+    /**
+     * @brief Convolve a whole image
+     * @param image Input grayscale image
+     * @param border Border handling mode
+     * @param level Instruction set to use
+     * @return Row-major int32 responses (width * height)
+     */
+    std::vector<int32_t> convolve(const GrayscaleImage& image, BorderMode border,
+                                  SimdLevel level) const;
+
+private:
+    struct Tap {
+        int dx;      // column offset relative to the output pixel
+        int dy;      // row offset relative to the output pixel
+        int weight;
+    };
+
+    ConvolutionKernel kernel_;
+    bool separable_ = false;
+    std::vector<int> rowFactor_;
+    std::vector<int> columnFactor_;
+    std::vector<Tap> taps_;
+    int32_t worstCase_ = 0;
+    ConvolutionPath path_ = ConvolutionPath::DenseInt32;
+
+    void analyse();
+
+    void separableRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride,
+                      std::size_t width, int32_t* output, int32_t* scratch) const;
+    void denseRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride,
+                  std::size_t width, int32_t* output) const;
+};
+
+/**
+ * @brief Fill the halo around an image stored inside a larger buffer
+ * @param origin Pointer to pixel (0, 0); `halo` pixels must exist on every side
+ * @param stride Row stride in bytes
+ * @param width Image width
+ * @param height Image height
+ * @param halo Border width in pixels
+ * @param border Border handling mode
+ */
+void fillBorder(uint8_t* origin, std::size_t stride, std::size_t width, std::size_t height,
+                std::size_t halo, BorderMode border);
+
+/**
+ * @brief fillBorder() for 16-bit samples; `stride` is in elements
+ */
+void fillBorder(uint16_t* origin, std::size_t stride, std::size_t width, std::size_t height,
+                std::size_t halo, BorderMode border);
+
+/**
+ * @brief Copy an image into a buffer with `halo` border pixels on every side
+ * @param image Source image
+ * @param halo Border width in pixels
+ * @param border Border handling mode
+ * @param stride Receives the row stride of the padded buffer
+ * @return Padded buffer (with vector over-read slack); origin at halo * stride + halo
+ */
+std::vector<uint8_t> makePaddedImage(const GrayscaleImage& image, std::size_t halo,
+                                     BorderMode border, std::size_t& stride);
+
+} // namespace sobel
@@ -0,0 +1,93 @@
+/**
+ * @file gray_frame.hpp
+ * @brief Aligned, haloed 8- or 16-bit gray plane in the layout the SIMD Sobel filter reads
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "convolution_engine.hpp"
+#include "smoothed_gradient.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace sobel {
+
+/**
+ * @brief Gray plane with a border halo, ready for the gradient kernels
+ *
+ * Pixel (0, 0) sits kHalo rows and columns into a 32-byte aligned buffer;
+ * the row stride (halo included, in samples) spans a multiple of 32 bytes
+ * and the buffer carries slack for vector loads past the last halo row.
+ * Producers write rows through row(); the halo is filled by fillBorder(),
+ * which SobelFilterSIMD calls itself with its configured border mode.
+ *
+ * resize() keeps the allocation whenever it is large enough, so a frame
+ * reused for a stream of images allocates once. Instantiated for 8-bit
+ * (GrayFrame) and 16-bit (GrayFrame16) samples.
+ *
+ * @tparam T Sample type (uint8_t or uint16_t)
+ */
+template<typename T>
+class BasicGrayFrame {
+public:
+    using sample_type = T;
+
+    /// Halo of the largest supported kernel (7x7) widened by the largest pre-smoothing radius
+    static constexpr std::size_t kHalo = static_cast<std::size_t>(SobelEngine<7>::radius + kMaxPreSmoothingRadius);
+
+    BasicGrayFrame() = default;
+
+    /**
+     * @throws std::invalid_argument if width or height is 0
+     */
+    BasicGrayFrame(std::size_t width, std::size_t height);
+
+    BasicGrayFrame(BasicGrayFrame&&) noexcept = default;
+    BasicGrayFrame& operator=(BasicGrayFrame&&) noexcept = default;
+    BasicGrayFrame(const BasicGrayFrame&) = delete;
+    BasicGrayFrame& operator=(const BasicGrayFrame&) = delete;
+
+    /**
+     * @brief Set the dimensions (contents are unspecified afterwards)
+     * @throws std::invalid_argument if width or height is 0
+     */
+    void resize(std::size_t width, std::size_t height);
+
+    std::size_t width() const noexcept { return width_; }
+    std::size_t height() const noexcept { return height_; }
+    std::size_t stride() const noexcept { return stride_; }
+    bool empty() const noexcept { return width_ == 0; }
+
+    T* origin() noexcept { return buffer_.get() + kHalo * stride_ + kHalo; }
+    const T* origin() const noexcept { return buffer_.get() + kHalo * stride_ + kHalo; }
+    T* row(std::size_t y) noexcept { return origin() + y * stride_; }
+    const T* row(std::size_t y) const noexcept { return origin() + y * stride_; }
+
+    /**
+     * @brief Fill the halo from the image edge per `border`
+     */
+    void fillBorder(BorderMode border);
+
+private:
+    struct AlignedDelete {
+        void operator()(T* p) const noexcept;
+    };
+
+    std::unique_ptr<T[], AlignedDelete> buffer_;
+    std::size_t capacity_ = 0;       // Bytes
+    std::size_t width_ = 0;
+    std::size_t height_ = 0;
+    std::size_t stride_ = 0;         // Samples
+};
+
+using GrayFrame = BasicGrayFrame<uint8_t>;
+using GrayFrame16 = BasicGrayFrame<uint16_t>;
+
+extern template class BasicGrayFrame<uint8_t>;
+extern template class BasicGrayFrame<uint16_t>;
+
+} // namespace sobel
@@ -31,6 +31,22 @@ struct RGBPixel {
     uint8_t toGrayscale() const;
 };
 
+/**
+ * @brief RGB pixel with 16-bit components (10/12/16-bit sensors, stored LSB-aligned)
+ */
+struct RGBPixel16 {
+    uint16_t r, g, b;
+    
+    RGBPixel16() : r(0), g(0), b(0) {}
+    RGBPixel16(uint16_t red, uint16_t green, uint16_t blue) : r(red), g(green), b(blue) {}
+    
+    /**
+     * @brief Convert RGB to grayscale using ITU-R BT.709 standard
+     * @return Grayscale value in range [0, 65535]
+     */
+    uint16_t toGrayscale() const;
+};
+
 /**
  * @brief Generic image class template for different pixel types
  * @tparam PixelType Type of pixel (RGBPixel, uint8_t, etc.)
@@ -123,5 +139,7 @@ public:
 // Type aliases for common image types
 using RGBImage = Image<RGBPixel>;
 using GrayscaleImage = Image<uint8_t>;
+using RGBImage16 = Image<RGBPixel16>;
+using GrayscaleImage16 = Image<uint16_t>;
 
 } // namespace sobel
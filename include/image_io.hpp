@@ -1,6 +1,6 @@
 /**
  * @file image_io.hpp
- * @brief Image I/O operations for raw binary files
+ * @brief Image I/O for headerless RAW, PPM/PGM and BMP files
  * @author BK Park
  * @version 1.0.0
  * @date 2025-08-27
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "image.hpp"
+#include "gray_frame.hpp"
 #include <string>
 #include <optional>
 
@@ -22,7 +23,19 @@ enum class ImageIOError {
     InvalidFileSize,
     ReadError,
     WriteError,
-    InvalidDimensions
+    InvalidDimensions,
+    InvalidHeader,
+    UnsupportedFormat
+};
+
+/**
+ * @brief On-disk image formats
+ */
+enum class ImageFormat {
+    Raw,    // Headerless pixel bytes; dimensions supplied by the caller
+    PPM,    // Binary PPM (P6), 8-bit RGB
+    PGM,    // Binary PGM (P5), 8-bit gray
+    BMP     // Uncompressed BMP, 24-bit BGR or 8-bit palettized
 };
 
 /**
@@ -48,7 +61,11 @@ struct Result {
 };
 
 /**
- * @brief Image I/O utility class for raw binary files
+ * @brief Image I/O utility class
+ *
+ * Header-aware loaders take the dimensions from the file and read the pixel
+ * data with one bulk read straight into the image (BMP row padding,
+ * bottom-up row order and BGR order are undone in memory afterwards).
  */
 class ImageIO {
 public:
@@ -61,6 +78,68 @@ public:
      */
     static Result<RGBImage> 
     loadRGBImage(const std::string& filepath, std::size_t width, std::size_t height);
+
+    /**
+     * @brief Load an RGB image from a PPM, PGM or BMP file (gray sources are replicated to RGB)
+     * @param filepath Path to input file
+     * @return Result containing RGBImage or error
+     */
+    static Result<RGBImage> loadRGBImage(const std::string& filepath);
+
+    /**
+     * @brief Load a grayscale image from a raw 8-bit file
+     * @param filepath Path to input file
+     * @param width Expected image width
+     * @param height Expected image height
+     * @return Result containing GrayscaleImage or error
+     */
+    static Result<GrayscaleImage>
+    loadGrayscaleImage(const std::string& filepath, std::size_t width, std::size_t height);
+
+    /**
+     * @brief Load a grayscale image from a PGM, PPM or BMP file (color rows convert like loadGrayFrame)
+     * @param filepath Path to input file
+     * @return Result containing GrayscaleImage or error
+     */
+    static Result<GrayscaleImage> loadGrayscaleImage(const std::string& filepath);
+
+    /**
+     * @brief Stream a PPM, PGM or BMP file straight into a filter-ready gray plane
+     *
+     * Rows are read in chunks of a few hundred KiB and converted on the fly
+     * (RGB and BGR with the SIMD packedToGrayRow, bit-exact with RGBPixel::toGrayscale),
+     * so no RGB image is ever built. The frame is resized, reusing its
+     * allocation, and can be passed to SobelFilterSIMD::apply directly.
+     * @param filepath Path to input file
+     * @param frame Destination plane
+     * @return Result containing success or error
+     */
+    static Result<bool> loadGrayFrame(const std::string& filepath, GrayFrame& frame);
+
+    /**
+     * @brief Stream a raw RGB file of the given size into a filter-ready gray plane
+     * @param filepath Path to input file
+     * @param width Expected image width
+     * @param height Expected image height
+     * @param frame Destination plane
+     * @return Result containing success or error
+     */
+    static Result<bool> loadGrayFrame(const std::string& filepath, std::size_t width, std::size_t height,
+                                      GrayFrame& frame);
+
+    /**
+     * @brief Format of a file from its leading bytes ("P6", "P5", "BM"); Raw for anything else
+     * @param filepath Path to file
+     * @return Detected format (Raw also for missing files)
+     */
+    static ImageFormat detectFormat(const std::string& filepath);
+
+    /**
+     * @brief Format implied by a file extension (.ppm, .pgm, .bmp; anything else is Raw)
+     * @param filepath Path to file
+     * @return Format for the extension
+     */
+    static ImageFormat formatFromExtension(const std::string& filepath);
     
     /**
      * @brief Save grayscale image to raw binary file
@@ -70,6 +149,26 @@ public:
      */
     static Result<bool> 
     saveGrayscaleImage(const GrayscaleImage& image, const std::string& filepath);
+
+    /**
+     * @brief Save grayscale image in the given format (PGM, 8-bit BMP or raw; PPM replicates gray to RGB)
+     * @param image Grayscale image to save
+     * @param filepath Output file path
+     * @param format Output format
+     * @return Result containing success or error
+     */
+    static Result<bool>
+    saveGrayscaleImage(const GrayscaleImage& image, const std::string& filepath, ImageFormat format);
+
+    /**
+     * @brief Save RGB image in the given format (PPM, 24-bit BMP or raw; PGM stores RGBPixel::toGrayscale)
+     * @param image RGB image to save
+     * @param filepath Output file path
+     * @param format Output format
+     * @return Result containing success or error
+     */
+    static Result<bool>
+    saveRGBImage(const RGBImage& image, const std::string& filepath, ImageFormat format);
     
     /**
      * @brief Validate file size for RGB image
@@ -0,0 +1,99 @@
+/**
+ * @file latency_histogram.hpp
+ * @brief Log-linear (HDR-style) per-frame latency histogram with deadline accounting
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sobel {
+
+/// Frame budget at 60 FPS
+constexpr std::chrono::nanoseconds kDefaultFrameDeadline{16670000};
+
+/**
+ * @brief Tail-latency summary of recorded frames (microseconds)
+ */
+struct LatencySummary {
+    uint64_t frames = 0;
+    uint64_t deadlineMisses = 0;   // Frames slower than the deadline
+    double deadlineUs = 0.0;
+    double minUs = 0.0;
+    double meanUs = 0.0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double p999Us = 0.0;
+    double maxUs = 0.0;
+    double jitterUs = 0.0;         // Mean absolute change between consecutive frames
+};
+
+/**
+ * @brief Latency histogram with bounded relative error and O(1) recording
+ *
+ * Values below 2^kSubBucketBits ns get their own bucket; above that, every
+ * power of two is split into 2^kSubBucketBits linear sub-buckets, so a
+ * reported percentile is within 1/128 (0.8%) of the true value. Buckets are
+ * allocated once at construction: record() never allocates, which keeps the
+ * measurement out of the latencies it measures. Values beyond ~4.9 hours
+ * land in the last bucket; min/max/mean are exact.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr int kMaxValueBits = 44;
+
+    explicit LatencyHistogram(std::chrono::nanoseconds deadline = kDefaultFrameDeadline);
+
+    /**
+     * @brief Add one frame latency in nanoseconds
+     */
+    void record(uint64_t ns) noexcept;
+    void record(std::chrono::nanoseconds latency) noexcept {
+        record(static_cast<uint64_t>(latency.count() > 0 ? latency.count() : 0));
+    }
+
+    void reset() noexcept;
+
+    /**
+     * @brief Frames slower than `deadline` count as misses from now on (existing counts are kept)
+     */
+    void setDeadline(std::chrono::nanoseconds deadline) noexcept { deadline_ = deadline; }
+    std::chrono::nanoseconds deadline() const noexcept { return deadline_; }
+
+    uint64_t count() const noexcept { return count_; }
+    uint64_t deadlineMisses() const noexcept { return deadlineMisses_; }
+    uint64_t min() const noexcept { return count_ ? min_ : 0; }
+    uint64_t max() const noexcept { return max_; }
+    double mean() const noexcept;
+    double jitter() const noexcept;
+
+    /**
+     * @brief Value at percentile `p` in [0, 100] (highest value equivalent to its bucket, clamped to [min, max])
+     */
+    uint64_t percentile(double p) const noexcept;
+
+    LatencySummary summary() const;
+
+private:
+    static std::size_t bucketIndex(uint64_t ns) noexcept;
+    static uint64_t bucketUpperBound(std::size_t index) noexcept;
+
+    std::vector<uint64_t> buckets_;
+    std::chrono::nanoseconds deadline_;
+    uint64_t count_ = 0;
+    uint64_t deadlineMisses_ = 0;
+    uint64_t min_ = 0;
+    uint64_t max_ = 0;
+    uint64_t last_ = 0;
+    double total_ = 0.0;
+    double totalDelta_ = 0.0;
+};
+
+} // namespace sobel
@@ -0,0 +1,50 @@
+/**
+ * @file packed_image.hpp
+ * @brief Non-owning views of interleaved 8-bit color frames in RGB, BGR, RGBA or BGRA order
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sobel {
+
+/**
+ * @brief Byte order of an interleaved color pixel; alpha is never read
+ */
+enum class PixelFormat {
+    RGB,     // r, g, b (the layout of RGBPixel)
+    BGR,     // b, g, r (BMP, OpenCV)
+    RGBA,    // r, g, b, a
+    BGRA     // b, g, r, a (most compositors)
+};
+
+constexpr std::size_t pixelFormatBytes(PixelFormat format) {
+    return format == PixelFormat::RGBA || format == PixelFormat::BGRA ? 4 : 3;
+}
+
+/// Byte offset of red within a pixel (blue sits at 2 minus this, green at 1)
+constexpr std::size_t pixelFormatRedOffset(PixelFormat format) {
+    return format == PixelFormat::BGR || format == PixelFormat::BGRA ? 2 : 0;
+}
+
+/**
+ * @brief View of a caller-owned interleaved color frame
+ */
+struct PackedImageView {
+    PixelFormat format = PixelFormat::RGB;
+    const uint8_t* data = nullptr;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t stride = 0;     // Bytes per row (0 = packed rows, see rowBytes())
+
+    bool empty() const noexcept { return width == 0 || height == 0; }
+    std::size_t rowBytes() const noexcept { return width * pixelFormatBytes(format); }
+    std::size_t resolvedStride() const noexcept { return stride ? stride : rowBytes(); }
+};
+
+} // namespace sobel
@@ -0,0 +1,156 @@
+/**
+ * @file parallel_for.hpp
+ * @brief Fork-join loops with dynamic work distribution, one-shot or on a persistent pool
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace sobel {
+
+/**
+ * @brief Worker count for a request of `threads` (0 = hardware concurrency)
+ */
+inline unsigned resolveThreadCount(unsigned threads) {
+    return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace detail {
+
+/**
+ * @brief One fork-join loop: items handed out dynamically, first exception kept for the caller
+ */
+template<typename Work>
+class ForkJoinLoop {
+public:
+    ForkJoinLoop(std::size_t count, Work& work) : count_(count), work_(work) {}
+
+    // Run items on `worker` until none are left; a throwing item stops the others
+    void run(unsigned worker) noexcept {
+        try {
+            for (std::size_t i = next_++; i < count_; i = next_++) work_(worker, i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failureMutex_);
+            if (!failure_) failure_ = std::current_exception();
+            next_ = count_;
+        }
+    }
+
+    void rethrow() const {
+        if (failure_) std::rethrow_exception(failure_);
+    }
+
+private:
+    const std::size_t count_;
+    Work& work_;
+    std::atomic<std::size_t> next_{0};
+    std::exception_ptr failure_;
+    std::mutex failureMutex_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Run work(worker, item) for every item in [0, count)
+ *
+ * Items are handed out dynamically to min(threads, count) workers; worker 0
+ * is the calling thread, so a single worker never spawns a thread. The first
+ * exception thrown by any worker is rethrown on the calling thread.
+ */
+template<typename Work>
+void parallelFor(std::size_t count, unsigned threads, Work&& work) {
+    const unsigned workers = static_cast<unsigned>(std::min<std::size_t>(resolveThreadCount(threads), count));
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; ++i) work(0u, i);
+        return;
+    }
+
+    detail::ForkJoinLoop<std::remove_reference_t<Work>> loop(count, work);
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned t = 1; t < workers; ++t) pool.emplace_back([&loop, t] { loop.run(t); });
+    loop.run(0);
+    for (auto& thread : pool) thread.join();
+    loop.rethrow();
+}
+
+/**
+ * @brief Helper threads kept alive between fork-join loops
+ *
+ * For per-frame work, where starting and joining threads on every loop
+ * would cost more than a band of rows. The calling thread is worker 0 and
+ * the helpers are workers 1..size()-1, so worker indices stay the same from
+ * loop to loop. Dispatching a loop does not allocate. Only one thread may
+ * run loops on a pool at a time.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threads Workers including the caller (0 = hardware concurrency)
+     */
+    explicit ThreadPool(unsigned threads = 1) { resize(threads); }
+    ~ThreadPool() { stopHelpers(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Change the worker count; helpers are only restarted when it changes
+     */
+    void resize(unsigned threads);
+    unsigned size() const noexcept { return static_cast<unsigned>(helpers_.size()) + 1; }
+
+    /**
+     * @brief Run work(worker, item) for every item in [0, count), like sobel::parallelFor
+     */
+    template<typename Work>
+    void parallelFor(std::size_t count, Work&& work);
+
+private:
+    using Task = void (*)(void* context, unsigned worker);
+
+    // Run task(context, worker) on workers 0..workers-1 and wait for all of them
+    void dispatch(Task task, void* context, unsigned workers);
+    void helperLoop(unsigned worker, uint64_t generation);
+    void stopHelpers();
+
+    std::vector<std::thread> helpers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Task task_ = nullptr;
+    void* context_ = nullptr;
+    unsigned active_ = 0;        // Workers of the current loop, caller included
+    unsigned pending_ = 0;       // Helpers still running the current loop
+    uint64_t generation_ = 0;    // Bumped for every loop
+    bool stopping_ = false;
+};
+
+template<typename Work>
+void ThreadPool::parallelFor(std::size_t count, Work&& work) {
+    const unsigned workers = static_cast<unsigned>(std::min<std::size_t>(size(), count));
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; ++i) work(0u, i);
+        return;
+    }
+
+    using Loop = detail::ForkJoinLoop<std::remove_reference_t<Work>>;
+    Loop loop(count, work);
+    dispatch([](void* context, unsigned worker) { static_cast<Loop*>(context)->run(worker); }, &loop, workers);
+    loop.rethrow();
+}
+
+} // namespace sobel
@@ -0,0 +1,87 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Hardware performance counters via Linux perf_event_open
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sobel {
+
+/**
+ * @brief Counted hardware events
+ */
+enum class PerfEvent : std::size_t {
+    Cycles,
+    Instructions,
+    L1DMisses,      // L1 data cache read misses
+    LLCMisses,      // Last-level cache misses
+    BranchMisses,
+    Count
+};
+
+constexpr std::size_t kPerfEventCount = static_cast<std::size_t>(PerfEvent::Count);
+
+/**
+ * @brief Printable event name
+ */
+const char* perfEventName(PerfEvent event);
+
+/**
+ * @brief Counter values of one measurement (scaled for multiplexing)
+ */
+struct PerfSample {
+    std::array<double, kPerfEventCount> values{};
+    std::array<bool, kPerfEventCount> valid{};
+
+    bool has(PerfEvent event) const { return valid[static_cast<std::size_t>(event)]; }
+    double operator[](PerfEvent event) const { return values[static_cast<std::size_t>(event)]; }
+
+    double ipc() const {
+        return has(PerfEvent::Cycles) && has(PerfEvent::Instructions) && (*this)[PerfEvent::Cycles] > 0.0
+                   ? (*this)[PerfEvent::Instructions] / (*this)[PerfEvent::Cycles] : 0.0;
+    }
+};
+
+/**
+ * @brief Per-thread counters for the calling thread (user space only)
+ *
+ * Each event is opened on its own, so a VM or kernel that refuses one event
+ * (commonly the cache events) still reports the others. When nothing can be
+ * opened, available() is false and unavailableReason() says why.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const noexcept { return opened_ > 0; }
+    const std::string& unavailableReason() const noexcept { return reason_; }
+
+    /**
+     * @brief Reset and start all opened counters
+     */
+    void start();
+
+    /**
+     * @brief Stop counting and read the values since start()
+     */
+    PerfSample stop();
+
+private:
+    std::array<int, kPerfEventCount> fds_;
+    std::size_t opened_ = 0;
+    std::string reason_;
+};
+
+} // namespace sobel
@@ -0,0 +1,61 @@
+/**
+ * @file region.hpp
+ * @brief Rectangular regions of interest for partial-frame edge detection
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sobel {
+
+/**
+ * @brief Axis-aligned rectangle in pixels (x, y is the top-left corner)
+ */
+struct RegionOfInterest {
+    std::size_t x = 0;
+    std::size_t y = 0;
+    std::size_t width = 0;
+    std::size_t height = 0;
+
+    bool empty() const noexcept { return width == 0 || height == 0; }
+    std::size_t right() const noexcept { return x + width; }      // One past the last column
+    std::size_t bottom() const noexcept { return y + height; }    // One past the last row
+    std::size_t area() const noexcept { return width * height; }
+
+    bool overlaps(const RegionOfInterest& other) const noexcept {
+        return !empty() && !other.empty() && x < other.right() && other.x < right() &&
+               y < other.bottom() && other.y < bottom();
+    }
+};
+
+/**
+ * @brief Range the edge map of several regions is quantized over
+ */
+enum class RegionNormalization {
+    PerRegion,    // Each merged region spans the full output range on its own
+    Union         // One min/max over all regions, as a full-frame edge map would use
+};
+
+/**
+ * @brief Clip regions to a width x height frame and merge overlapping ones
+ *
+ * Regions that share a pixel are replaced by their bounding box, repeatedly,
+ * until no two overlap, so every pixel is filtered at most once. Empty
+ * regions and regions outside the frame are dropped. The result is sorted
+ * top to bottom, then left to right.
+ */
+std::vector<RegionOfInterest> mergeRegions(const std::vector<RegionOfInterest>& regions,
+                                           std::size_t width, std::size_t height);
+
+/**
+ * @brief mergeRegions() into `merged`, reusing its capacity
+ */
+void mergeRegions(const std::vector<RegionOfInterest>& regions, std::size_t width, std::size_t height,
+                  std::vector<RegionOfInterest>& merged);
+
+} // namespace sobel
@@ -0,0 +1,96 @@
+/**
+ * @file smoothed_gradient.hpp
+ * @brief Sobel gradients with a Gaussian pre-smoothing folded into the separable passes
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "sobel_engine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sobel {
+
+/// Largest Gaussian radius the fused kernels accept (frames carry a halo for it)
+constexpr int kMaxPreSmoothingRadius = 5;
+
+/**
+ * @brief Gaussian blur applied ahead of the gradient
+ */
+struct PreSmoothingConfig {
+    float sigma = 0.0f;     // Standard deviation in pixels (0 = off)
+    int radius = 0;         // Taps each side of the center (0 = ceil(3 sigma), capped at kMaxPreSmoothingRadius)
+
+    bool enabled() const noexcept { return sigma > 0.0f; }
+};
+
+/**
+ * @brief Gradient rows of a Gaussian-smoothed image without a separate blur pass
+ *
+ * Blurring with a Gaussian g and then applying the Sobel pair (smoothing s,
+ * derivative d) equals one separable pass with taps g*s and g*d, so the
+ * blur only widens the kernels that already read the source rows. The
+ * Gaussian is normalized, so gradients keep the scale of the plain Sobel
+ * kernel. Passes accumulate in float tap by tap in the same order on every
+ * level and round to int32 at the end, so all levels agree exactly.
+ */
+class SmoothedGradientEngine {
+public:
+    SmoothedGradientEngine() = default;
+
+    /**
+     * @param kernelSize Sobel size (3, 5 or 7)
+     * @param smoothing Enabled Gaussian settings
+     * @throws std::invalid_argument for another kernel size, a sigma that is not positive and
+     *         finite, or a radius outside [0, kMaxPreSmoothingRadius]
+     */
+    SmoothedGradientEngine(int kernelSize, const PreSmoothingConfig& smoothing);
+
+    /// Sobel radius plus Gaussian radius: the halo the source must provide
+    int radius() const noexcept { return radius_; }
+    const std::vector<float>& smoothingTaps() const noexcept { return smoothing_; }
+    const std::vector<float>& derivativeTaps() const noexcept { return derivative_; }
+
+    /**
+     * @brief Number of float scratch elements needed for a row of `width`
+     */
+    std::size_t scratchSize(std::size_t width) const {
+        return 2 * (width + 2 * static_cast<std::size_t>(radius_) + kRowSlack);
+    }
+
+    /**
+     * @brief Compute Gx and Gy for one output row
+     * @param level Instruction set to use
+     * @param src Pointer to the first pixel of the row inside a buffer with a halo of radius()
+     * @param stride Row stride of the source buffer in samples
+     * @param width Number of output pixels
+     * @param gx X gradients (width + kRowSlack entries)
+     * @param gy Y gradients (width + kRowSlack entries)
+     * @param scratch Scratch buffer of scratchSize(width) entries
+     */
+    void gradientRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride, std::size_t width,
+                     int32_t* gx, int32_t* gy, float* scratch) const;
+    void gradientRow(SimdLevel level, const uint16_t* src, std::ptrdiff_t stride, std::size_t width,
+                     int32_t* gx, int32_t* gy, float* scratch) const;
+
+private:
+    int radius_ = 0;
+    std::vector<float> smoothing_;      // 2 * radius_ + 1 symmetric taps
+    std::vector<float> derivative_;     // 2 * radius_ + 1 antisymmetric taps
+
+    template<typename T>
+    void gradientRowScalar(const T* src, std::ptrdiff_t stride, std::size_t width,
+                           int32_t* gx, int32_t* gy, float* scratch) const;
+    template<typename T>
+    void gradientRowSSE(const T* src, std::ptrdiff_t stride, std::size_t width,
+                        int32_t* gx, int32_t* gy, float* scratch) const;
+    template<typename T>
+    void gradientRowAVX2(const T* src, std::ptrdiff_t stride, std::size_t width,
+                         int32_t* gx, int32_t* gy, float* scratch) const;
+};
+
+} // namespace sobel
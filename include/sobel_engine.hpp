@@ -0,0 +1,261 @@
+/**
+ * @file sobel_engine.hpp
+ * @brief Separable NxN Sobel gradient engine with scalar, SSE and AVX2 paths
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "sobel_kernels.hpp"
+#include "packed_image.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace sobel {
+
+/**
+ * @brief Instruction set used by the row kernels
+ */
+enum class SimdLevel {
+    Scalar,
+    SSE,
+    AVX2
+};
+
+/**
+ * @brief How per-channel gradients of a color image become one edge magnitude
+ */
+enum class ColorGradientMode {
+    Luma,           // Convert to gray first (one gradient pass)
+    MaxMagnitude,   // Largest channel magnitude
+    SumOfSquares,   // sqrt of the summed squared channel gradients
+    DiZenzo         // sqrt of the largest eigenvalue of the summed structure tensor
+};
+
+/**
+ * @brief Extra elements every row buffer handed to the engine must provide
+ *
+ * Vector loops run over whole registers, so gradient rows and scratch rows
+ * are written up to this many elements past their logical width.
+ */
+constexpr std::size_t kRowSlack = 32;
+
+/**
+ * @brief Separable NxN Sobel engine working on one output row at a time
+ *
+ * The source is an 8-bit buffer that already carries a halo of at least
+ * `radius` pixels on every side, so the kernels never branch on borders.
+ * A 16-bit overload keeps both passes in int32 for 10/12/16-bit data.
+ * Explicit instantiations exist for N = 3, 5 and 7.
+ *
+ * @tparam N Odd kernel size
+ */
+template<int N>
+class SobelEngine {
+public:
+    using Coefficients = SobelCoefficients<N>;
+    static constexpr int size = N;
+    static constexpr int radius = N / 2;
+
+    // The vertical pass accumulates smoothed pixels in int16
+    static_assert(255 * Coefficients::smoothingSum() <= 32767,
+                  "Vertical smoothing would overflow int16 accumulation");
+    // The 16-bit path accumulates both passes in int32
+    static_assert(int64_t(65535) * Coefficients::smoothingSum() * Coefficients::derivativeGain() <= INT32_MAX,
+                  "16-bit gradients would overflow int32 accumulation");
+
+    /**
+     * @brief Number of int16 scratch elements needed for a row of `width`
+     */
+    static std::size_t scratchSize(std::size_t width) {
+        return 2 * (width + 2 * radius + kRowSlack);
+    }
+
+    /**
+     * @brief Compute Gx and Gy for one output row
+     * @param level Instruction set to use
+     * @param src Pointer to the first pixel of the row inside a haloed buffer
+     * @param stride Row stride of the source buffer in bytes
+     * @param width Number of output pixels
+     * @param gx X gradients (width + kRowSlack entries)
+     * @param gy Y gradients (width + kRowSlack entries)
+     * @param scratch Scratch buffer of scratchSize(width) entries
+     */
+    static void gradientRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride,
+                            std::size_t width, int32_t* gx, int32_t* gy, int16_t* scratch);
+
+    /**
+     * @brief Compute Gx and Gy for one row of 16-bit samples
+     *
+     * Same contract as the 8-bit overload with `stride` in samples and an
+     * int32 scratch of scratchSize(width) entries; the result is exact for
+     * the full 16-bit range.
+     */
+    static void gradientRow(SimdLevel level, const uint16_t* src, std::ptrdiff_t stride,
+                            std::size_t width, int32_t* gx, int32_t* gy, int32_t* scratch);
+
+private:
+    static void gradientRowScalar(const uint8_t* src, std::ptrdiff_t stride, std::size_t width,
+                                  int32_t* gx, int32_t* gy, int16_t* scratch);
+    static void gradientRowSSE(const uint8_t* src, std::ptrdiff_t stride, std::size_t width,
+                               int32_t* gx, int32_t* gy, int16_t* scratch);
+    static void gradientRowAVX2(const uint8_t* src, std::ptrdiff_t stride, std::size_t width,
+                                int32_t* gx, int32_t* gy, int16_t* scratch);
+    static void gradientRowScalar(const uint16_t* src, std::ptrdiff_t stride, std::size_t width,
+                                  int32_t* gx, int32_t* gy, int32_t* scratch);
+    static void gradientRowSSE(const uint16_t* src, std::ptrdiff_t stride, std::size_t width,
+                               int32_t* gx, int32_t* gy, int32_t* scratch);
+    static void gradientRowAVX2(const uint16_t* src, std::ptrdiff_t stride, std::size_t width,
+                                int32_t* gx, int32_t* gy, int32_t* scratch);
+};
+
+/**
+ * @brief Compute sqrt(gx^2 + gy^2) for one row and update the running range
+ * @param level Instruction set to use
+ * @param gx X gradients
+ * @param gy Y gradients
+ * @param width Number of pixels
+ * @param magnitude Output magnitudes (width entries)
+ * @param minValue Running minimum, updated in place
+ * @param maxValue Running maximum, updated in place
+ */
+void magnitudeRow(SimdLevel level, const int32_t* gx, const int32_t* gy, std::size_t width,
+                  float* magnitude, float& minValue, float& maxValue);
+
+/**
+ * @brief Convert interleaved color bytes to gray, bit-exact with RGBPixel::toGrayscale()
+ *
+ * Channels are gathered per format with byte shuffles, then the vector paths
+ * evaluate the BT.709 sum in double in the scalar order (the build disables
+ * FMA contraction) and round half away from zero, so every level and every
+ * format produces the same bytes for the same colors.
+ * @param level Instruction set to use
+ * @param format Channel order of `pixels`
+ * @param pixels pixelFormatBytes(format) * width bytes
+ * @param width Number of pixels
+ * @param gray Output bytes
+ */
+void packedToGrayRow(SimdLevel level, PixelFormat format, const uint8_t* pixels, std::size_t width, uint8_t* gray);
+
+/**
+ * @brief packedToGrayRow() for PixelFormat::RGB
+ */
+void rgbToGrayRow(SimdLevel level, const uint8_t* rgb, std::size_t width, uint8_t* gray);
+
+/**
+ * @brief Convert packed 16-bit r, g, b samples to gray, bit-exact with RGBPixel16::toGrayscale()
+ * @param level Instruction set to use
+ * @param rgb 3 * width samples
+ * @param width Number of pixels
+ * @param gray Output samples
+ */
+void rgb16ToGrayRow(SimdLevel level, const uint16_t* rgb, std::size_t width, uint16_t* gray);
+
+/**
+ * @brief Split interleaved color pixels into three channel rows (r, g, b order)
+ * @param level Instruction set to use
+ * @param format Channel order of `pixels`
+ * @param pixels pixelFormatBytes(format) * width bytes
+ * @param width Number of pixels
+ * @param channels Output rows for red, green and blue
+ */
+void deinterleaveRow(SimdLevel level, PixelFormat format, const uint8_t* pixels, std::size_t width,
+                     uint8_t* const channels[3]);
+
+/**
+ * @brief Combine the gradients of three channels into one magnitude row and update the running min/max
+ *
+ * Evaluated in float in the same order on every level (no FMA contraction),
+ * so all levels give identical magnitudes.
+ * @param level Instruction set to use
+ * @param mode Combination; ColorGradientMode::Luma is not valid here
+ * @param gx X gradients per channel
+ * @param gy Y gradients per channel
+ * @param width Number of pixels
+ * @param magnitude Output magnitudes
+ * @param minValue Running minimum, updated in place
+ * @param maxValue Running maximum, updated in place
+ */
+void colorMagnitudeRow(SimdLevel level, ColorGradientMode mode, const int32_t* const gx[3],
+                       const int32_t* const gy[3], std::size_t width, float* magnitude,
+                       float& minValue, float& maxValue);
+
+/**
+ * @brief Gx/Gy of the channel with the largest gx^2 + gy^2 (first channel on ties)
+ */
+void dominantGradientRow(SimdLevel level, const int32_t* const gx[3], const int32_t* const gy[3],
+                         std::size_t width, int32_t* gxOut, int32_t* gyOut);
+
+/**
+ * @brief Compute |gx| + |gy| for one row and update the running min/max
+ *
+ * Cheaper stand-in for magnitudeRow(); exact in every path since the sums
+ * stay far below 2^24.
+ */
+void magnitudeL1Row(SimdLevel level, const int32_t* gx, const int32_t* gy, std::size_t width,
+                    float* magnitude, float& minValue, float& maxValue);
+
+/**
+ * @brief Map magnitudes to bytes as clamp((m - offset) * scale, 0, 255), truncated
+ * @param level Instruction set to use
+ * @param magnitude Input magnitudes
+ * @param count Number of values
+ * @param offset Value subtracted before scaling
+ * @param scale Scale factor
+ * @param output Output bytes
+ */
+void quantizeMagnitudes(SimdLevel level, const float* magnitude, std::size_t count,
+                        float offset, float scale, uint8_t* output);
+
+/**
+ * @brief Narrow int32 values to int16 with saturation
+ * @param level Instruction set to use
+ * @param input Input values
+ * @param count Number of values
+ * @param output Output values (exactly count entries are written)
+ */
+void narrowToInt16(SimdLevel level, const int32_t* input, std::size_t count, int16_t* output);
+
+/**
+ * @brief Nearest-neighbour 2x horizontal upsampling: dst[x] = src[x / 2]
+ * @param level Instruction set to use
+ * @param src Source row of (width + 1) / 2 bytes
+ * @param width Number of output bytes
+ * @param dst Output row
+ */
+void upsampleRow2x(SimdLevel level, const uint8_t* src, std::size_t width, uint8_t* dst);
+
+/**
+ * @brief 2x2 box decimation of two rows: dst[x] = rounded mean of top/bottom[2x, 2x + 1]
+ *
+ * An odd last column is paired with itself. Exact (integer) on every level.
+ * @param level Instruction set to use
+ * @param top Upper source row of `width` bytes
+ * @param bottom Lower source row (pass `top` again for an odd last row)
+ * @param width Number of source bytes; (width + 1) / 2 bytes are written
+ * @param dst Output row
+ */
+void downsampleRow2x(SimdLevel level, const uint8_t* top, const uint8_t* bottom, std::size_t width, uint8_t* dst);
+
+/**
+ * @brief Luma of a packed YUYV (Y0 U Y1 V) row: gray[x] = yuyv[2 * x]
+ * @param level Instruction set to use
+ * @param yuyv Packed row of at least 2 * width bytes
+ * @param width Number of pixels
+ * @param gray Output bytes
+ */
+void yuyvToGrayRow(SimdLevel level, const uint8_t* yuyv, std::size_t width, uint8_t* gray);
+
+/**
+ * @brief Whether the running binary was compiled with the given instruction set
+ */
+bool isSimdLevelCompiled(SimdLevel level);
+
+/**
+ * @brief Best instruction set that is both compiled in and supported by the CPU
+ */
+SimdLevel detectSimdLevel();
+
+} // namespace sobel
@@ -1,6 +1,6 @@
 /**
  * @file sobel_filter.hpp
- * @brief 5x5 Sobel edge detection filter implementation
+ * @brief Sobel edge detection filter implementation (3x3, 5x5 or 7x7)
  * @author BK Park
  * @version 1.0.0
  * @date 2025-08-27
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "image.hpp"
+#include "sobel_kernels.hpp"
+#include "convolution_engine.hpp"
 #include <array>
 #include <cstdint>
 
@@ -17,7 +19,7 @@ namespace sobel {
 /**
  * @brief 5x5 Sobel kernel type
  */
-using SobelKernel5x5 = std::array<std::array<int, 5>, 5>;
+using SobelKernel5x5 = SobelKernel<5>;
 
 /**
  * @brief Configuration for Sobel filter processing
@@ -26,6 +28,8 @@ struct SobelConfig {
     bool use_quantization = true;     // Enable quantization
     uint8_t quantization_levels = 64; // Good contrast for edge visualization
     bool normalize_output = true;
+    int kernel_size = 5;              // Odd Sobel size: 3 (sharp), 5 or 7 (noise-robust)
+    BorderMode border_mode = BorderMode::Replicate;
     
     SobelConfig() = default;
     
@@ -38,7 +42,8 @@ struct SobelConfig {
  * 
  * This class implements Sobel edge detection using 5x5 kernels for more accurate
  * edge detection compared to traditional 3x3 kernels. The implementation includes
- * gradient magnitude calculation with optional quantization.
+ * gradient magnitude calculation with optional quantization. Convolution runs
+ * through ConvolutionEngine, so the separable SIMD path is used automatically.
  */
 class SobelFilter {
 public:
@@ -50,6 +55,7 @@ public:
     /**
      * @brief Construct Sobel filter with custom configuration
      * @param config Filter configuration
+     * @throws std::invalid_argument if config.kernel_size is not 3, 5 or 7
      */
     explicit SobelFilter(const SobelConfig& config);
     
@@ -68,20 +74,33 @@ public:
     GrayscaleImage apply(const GrayscaleImage& input) const;
     
     /**
-     * @brief Get X-direction Sobel kernel (5x5)
-     * @return 5x5 Sobel X kernel
+     * @brief Get the 5x5 X-direction Sobel kernel, whatever config.kernel_size is
+     * @return 5x5 Sobel X kernel (use kernelX() for the configured size)
      */
     static const SobelKernel5x5& getKernelX();
     
     /**
-     * @brief Get Y-direction Sobel kernel (5x5)
-     * @return 5x5 Sobel Y kernel
+     * @brief Get the 5x5 Y-direction Sobel kernel, whatever config.kernel_size is
+     * @return 5x5 Sobel Y kernel (use kernelY() for the configured size)
      */
     static const SobelKernel5x5& getKernelY();
     
+    /**
+     * @brief Get the X-direction Sobel kernel this filter applies
+     * @return config.kernel_size x config.kernel_size Sobel X kernel
+     */
+    ConvolutionKernel kernelX() const { return ConvolutionKernel::sobelX(config_.kernel_size); }
+    
+    /**
+     * @brief Get the Y-direction Sobel kernel this filter applies
+     * @return config.kernel_size x config.kernel_size Sobel Y kernel
+     */
+    ConvolutionKernel kernelY() const { return ConvolutionKernel::sobelY(config_.kernel_size); }
+    
     /**
      * @brief Set filter configuration
      * @param config New configuration
+     * @throws std::invalid_argument if config.kernel_size is not 3, 5 or 7
      */
     void setConfig(const SobelConfig& config);
     
@@ -95,13 +114,13 @@ private:
     SobelConfig config_;
     
     /**
-     * @brief Apply convolution with 5x5 kernel
+     * @brief Apply convolution through the shared convolution engine
      * @param image Input grayscale image
-     * @param kernel 5x5 convolution kernel
+     * @param kernel Convolution kernel (any odd size)
      * @return Convolution result as signed values
      */
-    std::vector<int16_t> convolve(const GrayscaleImage& image, 
-                                  const SobelKernel5x5& kernel) const;
+    std::vector<int32_t> convolve(const GrayscaleImage& image, 
+                                  const ConvolutionKernel& kernel) const;
     
     /**
      * @brief Calculate gradient magnitude from X and Y gradients
@@ -111,8 +130,8 @@ private:
      * @param height Image height
      * @return Gradient magnitudes
      */
-    std::vector<double> calculateMagnitude(const std::vector<int16_t>& gx,
-                                          const std::vector<int16_t>& gy,
+    std::vector<double> calculateMagnitude(const std::vector<int32_t>& gx,
+                                          const std::vector<int32_t>& gy,
                                           std::size_t width,
                                           std::size_t height) const;
     
@@ -2,10 +2,25 @@
 
 #include "image.hpp"
 #include "sobel_filter.hpp"
+#include "sobel_engine.hpp"
+#include "canny.hpp"
+#include "stage_timer.hpp"
+#include "latency_histogram.hpp"
+#include "allocation_tracker.hpp"
+#include "autotuner.hpp"
+#include "adaptive_quality.hpp"
+#include "gray_frame.hpp"
+#include "smoothed_gradient.hpp"
+#include "yuv_image.hpp"
+#include "packed_image.hpp"
+#include "region.hpp"
+#include "parallel_for.hpp"
+#include <array>
 #include <chrono>
 #include <string>
 #include <memory>
 #include <cstddef>
+#include <vector>
 
 /**
  * @brief Simple SIMD-optimized Sobel filter for demonstration
@@ -19,8 +34,30 @@ public:
     struct PerformanceMetrics {
         std::chrono::microseconds processingTime{0};
         size_t pixelsPerSecond = 0;
-        size_t memoryBandwidth = 0;
+        size_t memoryBandwidth = 0;   // bytes/s of input (RGB or gray) plus 8-bit output
         std::string optimizationUsed;
+        // Per-stage time per call, aggregated across calls (empty when SOBEL_STAGE_TIMERS=0)
+        std::array<sobel::StageTiming, sobel::kPipelineStageCount> stages{};
+        // Heap activity per stage and per call, aggregated across calls, including allocations on
+        // the pool's helper threads (zero unless the program links sobel_alloc_hooks)
+        sobel::AllocationStages allocations{};
+        sobel::AllocationStats allocationTotal;
+        // Tier of the latest apply() and apply() calls per tier (all Full unless adaptive quality is on)
+        sobel::QualityTier qualityTier = sobel::QualityTier::Full;
+        std::array<uint64_t, sobel::kQualityTierCount> tierFrames{};
+    };
+
+    // Caller-owned destinations for a single gradient pass; null planes are skipped.
+    // Strides are in elements (0 = tightly packed rows of `width`).
+    struct OutputDescriptor {
+        int16_t* gx = nullptr;          // raw X gradient, saturated to int16 (7x7 can exceed it)
+        int16_t* gy = nullptr;          // raw Y gradient, saturated to int16
+        float* magnitude = nullptr;     // sqrt(gx^2 + gy^2) before any normalization
+        uint8_t* edges = nullptr;       // 8-bit edge map, identical to apply(input, output)
+        size_t gxStride = 0;
+        size_t gyStride = 0;
+        size_t magnitudeStride = 0;
+        size_t edgesStride = 0;
     };
 
     explicit SobelFilterSIMD(OptimizationLevel level = OptimizationLevel::AUTO);
@@ -28,40 +65,281 @@ public:
 
     bool apply(const sobel::RGBImage& input, sobel::GrayscaleImage& output, bool enableProfiling = false);
 
+    // Any combination of Gx, Gy, magnitude and edge map from one convolution pass.
+    // Returns false for empty input or when no plane is requested; throws
+    // std::invalid_argument if a stride is smaller than the image width.
+    bool apply(const sobel::RGBImage& input, const OutputDescriptor& outputs, bool enableProfiling = false);
+
+    // Same, from an interleaved RGB, BGR, RGBA or BGRA frame: channels are gathered by the
+    // conversion's own shuffles, so no swizzle pass is needed. Throws std::invalid_argument for
+    // a non-empty view without data or with a stride shorter than one row.
+    bool apply(const sobel::PackedImageView& input, sobel::GrayscaleImage& output, bool enableProfiling = false);
+    bool apply(const sobel::PackedImageView& input, const OutputDescriptor& outputs, bool enableProfiling = false);
+
+    // Same, from a gray plane already in the filter's layout (e.g. sobel::ImageIO::loadGrayFrame),
+    // skipping the RGB stage. The frame's halo is refilled with this filter's border mode.
+    bool apply(sobel::GrayFrame& gray, sobel::GrayscaleImage& output, bool enableProfiling = false);
+    bool apply(sobel::GrayFrame& gray, const OutputDescriptor& outputs, bool enableProfiling = false);
+
+    // Same, from a packed grayscale image (drop-in for SobelFilter::apply(const GrayscaleImage&)).
+    // Rows are copied into the filter's haloed plane; use a GrayFrame to avoid the copy.
+    bool apply(const sobel::GrayscaleImage& input, sobel::GrayscaleImage& output, bool enableProfiling = false);
+    bool apply(const sobel::GrayscaleImage& input, const OutputDescriptor& outputs, bool enableProfiling = false);
+
+    // Same, from camera YUV: the Y samples are the luma, so there is no color conversion at all
+    // (NV12/I420 rows are copied, YUYV rows de-interleaved). Throws std::invalid_argument for a
+    // non-empty view without a luma pointer or with a stride shorter than one row.
+    bool apply(const sobel::YuvImageView& input, sobel::GrayscaleImage& output, bool enableProfiling = false);
+    bool apply(const sobel::YuvImageView& input, const OutputDescriptor& outputs, bool enableProfiling = false);
+
+    // Same, from 10/12/16-bit samples (LSB-aligned in uint16): both gradient passes accumulate in
+    // int32, so magnitudes and the edge map use the full dynamic range. Gx/Gy planes still
+    // saturate to int16; request the magnitude plane for unclipped values.
+    bool apply(const sobel::GrayscaleImage16& input, sobel::GrayscaleImage& output, bool enableProfiling = false);
+    bool apply(const sobel::GrayscaleImage16& input, const OutputDescriptor& outputs, bool enableProfiling = false);
+    bool apply(const sobel::RGBImage16& input, sobel::GrayscaleImage& output, bool enableProfiling = false);
+    bool apply(const sobel::RGBImage16& input, const OutputDescriptor& outputs, bool enableProfiling = false);
+
+    // How color inputs (RGBImage, PackedImageView) become an edge magnitude. Luma (the default)
+    // converts to gray first; the other modes differentiate R, G and B separately and combine
+    // them per pixel, so edges between colors of equal luminance survive. Gx/Gy planes then
+    // hold the gradient of the strongest channel. The L1 adaptive tier has no color variant and
+    // runs the selected mode; the half-resolution tier and applyCanny/computeOrientation use luma.
+    void setColorGradient(sobel::ColorGradientMode mode) { colorMode_ = mode; }
+    sobel::ColorGradientMode getColorGradient() const { return colorMode_; }
+
+    // Gaussian pre-smoothing for noisy sensors, folded into the gradient kernels (see
+    // smoothed_gradient.hpp), so denoising adds taps to the row sweep instead of a blur pass over
+    // the frame. Covers every input, applyCanny and computeOrientation; adaptive tiers smooth at
+    // their own kernel size. Throws std::invalid_argument for an invalid configuration; a sigma
+    // of 0 turns it off.
+    void setPreSmoothing(const sobel::PreSmoothingConfig& smoothing);
+    const sobel::PreSmoothingConfig& getPreSmoothing() const { return preSmoothing_; }
+
+    // Edges only inside `regions`. Regions are clipped to the frame and overlapping ones merged
+    // (sobel::mergeRegions); each is filtered with its kernel halo taken from the surrounding
+    // image, so its pixels equal those of a full-frame apply() (the border mode only applies at
+    // the frame edge). Planes are written inside the regions only; the GrayscaleImage overloads
+    // clear the rest of the output to 0. The edge map is normalized per region or over their
+    // union. Always runs at full quality; returns false for empty input or no requested plane.
+    bool applyRegions(const sobel::RGBImage& input, const std::vector<sobel::RegionOfInterest>& regions,
+                      sobel::GrayscaleImage& output,
+                      sobel::RegionNormalization normalization = sobel::RegionNormalization::Union,
+                      bool enableProfiling = false);
+    bool applyRegions(const sobel::PackedImageView& input, const std::vector<sobel::RegionOfInterest>& regions,
+                      const OutputDescriptor& outputs,
+                      sobel::RegionNormalization normalization = sobel::RegionNormalization::Union,
+                      bool enableProfiling = false);
+    bool applyRegions(const sobel::GrayscaleImage& input, const std::vector<sobel::RegionOfInterest>& regions,
+                      sobel::GrayscaleImage& output,
+                      sobel::RegionNormalization normalization = sobel::RegionNormalization::Union,
+                      bool enableProfiling = false);
+    bool applyRegions(const sobel::GrayscaleImage& input, const std::vector<sobel::RegionOfInterest>& regions,
+                      const OutputDescriptor& outputs,
+                      sobel::RegionNormalization normalization = sobel::RegionNormalization::Union,
+                      bool enableProfiling = false);
+
+    // Edge maps of a 2x pyramid in one call: level 0 is the input size, each further level
+    // (w + 1) / 2 x (h + 1) / 2 of the one before. The input is converted to gray once; every
+    // level is a 2x2 box decimation of the previous gray level (sobel::downsampleRow2x) filtered
+    // at the configured kernel and normalized on its own. Color inputs use luma regardless of the
+    // color gradient mode. `outputs` is resized to `levels` images, and the level planes are kept
+    // between calls, so a steady stream allocates nothing. Always runs at full quality. Throws
+    // std::invalid_argument for levels == 0; returns false for empty input.
+    bool applyPyramid(const sobel::RGBImage& input, size_t levels, std::vector<sobel::GrayscaleImage>& outputs,
+                      bool enableProfiling = false);
+    bool applyPyramid(const sobel::PackedImageView& input, size_t levels, std::vector<sobel::GrayscaleImage>& outputs,
+                      bool enableProfiling = false);
+    bool applyPyramid(const sobel::GrayscaleImage& input, size_t levels, std::vector<sobel::GrayscaleImage>& outputs,
+                      bool enableProfiling = false);
+
+    // Canny edges (0/255) from the same streamed gradient rows: NMS on a 3-row window, then hysteresis
+    bool applyCanny(const sobel::RGBImage& input, sobel::GrayscaleImage& output,
+                    const sobel::CannyConfig& canny = sobel::CannyConfig());
+
+    // Quantized gradient direction per pixel (sobel::GradientDirection values 0..3)
+    bool computeOrientation(const sobel::RGBImage& input, sobel::GrayscaleImage& directions);
+
     const PerformanceMetrics& getLastMetrics() const { return lastMetrics_; }
+    void resetMetrics() { lastMetrics_ = PerformanceMetrics(); latency_.reset(); }
+
+    // Wall time of every apply/applyCanny/computeOrientation call since construction or resetMetrics()
+    const sobel::LatencyHistogram& getLatencyHistogram() const { return latency_; }
+    sobel::LatencySummary getLatencySummary() const { return latency_.summary(); }
+    // Calls slower than this count as deadline misses (default 16.67 ms, one 60 FPS frame)
+    void setFrameDeadline(std::chrono::nanoseconds deadline) { latency_.setDeadline(deadline); }
     std::string getCPUCapabilities();
-    void setConfig(const sobel::SobelConfig& config) { config_ = config; }
+    void setConfig(const sobel::SobelConfig& config);
+
+    // Kernel level, band height and threads per frame. AUTO filters take these from the
+    // wisdom file (see autotuner.hpp) for each new resolution; setTuning() fixes them instead.
+    void setTuning(const sobel::TuningParameters& tuning);
+    sobel::TuningParameters getTuning() const;
+
+    // Adaptive quality: apply() times feed a sobel::QualityController that steps the edge map
+    // down to cheaper tiers (L1 magnitude, 3x3 kernel, half resolution) while frames run over
+    // budget, and back up when there is headroom. Only edge-only requests are degraded; calls
+    // asking for Gx, Gy or magnitude planes always run at full quality. Throws
+    // std::invalid_argument for an invalid configuration; the controller restarts at Full.
+    void setAdaptiveQuality(const sobel::AdaptiveQualityConfig& adaptive);
+    const sobel::AdaptiveQualityConfig& getAdaptiveQuality() const { return quality_.config(); }
+    // Tier the next edge-only apply() will use
+    sobel::QualityTier getQualityTier() const { return quality_.tier(); }
 
 private:
     // --- Configuration / state ---
     sobel::SobelConfig config_;
     OptimizationLevel optimizationLevel_;
+    OptimizationLevel featureLevel_ = OptimizationLevel::SCALAR;   // Best level by CPU features (AUTO fallback)
+    bool autoTuning_ = false;     // Re-read wisdom whenever the resolution changes
+    bool buffersPinned_ = false;  // applyRegions() sized the buffers for the whole frame
+    size_t bandHeight_ = 0;       // Rows per work item (0 = whole frame)
+    unsigned threads_ = 1;        // Workers per frame (0 = hardware concurrency)
+    std::unique_ptr<sobel::ThreadPool> pool_;   // Helpers of a multi-threaded tuning (null = run on the caller)
     PerformanceMetrics lastMetrics_;
     std::chrono::high_resolution_clock::time_point profilingStart_;
+    sobel::StageTicks stageTicks_{};   // Timestamp ticks per stage for the current call
+    sobel::LatencyHistogram latency_;
+    std::chrono::steady_clock::time_point frameStart_;
+    sobel::AllocationRecorder allocationRecorder_;
+    std::chrono::nanoseconds lastFrameTime_{0};
+    sobel::QualityController quality_;
+    sobel::ColorGradientMode colorMode_ = sobel::ColorGradientMode::Luma;
+    sobel::PreSmoothingConfig preSmoothing_;
+    std::array<sobel::SmoothedGradientEngine, 3> smoothedEngines_;   // 3x3, 5x5, 7x7 while smoothing is on
+
+    // --- Gray source: an internal haloed plane, or the caller's GrayFrame ---
+    sobel::GrayFrame gray_;
+    sobel::GrayFrame16 gray16_;           // High-bit-depth input
+    const uint8_t* source_ = nullptr;     // Pixel (0, 0) of the plane the row stages read...
+    const uint16_t* source16_ = nullptr;  // ...or of a 16-bit plane (exactly one is set)
+    size_t sourceStride_ = 0;             // In samples
+    std::array<sobel::GrayFrame, 3> channels_;   // R, G, B planes of per-channel color gradients
+    bool colorSource_ = false;            // source_ is channels_[0]; the row stages read all three
+    size_t bufferWidth_ = 0;      // Width processed by the row stages
+    size_t bufferHeight_ = 0;     // Height processed by the row stages
 
-    // --- Step 1 infrastructure (aligned grayscale buffer) ---
-    std::unique_ptr<uint8_t[], void(*)(void*)> grayBuffer_{nullptr, &SobelFilterSIMD::alignedDeleter};
-    size_t bufferWidth_ = 0;      // original width
-    size_t bufferHeight_ = 0;     // original height
-    size_t paddedWidth_ = 0;      // width padded to 32-byte alignment (in pixels)
+    // --- Row-window scratch for the separable gradient engine, one per worker ---
+    struct RowScratch {
+        std::vector<int32_t> gx;
+        std::vector<int32_t> gy;
+        std::vector<int16_t> engine;
+        std::vector<int32_t> engineWide;  // 16-bit engine scratch, sized on the first 16-bit frame
+        std::vector<float> engineSmoothed;    // Pre-smoothing engine scratch, sized once smoothing is on
+        std::vector<int32_t> colorGradients;  // Gx of R, G, B then Gy of R, G, B; sized on the first color-mode frame
+        sobel::StageTicks ticks{};     // Folded into stageTicks_ after each parallel phase
+        float minMagnitude = 0.0f;
+        float maxMagnitude = 0.0f;
+    };
+    std::vector<RowScratch> rowScratch_;
+    std::vector<float> magnitudes_;
+    std::vector<uint8_t> halfEdges_;      // Edge map of the half-resolution tier
+    std::vector<sobel::RegionOfInterest> regions_;   // Merged regions of the current applyRegions()
+    std::vector<sobel::GrayFrame> pyramid_;          // Gray levels 1.. of applyPyramid()
 
-    static void alignedDeleter(void* p);
-    static void* alignedAlloc(size_t bytes, size_t alignment);
+    // --- Canny: 3-row ring of magnitudes/gradients plus a bordered edge state map ---
+    std::vector<float> cannyMagnitude_;   // 4 rows (3 ring + 1 zero row), one zero pad each side
+    std::vector<int32_t> cannyGx_;        // 3 ring rows
+    std::vector<int32_t> cannyGy_;        // 3 ring rows
+    std::vector<uint8_t> cannyState_;     // (width + 2) x (height + 2), zero border
+    std::vector<uint8_t*> cannyStack_;
 
     void ensureBuffers(size_t width, size_t height);
-    void convertRGBToGrayscaleScalar(const sobel::RGBImage& input);
+    void ensureWideScratch();
+    void ensureColorScratch();
+    void ensureSmoothingScratch();
+    void useSource(const sobel::GrayFrame& frame) {
+        source_ = frame.origin();
+        source16_ = nullptr;
+        sourceStride_ = frame.stride();
+        colorSource_ = false;
+    }
+    void useSource(const sobel::GrayFrame16& frame) {
+        source_ = nullptr;
+        source16_ = frame.origin();
+        sourceStride_ = frame.stride();
+        colorSource_ = false;
+    }
+    sobel::SimdLevel simdLevel() const;
+    void resolveAutoLevel();
+    void applyWisdom(size_t width, size_t height);
+    size_t workerCount() const { return pool_ ? pool_->size() : 1; }
+
+    // Run work(worker, y0, y1) over bands of bandHeight_ rows on up to threads_ pool workers
+    template<typename Work>
+    void forEachBand(Work&& work) const;
+    void foldWorkerTicks();
+
+    void prepareGray(const sobel::PackedImageView& input);
+    void prepareGray(sobel::GrayFrame& frame);
+    // De-interleave into channels_ for a per-channel color gradient
+    void prepareChannels(const sobel::PackedImageView& input);
+    void prepareLuma(const uint8_t* src, size_t stride, size_t step, size_t w, size_t h);
+    // Fill gray16_ with convert(y0, y1) and make it the source
+    template<typename Convert>
+    void prepareGray16(size_t w, size_t h, Convert&& convert);
+    // Half-resolution rows y0..y1 of an internal plane: 2x2-averaged color (fixed-point luma) or
+    // luma samples `step` apart
+    void convertPackedToHalfGray(const sobel::PackedImageView& input, size_t y0, size_t y1);
+    void convertRGB16ToHalfGray(const sobel::RGBImage16& input, size_t y0, size_t y1);
+    template<typename T>
+    void convertGrayToHalfGray(const T* src, size_t stride, size_t step, size_t w, size_t h,
+                               sobel::BasicGrayFrame<T>& out, size_t y0, size_t y1);
+
+    // Gx/Gy of the row at `src` in a haloed plane, through the pre-smoothing engine when it is on
+    template<int N, typename T>
+    void gradientRowFrom(const T* src, int32_t* gx, int32_t* gy, RowScratch& scratch) const;
+    // Gx/Gy of source row y from whichever plane is the source
+    template<int N>
+    void sourceGradientRow(size_t y, int32_t* gx, int32_t* gy, RowScratch& scratch) const;
+    // Gx/Gy of row y of every channel plane into scratch.colorGradients
+    template<int N>
+    void channelGradientRows(size_t y, RowScratch& scratch) const;
+
+    struct MagnitudeRange {
+        float min;
+        float max;
+    };
+
+    // Separable NxN Sobel over the haloed gray buffer (N = 3, 5, 7); returns the magnitude range
+    template<int N>
+    MagnitudeRange sobelSeparable(const OutputDescriptor& outputs, bool l1Magnitude = false);
+    MagnitudeRange runSobel(int kernelSize, const OutputDescriptor& outputs, bool l1Magnitude);
 
-    // Future (Step 2+): SIMD conversion & convolution
-    void convertRGBToGrayscaleSSE(const sobel::RGBImage& input);
-    void convertRGBToGrayscaleAVX2(const sobel::RGBImage& input);
-    void sobel5x5Scalar(const uint8_t* gray, sobel::GrayscaleImage& out);
-    void sobel5x5SSE(const uint8_t* gray, sobel::GrayscaleImage& out);
-    void sobel5x5AVX2(const uint8_t* gray, sobel::GrayscaleImage& out);
+    // Validation, adaptive tier choice and metrics around one apply(); `prepare` fills the gray
+    // source at full size, `halve(y0, y1)` writes half-resolution rows into `halfPlane` (gray_ or
+    // gray16_); inputPixelBytes only feeds the bandwidth metric
+    template<typename Plane, typename Prepare, typename Halve>
+    bool applyFrame(Plane& halfPlane, size_t width, size_t height, size_t inputPixelBytes,
+                    const OutputDescriptor& outputs, bool enableProfiling, Prepare&& prepare, Halve&& halve);
+    // Validation, merging and normalization around one applyRegions(); `prepare(area)` fills the
+    // source with `area` (a region plus its halo, clipped to the frame) at the current logical size,
+    // into channels_ when `colorInput` and a color gradient mode is set, else into gray_
+    template<typename Prepare>
+    bool applyRegionsFrame(size_t width, size_t height, size_t inputPixelBytes, bool colorInput,
+                           const std::vector<sobel::RegionOfInterest>& regions, const OutputDescriptor& outputs,
+                           sobel::RegionNormalization normalization, bool enableProfiling, Prepare&& prepare);
+    // Gray conversion once via `prepare`, then decimation and an edge map per pyramid level
+    template<typename Prepare>
+    bool applyPyramidFrame(size_t width, size_t height, size_t inputPixelBytes, size_t levels,
+                           std::vector<sobel::GrayscaleImage>& outputs, bool enableProfiling, Prepare&& prepare);
+    // Edge map of the half-resolution tier, upsampled into `edges`
+    template<typename Plane, typename Halve>
+    void applyHalfResolution(Plane& plane, size_t width, size_t height, Halve&& halve,
+                             uint8_t* edges, size_t edgesStride);
+    template<int N>
+    void cannySeparable(const sobel::CannyConfig& canny, sobel::GrayscaleImage& out);
+    template<int N>
+    void orientationSeparable(sobel::GrayscaleImage& out);
 
-    // Helper for quantization (same logic as baseline)
-    std::vector<uint8_t> quantizeWithConfig(const std::vector<double>& magnitudes) const;
+    // Quantization (same logic as baseline) from the collected magnitude range
+    void quantizeWithConfig(float minMagnitude, float maxMagnitude, const float* magnitudes,
+                            size_t magnitudeStride, uint8_t* out, size_t outStride) const;
 
     // Profiling helpers
     void startProfiling();
     void endProfiling();
+    void recordMetrics(size_t totalPixels, size_t inputPixelBytes);
+    void beginFrame();
+    void endFrame();
 };
@@ -0,0 +1,134 @@
+/**
+ * @file sobel_kernels.hpp
+ * @brief Compile-time generation of NxN Sobel kernel coefficients
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace sobel {
+
+/**
+ * @brief NxN Sobel kernel type
+ */
+template<int N>
+using SobelKernel = std::array<std::array<int, N>, N>;
+
+namespace detail {
+
+/**
+ * @brief Row `n` of Pascal's triangle (n + 1 entries, zero-filled to Size)
+ */
+template<int Size>
+constexpr std::array<int, Size> binomialRow(int n) {
+    std::array<int, Size> row{};
+    row[0] = 1;
+    for (int k = 1; k <= n; ++k) {
+        for (int i = k; i > 0; --i) {
+            row[i] += row[i - 1];
+        }
+    }
+    return row;
+}
+
+} // namespace detail
+
+/**
+ * @brief Separable Sobel coefficients for an odd kernel size N
+ *
+ * The smoothing vector is binomial row N-1 and the derivative vector is
+ * binomial row N-2 convolved with [-1, 1], so the full kernels are
+ * Kx = smooth^T * derivative and Ky = derivative^T * smooth.
+ */
+template<int N>
+struct SobelCoefficients {
+    static_assert(N >= 3 && N % 2 == 1, "Sobel kernel size must be odd and >= 3");
+
+    static constexpr int size = N;
+    static constexpr int radius = N / 2;
+
+    static constexpr std::array<int, N> smoothing() {
+        return detail::binomialRow<N>(N - 1);
+    }
+
+    static constexpr std::array<int, N> derivative() {
+        const std::array<int, N> base = detail::binomialRow<N>(N - 2);
+        std::array<int, N> d{};
+        for (int i = 0; i < N; ++i) {
+            d[i] = (i > 0 ? base[i - 1] : 0) - (i < N - 1 ? base[i] : 0);
+        }
+        return d;
+    }
+
+    /**
+     * @brief Sum of smoothing coefficients (2^(N-1))
+     */
+    static constexpr int smoothingSum() {
+        int sum = 0;
+        for (int v : smoothing()) sum += v;
+        return sum;
+    }
+
+    /**
+     * @brief Sum of positive derivative coefficients
+     */
+    static constexpr int derivativeGain() {
+        int sum = 0;
+        for (int v : derivative()) sum += v > 0 ? v : 0;
+        return sum;
+    }
+
+    /**
+     * @brief Largest |Gx| or |Gy| reachable from 8-bit input
+     */
+    static constexpr int32_t maxResponse() {
+        return 255 * smoothingSum() * derivativeGain();
+    }
+};
+
+/**
+ * @brief Build the full NxN X-direction kernel at compile time
+ */
+template<int N>
+constexpr SobelKernel<N> makeSobelKernelX() {
+    constexpr auto s = SobelCoefficients<N>::smoothing();
+    constexpr auto d = SobelCoefficients<N>::derivative();
+    SobelKernel<N> k{};
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            k[y][x] = s[y] * d[x];
+        }
+    }
+    return k;
+}
+
+/**
+ * @brief Build the full NxN Y-direction kernel at compile time
+ */
+template<int N>
+constexpr SobelKernel<N> makeSobelKernelY() {
+    constexpr auto s = SobelCoefficients<N>::smoothing();
+    constexpr auto d = SobelCoefficients<N>::derivative();
+    SobelKernel<N> k{};
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            k[y][x] = d[y] * s[x];
+        }
+    }
+    return k;
+}
+
+// The generated 5x5 kernels must match the classic hand-written ones
+static_assert(makeSobelKernelX<5>()[2][0] == -6 && makeSobelKernelX<5>()[2][1] == -12 &&
+              makeSobelKernelX<5>()[1][3] == 8, "5x5 Sobel X kernel mismatch");
+static_assert(makeSobelKernelY<5>()[0][2] == -6 && makeSobelKernelY<5>()[4][1] == 4,
+              "5x5 Sobel Y kernel mismatch");
+static_assert(SobelCoefficients<3>::derivative()[0] == -1 && SobelCoefficients<3>::derivative()[1] == 0,
+              "3x3 Sobel derivative mismatch");
+
+} // namespace sobel
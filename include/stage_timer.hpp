@@ -0,0 +1,114 @@
+/**
+ * @file stage_timer.hpp
+ * @brief Low-overhead per-stage timestamp-counter timers for the filter pipeline
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Stage timers are compiled in unless the build sets SOBEL_STAGE_TIMERS=0
+#ifndef SOBEL_STAGE_TIMERS
+#define SOBEL_STAGE_TIMERS 1
+#endif
+
+namespace sobel {
+
+/**
+ * @brief Pipeline stages timed inside SobelFilterSIMD
+ */
+enum class PipelineStage : std::size_t {
+    Setup,           // Scratch buffer (re)allocation
+    GrayConversion,  // RGB -> gray plus halo fill
+    Convolution,     // Separable gradient rows
+    Magnitude,       // sqrt(gx^2 + gy^2) and range tracking
+    Quantization,    // Magnitude -> 8-bit edge map
+    Output,          // Gx/Gy narrowing into caller planes
+    Suppression,     // Canny non-maximum suppression
+    Hysteresis,      // Canny hysteresis and final edge map
+    Count
+};
+
+constexpr std::size_t kPipelineStageCount = static_cast<std::size_t>(PipelineStage::Count);
+
+/**
+ * @brief Printable stage name
+ */
+const char* stageName(PipelineStage stage);
+
+/**
+ * @brief Running statistics of one stage across calls (microseconds per call)
+ */
+struct StageTiming {
+    uint64_t calls = 0;
+    double lastUs = 0.0;
+    double minUs = 0.0;
+    double maxUs = 0.0;
+    double totalUs = 0.0;
+
+    double meanUs() const { return calls ? totalUs / static_cast<double>(calls) : 0.0; }
+
+    void add(double us) {
+        minUs = calls ? (us < minUs ? us : minUs) : us;
+        maxUs = calls ? (us > maxUs ? us : maxUs) : us;
+        lastUs = us;
+        totalUs += us;
+        ++calls;
+    }
+};
+
+using StageTicks = std::array<uint64_t, kPipelineStageCount>;
+
+/**
+ * @brief Raw timestamp: TSC on x86, steady_clock nanoseconds elsewhere
+ */
+inline uint64_t readTimestamp() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Timestamp ticks per microsecond (measured once against steady_clock)
+ */
+double timestampTicksPerMicrosecond();
+
+/**
+ * @brief Adds the ticks spent in its scope to one stage's accumulator
+ */
+class ScopedStageTimer {
+public:
+    ScopedStageTimer(StageTicks& ticks, PipelineStage stage)
+        : slot_(ticks[static_cast<std::size_t>(stage)]), start_(readTimestamp()) {}
+
+    ~ScopedStageTimer() { slot_ += readTimestamp() - start_; }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    uint64_t& slot_;
+    uint64_t start_;
+};
+
+} // namespace sobel
+
+#if SOBEL_STAGE_TIMERS
+#define SOBEL_TIME_STAGE(ticks, stage) ::sobel::ScopedStageTimer sobelStageTimer_(ticks, stage)
+#else
+#define SOBEL_TIME_STAGE(ticks, stage) ((void)0)
+#endif
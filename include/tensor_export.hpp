@@ -0,0 +1,121 @@
+/**
+ * @file tensor_export.hpp
+ * @brief Batched NCHW float32 / int8 tensor export of edge maps and gradients
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include "image.hpp"
+#include "sobel_filter.hpp"
+#include "sobel_filter_simd.hpp"
+#include "sobel_engine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sobel {
+
+/**
+ * @brief Channels written per frame
+ */
+enum class TensorContent {
+    EdgeMap,                // C = 1: 8-bit edge map
+    Gradients,              // C = 2: Gx, Gy (int16, saturated)
+    GradientsAndMagnitude   // C = 3: Gx, Gy, float magnitude
+};
+
+/**
+ * @brief Configuration for tensor export
+ *
+ * Every element is written as value * scale + offset. For int8 tensors the
+ * result is rounded to nearest (ties to even) and saturated to [-128, 127].
+ */
+struct TensorExportConfig {
+    float scale = 1.0f;
+    float offset = 0.0f;
+    unsigned threads = 0;   // Worker threads across the batch (0 = hardware concurrency)
+    SobelFilterSIMD::OptimizationLevel optimization = SobelFilterSIMD::OptimizationLevel::AUTO;
+
+    TensorExportConfig() = default;
+
+    TensorExportConfig(float s, float o) : scale(s), offset(o) {}
+};
+
+/**
+ * @brief Number of channels a content selection produces
+ */
+constexpr std::size_t tensorChannels(TensorContent content) noexcept {
+    return content == TensorContent::EdgeMap ? 1 : content == TensorContent::Gradients ? 2 : 3;
+}
+
+/**
+ * @brief Apply value * scale + offset to a row of values and store as float32 or int8
+ *
+ * Overloads exist for uint8, int16 and float sources and for float and int8
+ * destinations. Exactly `count` elements are written.
+ */
+void convertToTensor(SimdLevel level, const uint8_t* input, std::size_t count, float scale, float offset, float* output);
+void convertToTensor(SimdLevel level, const int16_t* input, std::size_t count, float scale, float offset, float* output);
+void convertToTensor(SimdLevel level, const float* input, std::size_t count, float scale, float offset, float* output);
+void convertToTensor(SimdLevel level, const uint8_t* input, std::size_t count, float scale, float offset, int8_t* output);
+void convertToTensor(SimdLevel level, const int16_t* input, std::size_t count, float scale, float offset, int8_t* output);
+void convertToTensor(SimdLevel level, const float* input, std::size_t count, float scale, float offset, int8_t* output);
+
+/**
+ * @brief Writes batches of filter results into contiguous NCHW tensors
+ *
+ * Frames are distributed over worker threads; each worker owns its filter
+ * and scratch planes, so the buffers are allocated once per call rather than
+ * once per frame, and results go straight into the frame's tensor slice.
+ */
+class TensorExporter {
+public:
+    explicit TensorExporter(const TensorExportConfig& config = TensorExportConfig());
+
+    const TensorExportConfig& config() const noexcept { return config_; }
+
+    /**
+     * @brief Elements needed for a batch of `batch` frames of width x height
+     */
+    static std::size_t elementCount(std::size_t batch, TensorContent content,
+                                    std::size_t width, std::size_t height) noexcept {
+        return batch * tensorChannels(content) * width * height;
+    }
+
+    /**
+     * @brief Export already-filtered edge maps as an N x 1 x H x W tensor
+     * @param maps Edge maps, all of the same size
+     * @param tensor Destination with elementCount(maps.size(), EdgeMap, W, H) entries
+     * @throws std::invalid_argument if the maps differ in size
+     */
+    void exportEdgeMaps(const std::vector<GrayscaleImage>& maps, float* tensor) const;
+    void exportEdgeMaps(const std::vector<GrayscaleImage>& maps, int8_t* tensor) const;
+
+    /**
+     * @brief Filter every frame and write the requested channels as N x C x H x W
+     * @param frames Input frames, all of the same size
+     * @param filterConfig Sobel configuration used for every frame
+     * @param content Channels to write
+     * @param tensor Destination with elementCount(frames.size(), content, W, H) entries
+     * @throws std::invalid_argument if the frames differ in size or are empty
+     */
+    void exportBatch(const std::vector<RGBImage>& frames, const SobelConfig& filterConfig,
+                     TensorContent content, float* tensor) const;
+    void exportBatch(const std::vector<RGBImage>& frames, const SobelConfig& filterConfig,
+                     TensorContent content, int8_t* tensor) const;
+
+private:
+    TensorExportConfig config_;
+    SimdLevel level_;
+
+    template<typename T>
+    void exportEdgeMapsImpl(const std::vector<GrayscaleImage>& maps, T* tensor) const;
+    template<typename T>
+    void exportBatchImpl(const std::vector<RGBImage>& frames, const SobelConfig& filterConfig,
+                         TensorContent content, T* tensor) const;
+};
+
+} // namespace sobel
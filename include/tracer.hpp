@@ -0,0 +1,162 @@
+/**
+ * @file tracer.hpp
+ * @brief Span tracer with per-thread lock-free buffers and Chrome Trace Event export
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Trace points are compiled in unless the build sets SOBEL_TRACING=0
+#ifndef SOBEL_TRACING
+#define SOBEL_TRACING 1
+#endif
+
+namespace sobel {
+
+/**
+ * @brief One recorded span
+ */
+struct TraceSpan {
+    const char* name;      // Static string (stage or function name)
+    uint64_t frameId;      // 0 when recorded outside a frame
+    uint64_t startNs;      // Relative to the tracer epoch
+    uint64_t endNs;
+};
+
+/**
+ * @brief Process-wide span recorder
+ *
+ * Recording is off until enable() is called or the SOBEL_TRACE environment
+ * variable names an output file. Each thread appends to its own chunked
+ * buffer: the only shared state on the hot path is the enabled flag, and
+ * spans are published with a release store of the chunk's count, so
+ * recording never takes a lock. When a thread exits, its spans are copied
+ * into a compact list and its buffer is freed, so short-lived threads do not
+ * pile up buffers. A thread keeps its tid for its whole life, and the tid is
+ * never reused. Spans are written out as Chrome Trace Event JSON
+ * (chrome://tracing, Perfetto) at process exit or on demand.
+ */
+class Tracer {
+public:
+    /**
+     * @brief Start recording; the trace is written to `outputPath` at exit (empty = no automatic dump)
+     */
+    static void enable(const std::string& outputPath = std::string());
+
+    /**
+     * @brief Stop recording (already recorded spans are kept)
+     */
+    static void disable();
+
+    static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Nanoseconds since the tracer epoch (never 0)
+     */
+    static uint64_t now() noexcept;
+
+    /**
+     * @brief Append a span for the calling thread and its current frame
+     */
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    /**
+     * @brief Frame id attached to spans recorded by the calling thread (0 = none)
+     */
+    static uint64_t currentFrame() noexcept;
+    static void setCurrentFrame(uint64_t frameId) noexcept;
+
+    /**
+     * @brief Allocate a new process-unique frame id
+     */
+    static uint64_t nextFrameId() noexcept;
+
+    /**
+     * @brief Number of spans recorded so far
+     */
+    static std::size_t spanCount();
+
+    /**
+     * @brief Number of per-thread buffers held (at most one per live thread that recorded)
+     */
+    static std::size_t bufferCount();
+
+    /**
+     * @brief Write all spans as Chrome Trace Event JSON
+     */
+    static void writeChromeTrace(std::ostream& out);
+    static bool writeChromeTrace(const std::string& path);
+
+    /**
+     * @brief Drop all spans; only call while no thread is recording (threads keep their buffers and tids)
+     */
+    static void clear();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+/**
+ * @brief Records a span covering its scope when tracing is enabled
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) noexcept
+        : name_(name), start_(Tracer::enabled() ? Tracer::now() : 0) {}
+
+    ~TraceScope() {
+        if (start_) Tracer::record(name_, start_, Tracer::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+
+/**
+ * @brief Tags spans of the calling thread with a frame id for its scope
+ *
+ * A scope opened inside another keeps the outer frame, so an application can
+ * group load, filter and save of one frame under a single id.
+ */
+class TraceFrameScope {
+public:
+    TraceFrameScope() noexcept : previous_(Tracer::currentFrame()) {
+        if (!previous_ && Tracer::enabled()) Tracer::setCurrentFrame(Tracer::nextFrameId());
+    }
+
+    explicit TraceFrameScope(uint64_t frameId) noexcept : previous_(Tracer::currentFrame()) {
+        if (!previous_) Tracer::setCurrentFrame(frameId);
+    }
+
+    ~TraceFrameScope() { Tracer::setCurrentFrame(previous_); }
+
+    TraceFrameScope(const TraceFrameScope&) = delete;
+    TraceFrameScope& operator=(const TraceFrameScope&) = delete;
+
+private:
+    uint64_t previous_;
+};
+
+} // namespace sobel
+
+#if SOBEL_TRACING
+#define SOBEL_TRACE_CONCAT_(a, b) a##b
+#define SOBEL_TRACE_NAME_(line) SOBEL_TRACE_CONCAT_(sobelTraceScope_, line)
+#define SOBEL_TRACE_SPAN(name) ::sobel::TraceScope SOBEL_TRACE_NAME_(__LINE__)(name)
+#define SOBEL_TRACE_FRAME() ::sobel::TraceFrameScope SOBEL_TRACE_NAME_(__LINE__)
+#else
+#define SOBEL_TRACE_SPAN(name) ((void)0)
+#define SOBEL_TRACE_FRAME() ((void)0)
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file tsv_records.hpp
+ * @brief Tab-separated record files shared by the benchmark baseline and the wisdom file
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sobel {
+
+/**
+ * @brief A field a record parser rejects; the reader prefixes the file and line
+ */
+class TsvFieldError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Call parse(fields) for every record of a TSV file (missing file = no records)
+ *
+ * Blank lines and lines starting with '#' are skipped. Every record must have
+ * exactly `fieldCount` tab-separated fields.
+ * @throws std::runtime_error "path:line: ..." for a wrong field count, a
+ *         TsvFieldError from `parse`, or a std::stoi/stoul/stod failure in it
+ *         (reported as a malformed number)
+ */
+void readTsvRecords(const std::string& path, std::size_t fieldCount,
+                    const std::function<void(const std::vector<std::string>& fields)>& parse);
+
+/**
+ * @brief Rewrite `path` as a '#' header of `columns` and one line per record
+ *
+ * writeRecord(out, i) writes the tab-separated fields of record i (without the
+ * newline); doubles are written fixed with one decimal.
+ * @throws std::runtime_error "Cannot write <what> <path>" if the file cannot be opened
+ */
+void writeTsvRecords(const std::string& path, const std::string& what, const std::vector<std::string>& columns,
+                     std::size_t count, const std::function<void(std::ostream& out, std::size_t index)>& writeRecord);
+
+/**
+ * @brief Replace the entry for which sameKey(existing, entry) holds, else append
+ */
+template<typename Entry, typename SameKey>
+void upsertRecord(std::vector<Entry>& entries, const Entry& entry, SameKey&& sameKey) {
+    auto existing = std::find_if(entries.begin(), entries.end(), [&](const Entry& e) { return sameKey(e, entry); });
+    if (existing != entries.end()) *existing = entry;
+    else entries.push_back(entry);
+}
+
+} // namespace sobel
@@ -0,0 +1,53 @@
+/**
+ * @file yuv_image.hpp
+ * @brief Non-owning views of camera YUV frames (NV12, I420, YUYV) for luma-only consumers
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sobel {
+
+/**
+ * @brief Memory layouts of the supported YUV formats
+ */
+enum class YuvFormat {
+    NV12,    // Y plane, then one interleaved U/V plane at half resolution
+    I420,    // Y plane, then separate U and V planes at half resolution
+    YUYV     // Packed 4:2:2, Y0 U Y1 V per pixel pair
+};
+
+/**
+ * @brief View of a YUV frame; edge detection reads only its luma
+ *
+ * For NV12 and I420 `luma` is the Y plane, whose samples are already the
+ * gray values the filter works on, so chroma planes are never touched and
+ * need not be described. For YUYV `luma` is the packed buffer and the Y
+ * samples are every other byte.
+ */
+struct YuvImageView {
+    YuvFormat format = YuvFormat::NV12;
+    const uint8_t* luma = nullptr;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t stride = 0;     // Bytes per row of `luma` (0 = packed rows, see rowBytes())
+
+    bool empty() const noexcept { return width == 0 || height == 0; }
+
+    /// Distance between Y samples of neighbouring pixels
+    std::size_t pixelStep() const noexcept { return format == YuvFormat::YUYV ? 2 : 1; }
+
+    /// Smallest row size of the format: width for the Y plane, 2 bytes per pixel (pairs rounded up) for YUYV
+    std::size_t rowBytes() const noexcept {
+        return format == YuvFormat::YUYV ? (width + 1) / 2 * 4 : width;
+    }
+
+    std::size_t resolvedStride() const noexcept { return stride ? stride : rowBytes(); }
+};
+
+} // namespace sobel
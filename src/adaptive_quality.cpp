@@ -0,0 +1,81 @@
+/**
+ * @file adaptive_quality.cpp
+ * @brief Implementation of the frame-budget quality controller
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "adaptive_quality.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace sobel {
+
+namespace {
+
+constexpr std::size_t kMaxHoldWindows = 64;
+
+} // namespace
+
+const char* qualityTierName(QualityTier tier) {
+    switch (tier) {
+        case QualityTier::L1Magnitude:    return "L1 magnitude";
+        case QualityTier::Kernel3x3:      return "3x3 kernel";
+        case QualityTier::HalfResolution: return "Half resolution";
+        default: return "Full";
+    }
+}
+
+QualityController::QualityController(const AdaptiveQualityConfig& config) : config_(config) {
+    if (config_.budget.count() <= 0) throw std::invalid_argument("Adaptive quality budget must be positive");
+    if (config_.window == 0) throw std::invalid_argument("Adaptive quality window must be at least one frame");
+    if (!(config_.upshift_ratio > 0.0 && config_.upshift_ratio < config_.downshift_ratio)) {
+        throw std::invalid_argument("Adaptive quality ratios must satisfy 0 < upshift_ratio < downshift_ratio");
+    }
+    reset();
+}
+
+void QualityController::reset() {
+    tier_ = QualityTier::Full;
+    framesInTier_ = 0;
+    upHold_ = config_.window;
+    steppedUp_ = false;
+    meanNs_ = 0.0;
+}
+
+void QualityController::changeTier(QualityTier tier) {
+    tier_ = tier;
+    framesInTier_ = 0;
+    meanNs_ = 0.0;
+}
+
+QualityTier QualityController::update(std::chrono::nanoseconds frameTime) {
+    const double ns = static_cast<double>(frameTime.count());
+    const double budget = static_cast<double>(config_.budget.count());
+    const double alpha = 2.0 / (static_cast<double>(config_.window) + 1.0);
+    ++framesInTier_;
+    meanNs_ = framesInTier_ == 1 ? ns : meanNs_ + (ns - meanNs_) * alpha;
+
+    const int tier = static_cast<int>(tier_);
+    const bool settled = framesInTier_ >= config_.window;
+    const bool overBudget = ns > budget || (settled && meanNs_ > budget * config_.downshift_ratio);
+    if (tier < static_cast<int>(config_.lowest_tier) && overBudget) {
+        // Undoing a recent step up: wait longer before the next one
+        if (steppedUp_ && framesInTier_ <= config_.window) {
+            upHold_ = std::min(upHold_ * 2, config_.window * kMaxHoldWindows);
+        }
+        steppedUp_ = false;
+        changeTier(static_cast<QualityTier>(tier + 1));
+    } else if (tier > 0 && framesInTier_ >= upHold_ && meanNs_ < budget * config_.upshift_ratio) {
+        steppedUp_ = true;
+        changeTier(static_cast<QualityTier>(tier - 1));
+    } else if (steppedUp_ && settled) {
+        // The step up held for a full window
+        steppedUp_ = false;
+        upHold_ = config_.window;
+    }
+    return tier_;
+}
+
+} // namespace sobel
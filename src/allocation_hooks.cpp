@@ -0,0 +1,123 @@
+/**
+ * @file allocation_hooks.cpp
+ * @brief Counting global operator new/delete feeding the allocation recorder
+ *
+ * Built as the sobel_alloc_hooks object library and linked only into the
+ * benchmark and the tests, so programs using sobel_core keep their own
+ * allocator.
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "allocation_tracker.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace sobel {
+
+namespace {
+
+// Every block carries a header with its requested size so frees can be accounted.
+// The header is one alignment unit, keeping the user pointer aligned as requested.
+constexpr std::size_t kDefaultAlignment = alignof(std::max_align_t);
+
+void* trackedAllocate(std::size_t size, std::size_t alignment) noexcept {
+    const std::size_t header = std::max(alignment, kDefaultAlignment);
+    if (size > static_cast<std::size_t>(-1) - 2 * header) return nullptr;
+    void* base = nullptr;
+    if (alignment <= kDefaultAlignment) {
+        base = std::malloc(size + header);
+    } else {
+#if defined(_MSC_VER)
+        base = _aligned_malloc(size + header, alignment);
+#else
+        // aligned_alloc wants a multiple of the alignment
+        base = std::aligned_alloc(alignment, (size + header + alignment - 1) / alignment * alignment);
+#endif
+    }
+    if (!base) return nullptr;
+
+    unsigned char* user = static_cast<unsigned char*>(base) + header;
+    *reinterpret_cast<std::size_t*>(user - sizeof(std::size_t)) = size;
+    recordHeapAllocation(size);
+    return user;
+}
+
+void trackedFree(void* ptr, std::size_t alignment) noexcept {
+    if (!ptr) return;
+    const std::size_t header = std::max(alignment, kDefaultAlignment);
+    unsigned char* user = static_cast<unsigned char*>(ptr);
+    recordHeapFree(*reinterpret_cast<std::size_t*>(user - sizeof(std::size_t)));
+#if defined(_MSC_VER)
+    if (alignment > kDefaultAlignment) {
+        _aligned_free(user - header);
+        return;
+    }
+#endif
+    std::free(user - header);
+}
+
+void* allocateOrThrow(std::size_t size, std::size_t alignment) {
+    for (;;) {
+        if (void* p = trackedAllocate(size, alignment)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* allocateNoThrow(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return allocateOrThrow(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+// Runs during static initialization of any program this object is linked into
+const bool hooksInstalled = (markAllocationHooksInstalled(), true);
+
+} // namespace
+
+} // namespace sobel
+
+// Replaceable global allocation functions ([new.delete]); all forms route through the tracked allocator
+void* operator new(std::size_t size) { return sobel::allocateOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return sobel::allocateOrThrow(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return sobel::allocateNoThrow(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return sobel::allocateNoThrow(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al) {
+    return sobel::allocateOrThrow(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+    return sobel::allocateOrThrow(size, static_cast<std::size_t>(al));
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return sobel::allocateNoThrow(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return sobel::allocateNoThrow(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* p) noexcept { sobel::trackedFree(p, 0); }
+void operator delete[](void* p) noexcept { sobel::trackedFree(p, 0); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { sobel::trackedFree(p, 0); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { sobel::trackedFree(p, 0); }
+void operator delete(void* p, std::size_t) noexcept { sobel::trackedFree(p, 0); }
+void operator delete[](void* p, std::size_t) noexcept { sobel::trackedFree(p, 0); }
+void operator delete(void* p, std::align_val_t al) noexcept { sobel::trackedFree(p, static_cast<std::size_t>(al)); }
+void operator delete[](void* p, std::align_val_t al) noexcept { sobel::trackedFree(p, static_cast<std::size_t>(al)); }
+void operator delete(void* p, std::align_val_t al, const std::nothrow_t&) noexcept {
+    sobel::trackedFree(p, static_cast<std::size_t>(al));
+}
+void operator delete[](void* p, std::align_val_t al, const std::nothrow_t&) noexcept {
+    sobel::trackedFree(p, static_cast<std::size_t>(al));
+}
+void operator delete(void* p, std::size_t, std::align_val_t al) noexcept {
+    sobel::trackedFree(p, static_cast<std::size_t>(al));
+}
+void operator delete[](void* p, std::size_t, std::align_val_t al) noexcept {
+    sobel::trackedFree(p, static_cast<std::size_t>(al));
+}
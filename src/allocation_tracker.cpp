@@ -0,0 +1,141 @@
+/**
+ * @file allocation_tracker.cpp
+ * @brief Per-stage allocation recorder (the counting operator new/delete are in allocation_hooks.cpp)
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "allocation_tracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace sobel {
+
+namespace {
+
+std::atomic<uint64_t> liveBytes{0};
+std::atomic<bool> hooksInstalled{false};
+thread_local AllocationRecorder* activeRecorder = nullptr;
+thread_local int activeStage = -1;
+thread_local bool sharedRecorder = false;   // activeRecorder is shared by fork-join workers
+std::mutex sharedRecorderMutex;
+
+} // namespace
+
+bool allocationTrackingEnabled() {
+    return hooksInstalled.load(std::memory_order_relaxed);
+}
+
+uint64_t heapLiveBytes() {
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+void markAllocationHooksInstalled() noexcept {
+    hooksInstalled.store(true, std::memory_order_relaxed);
+}
+
+void recordHeapAllocation(std::size_t bytes) noexcept {
+    liveBytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (!activeRecorder) return;
+    if (sharedRecorder) {
+        std::lock_guard<std::mutex> lock(sharedRecorderMutex);
+        activeRecorder->onAllocate(bytes, activeStage);
+    } else {
+        activeRecorder->onAllocate(bytes, activeStage);
+    }
+}
+
+void recordHeapFree(std::size_t bytes) noexcept {
+    liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    if (!activeRecorder) return;
+    if (sharedRecorder) {
+        std::lock_guard<std::mutex> lock(sharedRecorderMutex);
+        activeRecorder->onFree(bytes);
+    } else {
+        activeRecorder->onFree(bytes);
+    }
+}
+
+AllocationContext currentAllocationContext() noexcept {
+    return {activeRecorder, activeStage};
+}
+
+ScopedAllocationContext::ScopedAllocationContext(const AllocationContext& context) noexcept
+    : previous_{activeRecorder, activeStage}, previousShared_(sharedRecorder) {
+    activeRecorder = context.recorder;
+    activeStage = context.stage;
+    sharedRecorder = context.recorder != nullptr;
+}
+
+ScopedAllocationContext::~ScopedAllocationContext() {
+    activeRecorder = previous_.recorder;
+    activeStage = previous_.stage;
+    sharedRecorder = previousShared_;
+}
+
+AllocationRecorder::~AllocationRecorder() {
+    end();
+}
+
+AllocationRecorder::AllocationRecorder(AllocationRecorder&& other) noexcept
+    : stages_(other.stages_), total_(other.total_), liveBytes_(other.liveBytes_) {
+    other.end();
+}
+
+AllocationRecorder& AllocationRecorder::operator=(AllocationRecorder&& other) noexcept {
+    if (this != &other) {
+        end();
+        other.end();
+        stages_ = other.stages_;
+        total_ = other.total_;
+        liveBytes_ = other.liveBytes_;
+    }
+    return *this;
+}
+
+void AllocationRecorder::begin() {
+    end();
+    stages_ = AllocationStages{};
+    total_ = AllocationStats();
+    liveBytes_ = 0;
+    previous_ = activeRecorder;
+    activeRecorder = this;
+    active_ = true;
+}
+
+void AllocationRecorder::end() {
+    if (!active_) return;
+    // Recorders nest like scopes; restore the one that was active at begin()
+    if (activeRecorder == this) activeRecorder = previous_;
+    active_ = false;
+}
+
+void AllocationRecorder::onAllocate(std::size_t bytes, int stage) {
+    liveBytes_ += static_cast<int64_t>(bytes);
+    const uint64_t live = liveBytes_ > 0 ? static_cast<uint64_t>(liveBytes_) : 0;
+    ++total_.count;
+    total_.bytes += bytes;
+    total_.peakLiveBytes = std::max(total_.peakLiveBytes, live);
+    if (stage >= 0 && static_cast<std::size_t>(stage) < stages_.size()) {
+        AllocationStats& s = stages_[static_cast<std::size_t>(stage)];
+        ++s.count;
+        s.bytes += bytes;
+        s.peakLiveBytes = std::max(s.peakLiveBytes, live);
+    }
+}
+
+void AllocationRecorder::onFree(std::size_t bytes) {
+    liveBytes_ -= static_cast<int64_t>(bytes);
+}
+
+ScopedAllocationStage::ScopedAllocationStage(PipelineStage stage) : previous_(activeStage) {
+    activeStage = static_cast<int>(stage);
+}
+
+ScopedAllocationStage::~ScopedAllocationStage() {
+    activeStage = previous_;
+}
+
+} // namespace sobel
@@ -0,0 +1,198 @@
+/**
+ * @file autotuner.cpp
+ * @brief Implementation of the autotuner and wisdom file
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "autotuner.hpp"
+#include "sobel_filter_simd.hpp"
+#include "parallel_for.hpp"
+#include "tsv_records.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+
+namespace sobel {
+
+namespace {
+
+struct ProcessWisdom {
+    std::mutex mutex;
+    bool loaded = false;
+    std::string cpu;
+    std::vector<WisdomEntry> entries;
+};
+
+ProcessWisdom& processWisdom() {
+    static ProcessWisdom instance;
+    return instance;
+}
+
+// Load without throwing: AUTO filters must work with a missing or damaged file
+std::vector<WisdomEntry> loadWisdomQuietly(const std::string& path) {
+    try {
+        return loadWisdom(path);
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+bool parseSimdLevel(const std::string& name, SimdLevel& level) {
+    for (SimdLevel candidate : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+        if (name == simdLevelName(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Gradients, a few hard edges and noise, so every stage does representative work
+RGBImage createTuningFrame(std::size_t width, std::size_t height) {
+    RGBImage image(width, height);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> noise(-12, 12);
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            const int base = static_cast<int>((x * 255) / width + ((y / 32 + x / 32) % 2) * 64);
+            auto channel = [&](int offset) {
+                return static_cast<uint8_t>(std::clamp(base + offset + noise(rng), 0, 255));
+            };
+            image.at(x, y) = RGBPixel(channel(0), channel(-20), channel(20));
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE:  return "SSE4.1";
+        default: return "Scalar";
+    }
+}
+
+bool isSimdLevelUsable(SimdLevel level) {
+    return isSimdLevelCompiled(level) && static_cast<int>(level) <= static_cast<int>(detectSimdLevel());
+}
+
+std::string defaultWisdomPath() {
+    const char* path = std::getenv("SOBEL_WISDOM");
+    return path && *path ? path : "sobel_wisdom.tsv";
+}
+
+// Wisdom format: one tab-separated line per entry,
+// cpu, width, height, level, band height, threads, median ns
+std::vector<WisdomEntry> loadWisdom(const std::string& path) {
+    std::vector<WisdomEntry> entries;
+    readTsvRecords(path, 7, [&](const std::vector<std::string>& fields) {
+        WisdomEntry entry;
+        entry.cpu = fields[0];
+        if (!parseSimdLevel(fields[3], entry.parameters.level)) throw TsvFieldError("unknown level " + fields[3]);
+        entry.width = std::stoul(fields[1]);
+        entry.height = std::stoul(fields[2]);
+        entry.parameters.band_height = std::stoul(fields[4]);
+        entry.parameters.threads = static_cast<unsigned>(std::stoul(fields[5]));
+        entry.medianNs = std::stod(fields[6]);
+        entries.push_back(std::move(entry));
+    });
+    return entries;
+}
+
+void saveWisdom(const std::string& path, const WisdomEntry& entry) {
+    std::vector<WisdomEntry> entries = loadWisdom(path);
+    upsertRecord(entries, entry, [](const WisdomEntry& a, const WisdomEntry& b) {
+        return a.cpu == b.cpu && a.width == b.width && a.height == b.height;
+    });
+    writeTsvRecords(path, "wisdom", {"cpu", "width", "height", "level", "band_height", "threads", "median_ns"},
+                    entries.size(), [&](std::ostream& out, std::size_t i) {
+                        const WisdomEntry& e = entries[i];
+                        out << e.cpu << '\t' << e.width << '\t' << e.height << '\t' << simdLevelName(e.parameters.level)
+                            << '\t' << e.parameters.band_height << '\t' << e.parameters.threads << '\t' << e.medianNs;
+                    });
+}
+
+std::optional<TuningParameters> findWisdom(const std::vector<WisdomEntry>& wisdom, const std::string& cpu,
+                                           std::size_t width, std::size_t height) {
+    for (const auto& entry : wisdom) {
+        if (entry.cpu == cpu && entry.width == width && entry.height == height) return entry.parameters;
+    }
+    return std::nullopt;
+}
+
+std::optional<TuningParameters> lookupWisdom(std::size_t width, std::size_t height) {
+    ProcessWisdom& wisdom = processWisdom();
+    std::lock_guard<std::mutex> lock(wisdom.mutex);
+    if (!wisdom.loaded) {
+        wisdom.entries = loadWisdomQuietly(defaultWisdomPath());
+        wisdom.cpu = cpuModelName();
+        wisdom.loaded = true;
+    }
+    std::optional<TuningParameters> found = findWisdom(wisdom.entries, wisdom.cpu, width, height);
+    if (found && !isSimdLevelUsable(found->level)) return std::nullopt;
+    return found;
+}
+
+std::size_t reloadWisdom(const std::string& path) {
+    ProcessWisdom& wisdom = processWisdom();
+    std::vector<WisdomEntry> entries = loadWisdomQuietly(path);
+    std::lock_guard<std::mutex> lock(wisdom.mutex);
+    wisdom.entries = std::move(entries);
+    if (wisdom.cpu.empty()) wisdom.cpu = cpuModelName();
+    wisdom.loaded = true;
+    return wisdom.entries.size();
+}
+
+AutotuneResult autotune(std::size_t width, std::size_t height, const SobelConfig& config,
+                        const AutotuneOptions& options) {
+    if (width == 0 || height == 0) throw std::invalid_argument("Autotune resolution must be non-empty");
+
+    std::vector<SimdLevel> levels = options.levels;
+    if (levels.empty()) {
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (isSimdLevelUsable(level)) levels.push_back(level);
+        }
+    }
+    std::vector<unsigned> threadCounts = options.thread_counts;
+    if (threadCounts.empty()) {
+        const unsigned hardware = resolveThreadCount(0);
+        for (unsigned t = 1; t < hardware; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(hardware);
+    }
+    std::vector<std::size_t> bandHeights = options.band_heights;
+    if (bandHeights.empty()) bandHeights = {16, 64, 256, 0};
+
+    std::vector<TuningParameters> candidates;
+    for (SimdLevel level : levels) {
+        for (unsigned threads : threadCounts) {
+            if (resolveThreadCount(threads) == 1) {
+                candidates.push_back({level, 0, 1});
+                continue;
+            }
+            for (std::size_t band : bandHeights) candidates.push_back({level, band, threads});
+        }
+    }
+
+    const RGBImage frame = createTuningFrame(width, height);
+    GrayscaleImage output;
+    AutotuneResult result;
+    for (const TuningParameters& parameters : candidates) {
+        SobelFilterSIMD filter(config);
+        filter.setTuning(parameters);
+        TuningCandidate candidate{parameters, runBenchmark([&] { filter.apply(frame, output); }, options.bench)};
+        if (result.candidates.empty() || candidate.stats.median < result.bestMedianNs) {
+            result.best = parameters;
+            result.bestMedianNs = candidate.stats.median;
+        }
+        result.candidates.push_back(std::move(candidate));
+    }
+    return result;
+}
+
+} // namespace sobel
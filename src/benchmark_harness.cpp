@@ -0,0 +1,349 @@
+/**
+ * @file benchmark_harness.cpp
+ * @brief Implementation of the benchmark harness
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "benchmark_harness.hpp"
+#include "tsv_records.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <intrin.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace sobel {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const double rank = p * static_cast<double>(sorted.size() - 1);
+    const std::size_t lower = static_cast<std::size_t>(rank);
+    const std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - static_cast<double>(lower));
+}
+
+double timeOnce(const std::function<void()>& body) {
+    const auto start = Clock::now();
+    body();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+std::string readFirstLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    if (file) std::getline(file, line);
+    return line;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+BenchmarkStats computeStats(std::vector<double> samples) {
+    BenchmarkStats stats;
+    stats.iterations = samples.size();
+    if (samples.empty()) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.median = percentile(samples, 0.5);
+    stats.p90 = percentile(samples, 0.9);
+    stats.p99 = percentile(samples, 0.99);
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    if (samples.size() > 1) {
+        double squares = 0.0;
+        for (double s : samples) squares += (s - stats.mean) * (s - stats.mean);
+        stats.stddev = std::sqrt(squares / static_cast<double>(samples.size() - 1));
+    }
+    stats.samples = std::move(samples);
+    return stats;
+}
+
+BenchmarkStats runBenchmark(const std::function<void()>& body, const BenchmarkOptions& options) {
+    if (options.pin_cpu >= 0) pinCurrentThread(options.pin_cpu);
+
+    // Warm-up doubles as clock ramp-up: keep the core busy before sampling
+    std::vector<double> warmup;
+    const auto warmupEnd = Clock::now() + options.warmup_time;
+    do {
+        warmup.push_back(timeOnce(body));
+    } while (Clock::now() < warmupEnd || warmup.size() < 3);
+
+    std::size_t iterations = options.iterations;
+    if (iterations == 0) {
+        std::nth_element(warmup.begin(), warmup.begin() + warmup.size() / 2, warmup.end());
+        const double estimate = std::max(warmup[warmup.size() / 2], 1.0);
+        const double target = std::chrono::duration<double, std::nano>(options.target_time).count();
+        iterations = static_cast<std::size_t>(std::ceil(target / estimate));
+        iterations = std::clamp(iterations, options.min_iterations, options.max_iterations);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (std::size_t i = 0; i < iterations; ++i) samples.push_back(timeOnce(body));
+    return computeStats(std::move(samples));
+}
+
+bool pinCurrentThread(int cpu) {
+    if (cpu < 0) return false;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    return cpu < 64 && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    return false;
+#endif
+}
+
+std::string cpuModelName() {
+    char brand[49] = {0};
+#if defined(_MSC_VER)
+    int info[4] = {0};
+    __cpuid(info, 0x80000000);
+    if (static_cast<unsigned>(info[0]) >= 0x80000004u) {
+        for (int i = 0; i < 3; ++i) {
+            __cpuid(info, 0x80000002 + i);
+            std::memcpy(brand + 16 * i, info, 16);
+        }
+    }
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    unsigned info[4] = {0};
+    if (__get_cpuid_max(0x80000000u, nullptr) >= 0x80000004u) {
+        for (unsigned i = 0; i < 3; ++i) {
+            __get_cpuid(0x80000002u + i, &info[0], &info[1], &info[2], &info[3]);
+            std::memcpy(brand + 16 * i, info, 16);
+        }
+    }
+#endif
+    std::string name(brand);
+    const auto first = name.find_first_not_of(' ');
+    if (first == std::string::npos) return "unknown";
+    name = name.substr(first, name.find_last_not_of(' ') - first + 1);
+    return name;
+}
+
+const char* CacheHierarchy::levelFor(std::size_t bytes) const {
+    if (l1d && bytes <= l1d) return "L1";
+    if (l2 && bytes <= l2) return "L2";
+    if (llc && bytes <= llc) return "LLC";
+    return l1d || l2 || llc ? "DRAM" : "unknown";
+}
+
+CacheHierarchy detectCacheHierarchy() {
+    CacheHierarchy caches;
+#if defined(__linux__)
+    for (int index = 0; index < 8; ++index) {
+        const std::string base = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        const std::string level = readFirstLine(base + "level");
+        const std::string type = readFirstLine(base + "type");
+        const std::string size = readFirstLine(base + "size");
+        if (level.empty() || size.empty() || type == "Instruction") continue;
+
+        // Sizes look like "48K" or "30M"
+        std::size_t bytes = std::stoul(size);
+        if (size.back() == 'K') bytes <<= 10;
+        else if (size.back() == 'M') bytes <<= 20;
+        if (level == "1") caches.l1d = bytes;
+        else if (level == "2") caches.l2 = bytes;
+        else caches.llc = std::max(caches.llc, bytes);
+    }
+#elif defined(_WIN32)
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length)) {
+        for (const auto& entry : info) {
+            if (entry.Relationship != RelationCache || entry.Cache.Type == CacheInstruction) continue;
+            if (entry.Cache.Level == 1) caches.l1d = entry.Cache.Size;
+            else if (entry.Cache.Level == 2) caches.l2 = entry.Cache.Size;
+            else caches.llc = std::max<std::size_t>(caches.llc, entry.Cache.Size);
+        }
+    }
+#endif
+    return caches;
+}
+
+std::string frequencyScalingInfo(int cpu) {
+#if defined(__linux__)
+    const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(std::max(cpu, 0)) + "/cpufreq/";
+    std::string governor = readFirstLine(base + "scaling_governor");
+    std::string turbo = "unknown";
+    const std::string noTurbo = readFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+    const std::string boost = readFirstLine("/sys/devices/system/cpu/cpufreq/boost");
+    if (!noTurbo.empty()) turbo = noTurbo == "1" ? "off" : "on";
+    else if (!boost.empty()) turbo = boost == "1" ? "on" : "off";
+
+    std::ostringstream info;
+    info << "governor=" << (governor.empty() ? "unknown" : governor) << ", turbo=" << turbo;
+    if (!governor.empty() && governor != "performance") info << " (set the performance governor for stable numbers)";
+    return info.str();
+#else
+    (void)cpu;
+    return "unknown";
+#endif
+}
+
+std::string baselineKey(const std::string& cpu, const BenchmarkRecord& record) {
+    return cpu + " | " + record.name + " | " + record.implementation + " | " + std::to_string(record.kernelSize) +
+           "x" + std::to_string(record.kernelSize) + " | " + std::to_string(record.width) + "x" +
+           std::to_string(record.height);
+}
+
+// Baseline format: one tab-separated line per record,
+// cpu, name, implementation, kernel, width, height, then raw samples in ns
+std::vector<BaselineEntry> loadBaseline(const std::string& path) {
+    std::vector<BaselineEntry> entries;
+    readTsvRecords(path, 7, [&](const std::vector<std::string>& fields) {
+        BaselineEntry entry;
+        entry.cpu = fields[0];
+        entry.record.name = fields[1];
+        entry.record.implementation = fields[2];
+        entry.record.kernelSize = std::stoi(fields[3]);
+        entry.record.width = std::stoul(fields[4]);
+        entry.record.height = std::stoul(fields[5]);
+        std::vector<double> samples;
+        std::istringstream values(fields[6]);
+        double value;
+        while (values >> value) samples.push_back(value);
+        entry.record.stats = computeStats(std::move(samples));
+        entries.push_back(std::move(entry));
+    });
+    return entries;
+}
+
+void saveBaseline(const std::string& path, const std::string& cpu, const std::vector<BenchmarkRecord>& records) {
+    std::vector<BaselineEntry> entries = loadBaseline(path);
+    for (const auto& record : records) {
+        upsertRecord(entries, BaselineEntry{cpu, record}, [](const BaselineEntry& a, const BaselineEntry& b) {
+            return baselineKey(a.cpu, a.record) == baselineKey(b.cpu, b.record);
+        });
+    }
+    writeTsvRecords(path, "baseline", {"cpu", "name", "implementation", "kernel", "width", "height", "samples_ns"},
+                    entries.size(), [&](std::ostream& out, std::size_t i) {
+                        const BenchmarkRecord& r = entries[i].record;
+                        out << entries[i].cpu << '\t' << r.name << '\t' << r.implementation << '\t' << r.kernelSize
+                            << '\t' << r.width << '\t' << r.height << '\t';
+                        for (std::size_t s = 0; s < r.stats.samples.size(); ++s) out << (s ? " " : "") << r.stats.samples[s];
+                    });
+}
+
+double mannWhitneySlowerPValue(const std::vector<double>& baseline, const std::vector<double>& current) {
+    const std::size_t n1 = current.size();
+    const std::size_t n2 = baseline.size();
+    if (n1 == 0 || n2 == 0) return 1.0;
+
+    // Rank the pooled samples, averaging ranks over ties
+    std::vector<std::pair<double, bool>> pooled;   // value, from current
+    pooled.reserve(n1 + n2);
+    for (double v : current) pooled.emplace_back(v, true);
+    for (double v : baseline) pooled.emplace_back(v, false);
+    std::sort(pooled.begin(), pooled.end());
+
+    const double n = static_cast<double>(n1 + n2);
+    double rankSumCurrent = 0.0;
+    double tieTerm = 0.0;
+    for (std::size_t i = 0; i < pooled.size();) {
+        std::size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) ++j;
+        const double averageRank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+        const double ties = static_cast<double>(j - i);
+        tieTerm += ties * ties * ties - ties;
+        for (std::size_t k = i; k < j; ++k) {
+            if (pooled[k].second) rankSumCurrent += averageRank;
+        }
+        i = j;
+    }
+
+    const double u = rankSumCurrent - static_cast<double>(n1) * static_cast<double>(n1 + 1) / 2.0;
+    const double mean = static_cast<double>(n1) * static_cast<double>(n2) / 2.0;
+    const double variance = static_cast<double>(n1) * static_cast<double>(n2) / 12.0 *
+                            ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+    if (variance <= 0.0) return 1.0;
+    const double z = (u - mean - 0.5) / std::sqrt(variance);   // continuity correction
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+std::vector<RegressionCheck> compareToBaseline(const std::vector<BaselineEntry>& baseline, const std::string& cpu,
+                                               const std::vector<BenchmarkRecord>& records,
+                                               double threshold, double alpha) {
+    std::vector<RegressionCheck> checks;
+    for (const auto& record : records) {
+        RegressionCheck check;
+        check.key = baselineKey(cpu, record);
+        check.currentMedian = record.stats.median;
+        auto entry = std::find_if(baseline.begin(), baseline.end(), [&](const BaselineEntry& candidate) {
+            return baselineKey(candidate.cpu, candidate.record) == check.key;
+        });
+        if (entry != baseline.end() && entry->record.stats.median > 0.0) {
+            check.hasBaseline = true;
+            check.baselineMedian = entry->record.stats.median;
+            check.change = check.currentMedian / check.baselineMedian - 1.0;
+            check.pValue = mannWhitneySlowerPValue(entry->record.stats.samples, record.stats.samples);
+            check.regressed = check.change > threshold && check.pValue < alpha;
+        }
+        checks.push_back(std::move(check));
+    }
+    return checks;
+}
+
+void writeBenchmarkJson(std::ostream& out, const std::vector<BenchmarkRecord>& records) {
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n  \"cpu\": \"" << jsonEscape(cpuModelName()) << "\",\n  \"results\": [";
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        const auto& r = records[i];
+        out << (i ? "," : "") << "\n    {\"name\": \"" << jsonEscape(r.name) << "\", \"implementation\": \""
+            << jsonEscape(r.implementation) << "\", \"kernel_size\": " << r.kernelSize
+            << ", \"width\": " << r.width << ", \"height\": " << r.height
+            << ", \"iterations\": " << r.stats.iterations
+            << ", \"min_ms\": " << r.stats.min / 1e6 << ", \"median_ms\": " << r.stats.median / 1e6
+            << ", \"p90_ms\": " << r.stats.p90 / 1e6 << ", \"p99_ms\": " << r.stats.p99 / 1e6
+            << ", \"max_ms\": " << r.stats.max / 1e6 << ", \"mean_ms\": " << r.stats.mean / 1e6
+            << ", \"stddev_ms\": " << r.stats.stddev / 1e6
+            << ", \"pixels_per_second\": " << r.pixelsPerSecond() << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void writeBenchmarkCsv(std::ostream& out, const std::vector<BenchmarkRecord>& records) {
+    out << std::setprecision(6) << std::fixed;
+    out << "name,implementation,kernel_size,width,height,iterations,min_ms,median_ms,p90_ms,p99_ms,max_ms,"
+           "mean_ms,stddev_ms,pixels_per_second\n";
+    for (const auto& r : records) {
+        out << r.name << ',' << r.implementation << ',' << r.kernelSize << ',' << r.width << ',' << r.height
+            << ',' << r.stats.iterations << ',' << r.stats.min / 1e6 << ',' << r.stats.median / 1e6
+            << ',' << r.stats.p90 / 1e6 << ',' << r.stats.p99 / 1e6 << ',' << r.stats.max / 1e6
+            << ',' << r.stats.mean / 1e6 << ',' << r.stats.stddev / 1e6 << ',' << r.pixelsPerSecond() << '\n';
+    }
+}
+
+} // namespace sobel
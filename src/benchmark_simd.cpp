@@ -1,152 +1,596 @@
 #include "sobel_filter_simd.hpp"
 #include "sobel_filter.hpp"
 #include "image.hpp"
+#include "benchmark_harness.hpp"
+#include "perf_counters.hpp"
+#include "stage_timer.hpp"
+#include "tracer.hpp"
+#include "allocation_tracker.hpp"
+#include "autotuner.hpp"
+#include "adaptive_quality.hpp"
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <sstream>
 #include <iostream>
+#include <fstream>
 #include <chrono>
 #include <iomanip>
-
-using namespace sobel;
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace sobel;
 
+struct CommandLine {
+    BenchmarkOptions bench;
+    std::string jsonPath;
+    std::string csvPath;
+    int kernelSize = 5;
+    size_t width = 640;
+    size_t height = 640;
+    bool perfCounters = false;
+    std::chrono::nanoseconds deadline = kDefaultFrameDeadline;
+    bool sweep = false;
+    size_t sweepMax = 16384;
+    std::string saveBaselinePath;
+    std::string comparePath;
+    bool tune = false;
+    bool adaptive = false;
+    std::string wisdomPath;
+    double threshold = 0.05;   // Relative median slowdown treated as a regression
+    double alpha = 0.01;       // Significance level of the regression test
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --iterations N   Fixed number of timed iterations (default: auto-calibrated)\n"
+              << "  --min-time MS    Target sampling time per benchmark in ms (default: 1000)\n"
+              << "  --warmup MS      Warm-up time per benchmark in ms (default: 200)\n"
+              << "  --pin CPU        Pin the benchmark thread to CPU\n"
+              << "  --kernel N       Sobel kernel size 3, 5 or 7 (default: 5)\n"
+              << "  --size WxH       Image size (default: 640x640)\n"
+              << "  --json FILE      Also write results as JSON\n"
+              << "  --csv FILE       Also write results as CSV\n"
+              << "  --perf           Collect hardware counters (Linux perf_event_open)\n"
+              << "  --deadline MS    Per-frame latency budget for deadline misses (default: 16.67)\n"
+              << "  --adaptive       Also run an adaptive-quality filter with --deadline as its budget\n"
+              << "  --trace FILE     Record pipeline spans as Chrome Trace Event JSON in FILE\n"
+              << "  --sweep          Sweep image sizes from 64x64 up to --sweep-max\n"
+              << "  --sweep-max N    Largest image side in the sweep (default: 16384)\n"
+              << "  --save-baseline FILE  Store results in FILE, keyed by CPU model and implementation\n"
+              << "  --compare FILE   Compare against FILE; exit 2 on a significant regression\n"
+              << "  --tune           Time level/band/thread candidates at --size and store the winner\n"
+              << "  --wisdom FILE    Wisdom file written by --tune (default: $SOBEL_WISDOM or sobel_wisdom.tsv)\n"
+              << "  --threshold PCT  Median slowdown counted as a regression (default: 5)\n"
+              << "  --alpha P        Significance level of the Mann-Whitney test (default: 0.01)\n";
+}
+
+bool parseCommandLine(int argc, char* argv[], CommandLine& cli) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--iterations") cli.bench.iterations = std::stoul(value());
+        else if (arg == "--min-time") cli.bench.target_time = std::chrono::milliseconds(std::stol(value()));
+        else if (arg == "--warmup") cli.bench.warmup_time = std::chrono::milliseconds(std::stol(value()));
+        else if (arg == "--pin") cli.bench.pin_cpu = std::stoi(value());
+        else if (arg == "--kernel") cli.kernelSize = std::stoi(value());
+        else if (arg == "--json") cli.jsonPath = value();
+        else if (arg == "--csv") cli.csvPath = value();
+        else if (arg == "--perf") cli.perfCounters = true;
+        else if (arg == "--deadline") {
+            cli.deadline = std::chrono::nanoseconds(static_cast<int64_t>(std::stod(value()) * 1e6));
+        }
+        else if (arg == "--adaptive") cli.adaptive = true;
+        else if (arg == "--trace") Tracer::enable(value());
+        else if (arg == "--sweep") cli.sweep = true;
+        else if (arg == "--sweep-max") cli.sweepMax = std::stoul(value());
+        else if (arg == "--save-baseline") cli.saveBaselinePath = value();
+        else if (arg == "--compare") cli.comparePath = value();
+        else if (arg == "--tune") cli.tune = true;
+        else if (arg == "--wisdom") cli.wisdomPath = value();
+        else if (arg == "--threshold") cli.threshold = std::stod(value()) / 100.0;
+        else if (arg == "--alpha") cli.alpha = std::stod(value());
+        else if (arg == "--size") {
+            std::string size = value();
+            size_t separator = size.find('x');
+            if (separator == std::string::npos) throw std::invalid_argument("Size must be WxH");
+            cli.width = std::stoul(size.substr(0, separator));
+            cli.height = std::stoul(size.substr(separator + 1));
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return false;
+        } else {
+            throw std::invalid_argument("Unknown option " + arg);
+        }
+    }
+    return true;
+}
+
 // Function to create a test image with gradient patterns
-RGBImage createTestImage() {
-    RGBImage image(640, 640);
-    
-    for (size_t y = 0; y < 640; ++y) {
-        for (size_t x = 0; x < 640; ++x) {
+RGBImage createTestImage(size_t width, size_t height) {
+    RGBImage image(width, height);
+
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
             // Create a gradient pattern with some edges
-            uint8_t r = static_cast<uint8_t>((x * 255) / 640);
-            uint8_t g = static_cast<uint8_t>((y * 255) / 640);
-            uint8_t b = static_cast<uint8_t>(((x + y) * 255) / 1280);
-            
+            uint8_t r = static_cast<uint8_t>((x * 255) / width);
+            uint8_t g = static_cast<uint8_t>((y * 255) / height);
+            uint8_t b = static_cast<uint8_t>(((x + y) * 255) / (width + height));
+
             // Add some sharp edges every 100 pixels
             if (x % 100 == 0 || y % 100 == 0) {
                 r = g = b = 255;
             }
-            
+
             image.setPixel(x, y, RGBPixel(r, g, b));
         }
     }
-    
+
     return image;
 }
 
-void runBenchmark() {
-    std::cout << "=== 5x5 Sobel Filter SIMD Benchmark ===" << std::endl;
-    std::cout << "Image Size: 640x640 RGB" << std::endl;
-    std::cout << "Filter: 5x5 Sobel edge detection" << std::endl << std::endl;
-    
-    // Create test image
-    RGBImage testImage = createTestImage();
-    
+void printTableHeader() {
+    std::cout << std::left << std::setw(12) << "Impl" << std::right
+              << std::setw(10) << "min ms" << std::setw(10) << "median" << std::setw(10) << "p90"
+              << std::setw(10) << "p99" << std::setw(10) << "stddev" << std::setw(8) << "iters"
+              << std::setw(12) << "Mpix/s" << std::setw(12) << "MB/s" << std::endl;
+}
+
+void printTableRow(const BenchmarkRecord& record) {
+    // Bytes actually streamed per frame: RGB input plus 8-bit edge output
+    const double bytesPerSecond = record.pixelsPerSecond() * (sizeof(RGBPixel) + 1);
+    std::cout << std::left << std::setw(12) << record.implementation << std::right << std::fixed
+              << std::setprecision(3)
+              << std::setw(10) << record.stats.min / 1e6 << std::setw(10) << record.stats.median / 1e6
+              << std::setw(10) << record.stats.p90 / 1e6 << std::setw(10) << record.stats.p99 / 1e6
+              << std::setw(10) << record.stats.stddev / 1e6 << std::setw(8) << record.stats.iterations
+              << std::setprecision(1) << std::setw(12) << record.pixelsPerSecond() / 1e6
+              << std::setw(12) << bytesPerSecond / (1024.0 * 1024.0) << std::endl;
+}
+
+// Per-stage running statistics collected by the filter over every benchmark call
+std::string formatBytes(size_t bytes) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    if (bytes < (1u << 20)) text << bytes / 1024.0 << " KiB";
+    else if (bytes < (1u << 30)) text << bytes / (1024.0 * 1024.0) << " MiB";
+    else text << bytes / (1024.0 * 1024.0 * 1024.0) << " GiB";
+    return text.str();
+}
+
+// Heap activity per stage; `calls` is the number of frames the counts cover
+void printAllocations(const std::string& implementation, const AllocationStages& stages,
+                      const AllocationStats& total, uint64_t calls) {
+    std::cout << implementation << ": " << total.count << " allocations, " << formatBytes(total.bytes)
+              << " over " << calls << " calls, peak live " << formatBytes(total.peakLiveBytes) << std::endl;
+    for (size_t i = 0; i < kPipelineStageCount; ++i) {
+        const AllocationStats& stage = stages[i];
+        if (stage.count == 0) continue;
+        std::cout << "  " << std::left << std::setw(18) << stageName(static_cast<PipelineStage>(i)) << std::right
+                  << " allocs " << std::setw(6) << stage.count
+                  << "  bytes " << std::setw(11) << formatBytes(stage.bytes)
+                  << "  peak live " << std::setw(11) << formatBytes(stage.peakLiveBytes) << std::endl;
+    }
+}
+
+void printStageBreakdown(const std::string& implementation, const SobelFilterSIMD::PerformanceMetrics& metrics) {
+#if SOBEL_STAGE_TIMERS
+    double totalMean = 0.0;
+    for (const auto& stage : metrics.stages) totalMean += stage.meanUs();
+    std::cout << implementation << ":" << std::endl;
+    for (size_t i = 0; i < kPipelineStageCount; ++i) {
+        const StageTiming& stage = metrics.stages[i];
+        if (stage.calls == 0) continue;
+        std::cout << "  " << std::left << std::setw(18) << stageName(static_cast<PipelineStage>(i)) << std::right
+                  << std::fixed << std::setprecision(1)
+                  << " mean " << std::setw(8) << stage.meanUs() << " us"
+                  << "  min " << std::setw(8) << stage.minUs << " us"
+                  << "  max " << std::setw(8) << stage.maxUs << " us"
+                  << "  " << std::setw(5) << (totalMean > 0.0 ? 100.0 * stage.meanUs() / totalMean : 0.0) << "%"
+                  << std::endl;
+    }
+#else
+    (void)metrics;
+    std::cout << implementation << ": stage timers compiled out (configure with -DSOBEL_STAGE_TIMERS=ON)" << std::endl;
+#endif
+}
+
+// Tail latency of every call the filter saw, including warm-up and calibration
+void printLatencySummary(const std::string& implementation, const LatencySummary& latency) {
+    std::cout << std::left << std::setw(10) << implementation << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << latency.frames
+              << std::setw(11) << latency.p50Us
+              << std::setw(11) << latency.p99Us
+              << std::setw(11) << latency.p999Us
+              << std::setw(11) << latency.maxUs
+              << std::setw(11) << latency.jitterUs
+              << std::setw(9) << latency.deadlineMisses
+              << " (" << std::setprecision(3) << (latency.frames ? 100.0 * latency.deadlineMisses / latency.frames : 0.0)
+              << "%)" << std::endl;
+}
+
+// Counter values per frame over a fixed number of frames
+PerfSample countPerFrame(PerfCounters& counters, const std::function<void()>& body, size_t frames) {
+    counters.start();
+    for (size_t i = 0; i < frames; ++i) body();
+    PerfSample sample = counters.stop();
+    for (double& value : sample.values) value /= static_cast<double>(frames);
+    return sample;
+}
+
+void printCounterHeader() {
+    std::cout << std::left << std::setw(12) << "Impl" << std::right
+              << std::setw(14) << "cycles" << std::setw(14) << "instructions" << std::setw(7) << "IPC"
+              << std::setw(12) << "L1D miss" << std::setw(12) << "LLC miss" << std::setw(12) << "br miss"
+              << std::setw(10) << "cyc/px" << std::endl;
+}
+
+void printCounterRow(const std::string& implementation, const PerfSample& sample, size_t pixels) {
+    auto cell = [&](PerfEvent event, int width) {
+        if (sample.has(event)) std::cout << std::setw(width) << std::setprecision(0) << sample[event];
+        else std::cout << std::setw(width) << "n/a";
+    };
+    std::cout << std::left << std::setw(12) << implementation << std::right << std::fixed;
+    cell(PerfEvent::Cycles, 14);
+    cell(PerfEvent::Instructions, 14);
+    if (sample.ipc() > 0.0) std::cout << std::setw(7) << std::setprecision(2) << sample.ipc();
+    else std::cout << std::setw(7) << "n/a";
+    cell(PerfEvent::L1DMisses, 12);
+    cell(PerfEvent::LLCMisses, 12);
+    cell(PerfEvent::BranchMisses, 12);
+    if (sample.has(PerfEvent::Cycles)) {
+        std::cout << std::setw(10) << std::setprecision(2) << sample[PerfEvent::Cycles] / static_cast<double>(pixels);
+    } else {
+        std::cout << std::setw(10) << "n/a";
+    }
+    std::cout << std::endl;
+}
+
+void printEdgeStatistics(const GrayscaleImage& output) {
+    size_t edgePixels = 0;
+    uint64_t intensitySum = 0;
+    uint8_t minIntensity = 255, maxIntensity = 0;
+    for (size_t i = 0; i < output.size(); ++i) {
+        uint8_t pixel = output.data()[i];
+        if (pixel > 30) edgePixels++; // Threshold for edge detection
+        intensitySum += pixel;
+        minIntensity = std::min(minIntensity, pixel);
+        maxIntensity = std::max(maxIntensity, pixel);
+    }
+
+    std::cout << "Edge pixels (>30): " << std::fixed << std::setprecision(2)
+              << (100.0 * edgePixels) / output.size() << "%, mean intensity "
+              << static_cast<double>(intensitySum) / output.size()
+              << ", range " << static_cast<int>(minIntensity) << " - " << static_cast<int>(maxIntensity) << std::endl;
+}
+
+std::vector<BenchmarkRecord> runBenchmarkSuite(const CommandLine& cli) {
+    std::cout << "=== " << cli.kernelSize << "x" << cli.kernelSize << " Sobel Filter SIMD Benchmark ===" << std::endl;
+    std::cout << "Image Size: " << cli.width << "x" << cli.height << " RGB" << std::endl;
+    std::cout << "CPU: " << cpuModelName() << std::endl;
+    std::cout << "Frequency scaling: " << frequencyScalingInfo(std::max(cli.bench.pin_cpu, 0)) << std::endl;
+    if (cli.bench.pin_cpu >= 0) {
+        std::cout << "Pinned to CPU " << cli.bench.pin_cpu << ": "
+                  << (pinCurrentThread(cli.bench.pin_cpu) ? "yes" : "failed") << std::endl;
+    }
+    std::cout << std::endl;
+
+    RGBImage testImage = createTestImage(cli.width, cli.height);
+    SobelConfig config;
+    config.kernel_size = cli.kernelSize;
+
     // Test different optimization levels
     std::vector<SobelFilterSIMD::OptimizationLevel> levels = {
         SobelFilterSIMD::OptimizationLevel::SCALAR,
         SobelFilterSIMD::OptimizationLevel::SSE,
         SobelFilterSIMD::OptimizationLevel::AVX2
     };
-    
     std::vector<std::string> levelNames = {"Scalar", "SSE4.1", "AVX2"};
-    
-    GrayscaleImage output(640, 640);
-    
+
+    std::vector<BenchmarkRecord> records;
+    std::vector<SobelFilterSIMD::PerformanceMetrics> stageMetrics;
+    std::vector<LatencySummary> latencies;
+    std::vector<std::pair<std::string, PerfSample>> counterSamples;
+    std::unique_ptr<PerfCounters> counters;
+    if (cli.perfCounters) counters = std::make_unique<PerfCounters>();
+    const bool counting = counters && counters->available();
+    // Counted separately from the timed samples so counter setup never skews the timings
+    const size_t countedFrames = 20;
+    GrayscaleImage output;
+    printTableHeader();
     for (size_t i = 0; i < levels.size(); ++i) {
-        SobelFilterSIMD filter(levels[i]);
-        
-        std::cout << "Testing " << levelNames[i] << " optimization:" << std::endl;
-        std::cout << "CPU Capabilities: " << filter.getCPUCapabilities() << std::endl;
-        
-        // Warm-up run
-        filter.apply(testImage, output, false);
-        
-        // Timed runs
-        const int numRuns = 10;
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
-        for (int run = 0; run < numRuns; ++run) {
-            filter.apply(testImage, output, false);
+        SobelFilterSIMD filter(config, levels[i]);
+        filter.setFrameDeadline(cli.deadline);
+        BenchmarkRecord record;
+        record.name = "simd";
+        record.implementation = levelNames[i];
+        record.kernelSize = cli.kernelSize;
+        record.width = cli.width;
+        record.height = cli.height;
+        auto body = [&]() { filter.apply(testImage, output, false); };
+        record.stats = runBenchmark(body, cli.bench);
+        stageMetrics.push_back(filter.getLastMetrics());
+        latencies.push_back(filter.getLatencySummary());
+        if (counting) counterSamples.emplace_back(levelNames[i], countPerFrame(*counters, body, countedFrames));
+        printTableRow(record);
+        records.push_back(std::move(record));
+    }
+
+    // Compare with baseline implementation
+    SobelFilter baselineFilter(config);
+    BenchmarkRecord baseline;
+    baseline.name = "baseline";
+    baseline.implementation = "Baseline";
+    baseline.kernelSize = cli.kernelSize;
+    baseline.width = cli.width;
+    baseline.height = cli.height;
+    auto baselineBody = [&]() { output = baselineFilter.apply(testImage); };
+    baseline.stats = runBenchmark(baselineBody, cli.bench);
+    if (counting) counterSamples.emplace_back("Baseline", countPerFrame(*counters, baselineBody, countedFrames));
+    AllocationRecorder baselineAllocations;
+    baselineAllocations.begin();
+    baselineBody();
+    baselineAllocations.end();
+    printTableRow(baseline);
+    records.push_back(baseline);
+
+    if (cli.perfCounters) {
+        std::cout << std::endl << "=== Hardware Counters (per frame, user space) ===" << std::endl;
+        if (!counting) {
+            std::cout << "Hardware counters: unavailable (" << counters->unavailableReason() << ")" << std::endl;
+        } else {
+            printCounterHeader();
+            for (const auto& [name, sample] : counterSamples) printCounterRow(name, sample, cli.width * cli.height);
         }
-        
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        auto avgTime = totalTime / numRuns;
-        
-        // Run once with profiling for detailed metrics
-        filter.apply(testImage, output, true);
-        auto metrics = filter.getLastMetrics();
-        
-        std::cout << "  Average processing time: " << std::fixed << std::setprecision(2) 
-                  << avgTime.count() / 1000.0 << " ms" << std::endl;
-        std::cout << "  Pixels per second: " << metrics.pixelsPerSecond << std::endl;
-        std::cout << "  Memory bandwidth: " << std::fixed << std::setprecision(1)
-                  << metrics.memoryBandwidth / (1024.0 * 1024.0) << " MB/s" << std::endl;
-        std::cout << "  Optimization used: " << metrics.optimizationUsed << std::endl;
-        
-        // Calculate edge statistics
-        size_t edgePixels = 0;
-        size_t totalPixels = 640 * 640;
-        uint64_t intensitySum = 0;
-        uint8_t minIntensity = 255, maxIntensity = 0;
-        
-        for (size_t y = 0; y < 640; ++y) {
-            for (size_t x = 0; x < 640; ++x) {
-                uint8_t pixel = output.at(x, y);
-                if (pixel > 30) edgePixels++; // Threshold for edge detection
-                intensitySum += pixel;
-                minIntensity = std::min(minIntensity, pixel);
-                maxIntensity = std::max(maxIntensity, pixel);
-            }
+    }
+
+    std::cout << std::endl << "=== Per-Frame Latency (all calls, us; deadline " << std::fixed << std::setprecision(2)
+              << static_cast<double>(cli.deadline.count()) / 1e6 << " ms) ===" << std::endl;
+    std::cout << std::left << std::setw(10) << "Impl" << std::right << std::setw(9) << "Frames"
+              << std::setw(11) << "p50" << std::setw(11) << "p99" << std::setw(11) << "p99.9"
+              << std::setw(11) << "Max" << std::setw(11) << "Jitter" << std::setw(9) << "Misses" << std::endl;
+    for (size_t i = 0; i < latencies.size(); ++i) printLatencySummary(levelNames[i], latencies[i]);
+
+    if (cli.adaptive) {
+        // Best level, stepping down through the quality tiers whenever frames overrun the budget
+        SobelFilterSIMD adaptiveFilter(config);
+        AdaptiveQualityConfig adaptive;
+        adaptive.enabled = true;
+        adaptive.budget = cli.deadline;
+        adaptiveFilter.setAdaptiveQuality(adaptive);
+        adaptiveFilter.setFrameDeadline(cli.deadline);
+        runBenchmark([&]() { adaptiveFilter.apply(testImage, output, false); }, cli.bench);
+        printLatencySummary("Adaptive", adaptiveFilter.getLatencySummary());
+        const auto& tierFrames = adaptiveFilter.getLastMetrics().tierFrames;
+        std::cout << "Adaptive frames per tier:";
+        for (size_t t = 0; t < kQualityTierCount; ++t) {
+            std::cout << (t ? ", " : " ") << qualityTierName(static_cast<QualityTier>(t)) << " " << tierFrames[t];
         }
-        
-        double edgePercentage = (100.0 * edgePixels) / totalPixels;
-        double meanIntensity = static_cast<double>(intensitySum) / totalPixels;
-        
-        std::cout << "  Edge pixels (>30): " << std::fixed << std::setprecision(2) 
-                  << edgePercentage << "%" << std::endl;
-        std::cout << "  Mean intensity: " << std::fixed << std::setprecision(2) 
-                  << meanIntensity << std::endl;
-        std::cout << "  Intensity range: " << static_cast<int>(minIntensity) 
-                  << " - " << static_cast<int>(maxIntensity) << std::endl;
-        
         std::cout << std::endl;
     }
-    
-    // Compare with baseline implementation
-    std::cout << "=== Baseline Comparison ===" << std::endl;
-    SobelFilter baselineFilter;
-    
-    auto startTime = std::chrono::high_resolution_clock::now();
-    output = baselineFilter.apply(testImage);
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto baselineTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    
-    std::cout << "Baseline (Phase 2) processing time: " << std::fixed << std::setprecision(2)
-              << baselineTime.count() / 1000.0 << " ms" << std::endl;
-    
-    // Calculate speedup ratios
-    SobelFilterSIMD sseFilter(SobelFilterSIMD::OptimizationLevel::SSE);
-    startTime = std::chrono::high_resolution_clock::now();
-    sseFilter.apply(testImage, output, false);
-    endTime = std::chrono::high_resolution_clock::now();
-    auto sseTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    
-    double speedup = static_cast<double>(baselineTime.count()) / sseTime.count();
-    std::cout << "SSE speedup: " << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
-    
+
+    std::cout << std::endl << "=== Per-Stage Timing ===" << std::endl;
+    for (size_t i = 0; i < stageMetrics.size(); ++i) printStageBreakdown(levelNames[i], stageMetrics[i]);
+
+    std::cout << std::endl << "=== Heap Allocations (operator new) ===" << std::endl;
+    if (!allocationTrackingEnabled()) {
+        std::cout << "Allocation hooks not linked (configure with -DSOBEL_ALLOC_TRACKING=ON)" << std::endl;
+    } else {
+        for (size_t i = 0; i < stageMetrics.size(); ++i) {
+            printAllocations(levelNames[i], stageMetrics[i].allocations, stageMetrics[i].allocationTotal,
+                             latencies[i].frames);
+        }
+        printAllocations("Baseline", baselineAllocations.stages(), baselineAllocations.total(), 1);
+    }
+
+    std::cout << std::endl;
+    SobelFilterSIMD bestFilter(config);
+    bestFilter.apply(testImage, output, false);
+    printEdgeStatistics(output);
+
+    const BenchmarkRecord& sse = records[1];
+    std::cout << "SSE speedup over baseline (median): " << std::fixed << std::setprecision(2)
+              << baseline.stats.median / sse.stats.median << "x" << std::endl;
+
     std::cout << std::endl << "=== On-Device AI Performance Characteristics ===" << std::endl;
     std::cout << "- Memory access pattern: Cache-friendly sequential processing" << std::endl;
-    std::cout << "- SIMD utilization: " << sseFilter.getCPUCapabilities() << std::endl;
+    std::cout << "- SIMD utilization: " << bestFilter.getCPUCapabilities() << std::endl;
     std::cout << "- Thread scalability: " << std::thread::hardware_concurrency() << " cores available" << std::endl;
-    std::cout << "- Real-time capability: " << (sseTime.count() < 16667 ? "YES" : "NO") 
-              << " (60 FPS = 16.67ms budget)" << std::endl;
+    const double deadlineNs = static_cast<double>(cli.deadline.count());
+    std::cout << "- Real-time capability: " << (sse.stats.p99 < deadlineNs ? "YES" : "NO")
+              << " (SSE p99 vs " << std::setprecision(2) << deadlineNs / 1e6 << " ms budget, "
+              << latencies[1].deadlineMisses << " of " << latencies[1].frames << " calls missed)" << std::endl;
+
+    return records;
+}
+
+// Bytes touched per frame: RGB input, padded gray plane, float magnitudes and 8-bit output
+size_t workingSetBytes(size_t width, size_t height) {
+    return width * height * (sizeof(RGBPixel) + 1 + sizeof(float) + 1);
+}
+
+// Throughput against working-set size for every level, from L1-resident frames to DRAM
+std::vector<BenchmarkRecord> runSweep(const CommandLine& cli) {
+    const CacheHierarchy caches = detectCacheHierarchy();
+    std::cout << "=== " << cli.kernelSize << "x" << cli.kernelSize << " Sobel Size Sweep ===" << std::endl;
+    std::cout << "CPU: " << cpuModelName() << std::endl;
+    std::cout << "Caches: L1D " << formatBytes(caches.l1d) << ", L2 " << formatBytes(caches.l2)
+              << ", LLC " << formatBytes(caches.llc) << std::endl;
+    std::cout << "Working set per frame ~ " << workingSetBytes(1, 1)
+              << " bytes/pixel (RGB in, gray, float magnitude, edges out)" << std::endl;
+    std::cout << "cyc/px uses the TSC (reference cycles); --perf adds core cycles when available" << std::endl << std::endl;
+
+    // Powers of two plus widths that are not multiples of 32 (vector tails, odd strides)
+    std::vector<std::pair<size_t, size_t>> sizes = {
+        {64, 64}, {100, 75}, {128, 128}, {256, 256}, {333, 250}, {512, 512}, {1000, 750}, {1024, 1024},
+        {1921, 1081}, {2048, 2048}, {3839, 2161}, {4096, 4096}, {7681, 4321}, {8192, 8192}, {16384, 16384}
+    };
+    sizes.erase(std::remove_if(sizes.begin(), sizes.end(), [&](const auto& size) {
+        return std::max(size.first, size.second) > cli.sweepMax;
+    }), sizes.end());
+
+    // Large frames take seconds each: fewer, shorter samples unless the caller fixed them
+    BenchmarkOptions options = cli.bench;
+    options.min_iterations = 5;
+    options.warmup_time = std::min(options.warmup_time, std::chrono::milliseconds(100));
+    options.target_time = std::min(options.target_time, std::chrono::milliseconds(500));
+
+    std::unique_ptr<PerfCounters> counters;
+    if (cli.perfCounters) counters = std::make_unique<PerfCounters>();
+    if (counters && !counters->available()) {
+        std::cout << "Hardware counters: unavailable (" << counters->unavailableReason() << ")" << std::endl << std::endl;
+    }
+
+    std::vector<std::pair<SobelFilterSIMD::OptimizationLevel, std::string>> levels = {
+        {SobelFilterSIMD::OptimizationLevel::SCALAR, "Scalar"},
+        {SobelFilterSIMD::OptimizationLevel::SSE, "SSE4.1"},
+        {SobelFilterSIMD::OptimizationLevel::AVX2, "AVX2"}
+    };
+
+    std::cout << std::left << std::setw(13) << "Size" << std::right << std::setw(12) << "Working set"
+              << std::setw(7) << "Fits";
+    for (const auto& level : levels) std::cout << std::setw(14) << level.second + " Mpx/s" << std::setw(9) << "cyc/px";
+    std::cout << std::endl;
+
+    const double ticksPerNs = timestampTicksPerMicrosecond() / 1000.0;
+    SobelConfig config;
+    config.kernel_size = cli.kernelSize;
+    std::vector<BenchmarkRecord> records;
+    for (const auto& [width, height] : sizes) {
+        const size_t pixels = width * height;
+        const size_t workingSet = workingSetBytes(width, height);
+        std::cout << std::left << std::setw(13) << (std::to_string(width) + "x" + std::to_string(height)) << std::right
+                  << std::setw(12) << formatBytes(workingSet) << std::setw(7) << caches.levelFor(workingSet) << std::flush;
+        try {
+            RGBImage image = createTestImage(width, height);
+            GrayscaleImage output;
+            for (const auto& [level, name] : levels) {
+                SobelFilterSIMD filter(config, level);
+                auto body = [&]() { filter.apply(image, output, false); };
+                BenchmarkRecord record;
+                record.name = "sweep";
+                record.implementation = name;
+                record.kernelSize = cli.kernelSize;
+                record.width = width;
+                record.height = height;
+                record.stats = runBenchmark(body, options);
+
+                double cyclesPerPixel = record.stats.median * ticksPerNs / static_cast<double>(pixels);
+                if (counters && counters->available()) {
+                    const size_t frames = std::clamp<size_t>(size_t(20000000) / pixels, 1, 20);
+                    PerfSample sample = countPerFrame(*counters, body, frames);
+                    if (sample.has(PerfEvent::Cycles)) cyclesPerPixel = sample[PerfEvent::Cycles] / static_cast<double>(pixels);
+                }
+                std::cout << std::fixed << std::setprecision(1) << std::setw(14) << record.pixelsPerSecond() / 1e6
+                          << std::setprecision(2) << std::setw(9) << cyclesPerPixel << std::flush;
+                records.push_back(std::move(record));
+            }
+            std::cout << std::endl;
+        } catch (const std::bad_alloc&) {
+            std::cout << "  skipped (out of memory)" << std::endl;
+        }
+    }
+
+    return records;
+}
+
+void writeOutputs(const CommandLine& cli, const std::vector<BenchmarkRecord>& records) {
+    if (!cli.jsonPath.empty()) {
+        std::ofstream json(cli.jsonPath);
+        if (!json) throw std::runtime_error("Cannot write " + cli.jsonPath);
+        writeBenchmarkJson(json, records);
+    }
+    if (!cli.csvPath.empty()) {
+        std::ofstream csv(cli.csvPath);
+        if (!csv) throw std::runtime_error("Cannot write " + cli.csvPath);
+        writeBenchmarkCsv(csv, records);
+    }
+    if (!cli.saveBaselinePath.empty()) {
+        saveBaseline(cli.saveBaselinePath, cpuModelName(), records);
+        std::cout << std::endl << "Baseline saved to " << cli.saveBaselinePath << std::endl;
+    }
+}
+
+// Regression gate: 0 when nothing regressed, 2 when any kernel is significantly slower
+int compareWithBaseline(const CommandLine& cli, const std::vector<BenchmarkRecord>& records) {
+    if (cli.comparePath.empty()) return 0;
+
+    const std::string cpu = cpuModelName();
+    std::vector<RegressionCheck> checks =
+        compareToBaseline(loadBaseline(cli.comparePath), cpu, records, cli.threshold, cli.alpha);
+
+    std::cout << std::endl << "=== Regression Check vs " << cli.comparePath << " ===" << std::endl;
+    std::cout << "Threshold: +" << std::fixed << std::setprecision(1) << cli.threshold * 100.0
+              << "% median, Mann-Whitney p < " << std::setprecision(3) << cli.alpha << std::endl;
+    size_t regressions = 0;
+    for (const auto& check : checks) {
+        std::cout << (check.regressed ? "REGRESSED  " : check.hasBaseline ? "ok         " : "no baseline ")
+                  << check.key;
+        if (check.hasBaseline) {
+            std::cout << ": " << std::setprecision(3) << check.baselineMedian / 1e6 << " ms -> "
+                      << check.currentMedian / 1e6 << " ms (" << std::showpos << std::setprecision(1)
+                      << check.change * 100.0 << "%" << std::noshowpos << ", p=" << std::setprecision(4)
+                      << check.pValue << ")";
+        }
+        std::cout << std::endl;
+        if (check.regressed) ++regressions;
+    }
+    std::cout << (regressions ? std::to_string(regressions) + " regression(s) detected" : "No regressions") << std::endl;
+    return regressions ? 2 : 0;
+}
+
+// Tuning mode: time every candidate at the requested size and store the winner for AUTO filters
+int runTuning(const CommandLine& cli) {
+    const std::string cpu = cpuModelName();
+    std::cout << "=== Autotuning " << cli.width << "x" << cli.height << ", " << cli.kernelSize << "x"
+              << cli.kernelSize << " kernel ===" << std::endl;
+    std::cout << "CPU: " << cpu << std::endl << std::endl;
+
+    SobelConfig config;
+    config.kernel_size = cli.kernelSize;
+    AutotuneOptions options;
+    options.bench.pin_cpu = cli.bench.pin_cpu;
+    if (cli.bench.iterations) options.bench.iterations = cli.bench.iterations;
+    AutotuneResult result = autotune(cli.width, cli.height, config, options);
+
+    std::cout << std::left << std::setw(10) << "Level" << std::right << std::setw(8) << "Band" << std::setw(9)
+              << "Threads" << std::setw(14) << "Median (ms)" << std::setw(14) << "p99 (ms)" << std::endl;
+    for (const TuningCandidate& candidate : result.candidates) {
+        const TuningParameters& p = candidate.parameters;
+        std::cout << std::left << std::setw(10) << simdLevelName(p.level) << std::right
+                  << std::setw(8) << (p.band_height ? std::to_string(p.band_height) : std::string("frame"))
+                  << std::setw(9) << p.threads << std::fixed << std::setprecision(3)
+                  << std::setw(14) << candidate.stats.median / 1e6 << std::setw(14) << candidate.stats.p99 / 1e6
+                  << std::endl;
+    }
+
+    WisdomEntry entry;
+    entry.cpu = cpu;
+    entry.width = cli.width;
+    entry.height = cli.height;
+    entry.parameters = result.best;
+    entry.medianNs = result.bestMedianNs;
+    const std::string path = cli.wisdomPath.empty() ? defaultWisdomPath() : cli.wisdomPath;
+    saveWisdom(path, entry);
+    std::cout << std::endl << "Best: " << simdLevelName(result.best.level) << ", band "
+              << (result.best.band_height ? std::to_string(result.best.band_height) : std::string("frame"))
+              << ", " << result.best.threads << " thread(s), " << std::setprecision(3) << result.bestMedianNs / 1e6
+              << " ms -> " << path << std::endl;
+    return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
-        runBenchmark();
-        return 0;
+        CommandLine cli;
+        if (!parseCommandLine(argc, argv, cli)) return 0;
+        if (cli.tune) return runTuning(cli);
+        std::vector<BenchmarkRecord> records = cli.sweep ? runSweep(cli) : runBenchmarkSuite(cli);
+        writeOutputs(cli, records);
+        return compareWithBaseline(cli, records);
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,257 @@
+/**
+ * @file canny.cpp
+ * @brief Implementation of orientation, non-maximum suppression and hysteresis
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "canny.hpp"
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <cstring>
+
+namespace sobel {
+
+namespace {
+
+inline int countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#if defined(__AVX2__)
+// Narrow eight int32 lanes holding 0..255 to eight bytes
+inline void storeBytes8(uint8_t* dst, __m256i v) {
+    const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(v, v), _mm256_setzero_si256());
+    const __m256i ordered = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(ordered));
+}
+
+// Direction masks for eight pixels: horizontal, vertical and "same sign" (45 degree diagonal)
+inline void directionMasksAVX2(const int32_t* gx, const int32_t* gy, __m256i& horizontal,
+                               __m256i& vertical, __m256i& sameSign) {
+    const __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gx));
+    const __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gy));
+    const __m256i ax = _mm256_abs_epi32(vx);
+    const __m256i ay = _mm256_slli_epi32(_mm256_abs_epi32(vy), 10);
+    horizontal = _mm256_xor_si256(_mm256_cmpgt_epi32(ay, _mm256_mullo_epi32(ax, _mm256_set1_epi32(kTan22_5Q10))),
+                                  _mm256_set1_epi32(-1));
+    vertical = _mm256_cmpgt_epi32(ay, _mm256_mullo_epi32(ax, _mm256_set1_epi32(kTan67_5Q10)));
+    sameSign = _mm256_cmpgt_epi32(_mm256_xor_si256(vx, vy), _mm256_set1_epi32(-1));
+}
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX2__)
+inline void storeBytes4(uint8_t* dst, __m128i v) {
+    const int32_t word = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(v, v), _mm_setzero_si128()));
+    std::memcpy(dst, &word, sizeof(word));
+}
+
+inline void directionMasksSSE(const int32_t* gx, const int32_t* gy, __m128i& horizontal,
+                              __m128i& vertical, __m128i& sameSign) {
+    const __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gx));
+    const __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gy));
+    const __m128i ax = _mm_abs_epi32(vx);
+    const __m128i ay = _mm_slli_epi32(_mm_abs_epi32(vy), 10);
+    horizontal = _mm_xor_si128(_mm_cmpgt_epi32(ay, _mm_mullo_epi32(ax, _mm_set1_epi32(kTan22_5Q10))),
+                               _mm_set1_epi32(-1));
+    vertical = _mm_cmpgt_epi32(ay, _mm_mullo_epi32(ax, _mm_set1_epi32(kTan67_5Q10)));
+    sameSign = _mm_cmpgt_epi32(_mm_xor_si128(vx, vy), _mm_set1_epi32(-1));
+}
+#endif
+
+} // namespace
+
+void orientationRow(SimdLevel level, const int32_t* gx, const int32_t* gy, std::size_t width,
+                    uint8_t* direction) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        for (; x + 8 <= width; x += 8) {
+            __m256i horizontal, vertical, sameSign;
+            directionMasksAVX2(gx + x, gy + x, horizontal, vertical, sameSign);
+            __m256i dir = _mm256_blendv_epi8(_mm256_set1_epi32(3), _mm256_set1_epi32(1), sameSign);
+            dir = _mm256_blendv_epi8(dir, _mm256_set1_epi32(2), vertical);
+            dir = _mm256_andnot_si256(horizontal, dir);
+            storeBytes8(direction + x, dir);
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        for (; x + 4 <= width; x += 4) {
+            __m128i horizontal, vertical, sameSign;
+            directionMasksSSE(gx + x, gy + x, horizontal, vertical, sameSign);
+            __m128i dir = _mm_blendv_epi8(_mm_set1_epi32(3), _mm_set1_epi32(1), sameSign);
+            dir = _mm_blendv_epi8(dir, _mm_set1_epi32(2), vertical);
+            dir = _mm_andnot_si128(horizontal, dir);
+            storeBytes4(direction + x, dir);
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        direction[x] = static_cast<uint8_t>(quantizeDirection(gx[x], gy[x]));
+    }
+}
+
+void nonMaximumSuppressionRow(SimdLevel level, const float* above, const float* center, const float* below,
+                              const int32_t* gx, const int32_t* gy, std::size_t width,
+                              float low, float high, uint8_t* state) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        const __m256 vLow = _mm256_set1_ps(low);
+        const __m256 vHigh = _mm256_set1_ps(high);
+        for (; x + 8 <= width; x += 8) {
+            __m256i horizontal, vertical, sameSign;
+            directionMasksAVX2(gx + x, gy + x, horizontal, vertical, sameSign);
+            const __m256 m = _mm256_loadu_ps(center + x);
+
+            // Diagonal neighbours first, then override for vertical and horizontal bins
+            __m256 n1 = _mm256_blendv_ps(_mm256_loadu_ps(above + x + 1), _mm256_loadu_ps(above + x - 1),
+                                         _mm256_castsi256_ps(sameSign));
+            __m256 n2 = _mm256_blendv_ps(_mm256_loadu_ps(below + x - 1), _mm256_loadu_ps(below + x + 1),
+                                         _mm256_castsi256_ps(sameSign));
+            n1 = _mm256_blendv_ps(n1, _mm256_loadu_ps(above + x), _mm256_castsi256_ps(vertical));
+            n2 = _mm256_blendv_ps(n2, _mm256_loadu_ps(below + x), _mm256_castsi256_ps(vertical));
+            n1 = _mm256_blendv_ps(n1, _mm256_loadu_ps(center + x - 1), _mm256_castsi256_ps(horizontal));
+            n2 = _mm256_blendv_ps(n2, _mm256_loadu_ps(center + x + 1), _mm256_castsi256_ps(horizontal));
+
+            const __m256 keep = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(m, n1, _CMP_GT_OQ),
+                                                            _mm256_cmp_ps(m, n2, _CMP_GE_OQ)),
+                                              _mm256_cmp_ps(m, vLow, _CMP_GT_OQ));
+            const __m256 strong = _mm256_and_ps(keep, _mm256_cmp_ps(m, vHigh, _CMP_GT_OQ));
+            const __m256i value = _mm256_sub_epi32(_mm256_setzero_si256(),
+                                                   _mm256_add_epi32(_mm256_castps_si256(keep), _mm256_castps_si256(strong)));
+            storeBytes8(state + x, value);
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        const __m128 vLow = _mm_set1_ps(low);
+        const __m128 vHigh = _mm_set1_ps(high);
+        for (; x + 4 <= width; x += 4) {
+            __m128i horizontal, vertical, sameSign;
+            directionMasksSSE(gx + x, gy + x, horizontal, vertical, sameSign);
+            const __m128 m = _mm_loadu_ps(center + x);
+
+            __m128 n1 = _mm_blendv_ps(_mm_loadu_ps(above + x + 1), _mm_loadu_ps(above + x - 1),
+                                      _mm_castsi128_ps(sameSign));
+            __m128 n2 = _mm_blendv_ps(_mm_loadu_ps(below + x - 1), _mm_loadu_ps(below + x + 1),
+                                      _mm_castsi128_ps(sameSign));
+            n1 = _mm_blendv_ps(n1, _mm_loadu_ps(above + x), _mm_castsi128_ps(vertical));
+            n2 = _mm_blendv_ps(n2, _mm_loadu_ps(below + x), _mm_castsi128_ps(vertical));
+            n1 = _mm_blendv_ps(n1, _mm_loadu_ps(center + x - 1), _mm_castsi128_ps(horizontal));
+            n2 = _mm_blendv_ps(n2, _mm_loadu_ps(center + x + 1), _mm_castsi128_ps(horizontal));
+
+            const __m128 keep = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(m, n1), _mm_cmpge_ps(m, n2)),
+                                           _mm_cmpgt_ps(m, vLow));
+            const __m128 strong = _mm_and_ps(keep, _mm_cmpgt_ps(m, vHigh));
+            const __m128i value = _mm_sub_epi32(_mm_setzero_si128(),
+                                                _mm_add_epi32(_mm_castps_si128(keep), _mm_castps_si128(strong)));
+            storeBytes4(state + x, value);
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        const float m = center[x];
+        float n1, n2;
+        switch (quantizeDirection(gx[x], gy[x])) {
+            case GradientDirection::Horizontal:  n1 = center[x - 1]; n2 = center[x + 1]; break;
+            case GradientDirection::Vertical:    n1 = above[x];      n2 = below[x];      break;
+            case GradientDirection::Diagonal45:  n1 = above[x - 1];  n2 = below[x + 1];  break;
+            default:                             n1 = above[x + 1];  n2 = below[x - 1];  break;
+        }
+        const bool keep = m > n1 && m >= n2 && m > low;
+        state[x] = static_cast<uint8_t>(keep ? (m > high ? 2 : 1) : 0);
+    }
+}
+
+void hysteresis(SimdLevel level, uint8_t* state, std::ptrdiff_t stride, std::size_t width,
+                std::size_t height, std::vector<uint8_t*>& stack) {
+    (void)level;
+    stack.clear();
+
+    // Seed with every strong pixel
+    for (std::size_t y = 0; y < height; ++y) {
+        uint8_t* row = state + static_cast<std::ptrdiff_t>(y) * stride;
+        std::size_t x = 0;
+#if defined(__AVX2__)
+        if (level == SimdLevel::AVX2) {
+            const __m256i two = _mm256_set1_epi8(2);
+            for (; x + 32 <= width; x += 32) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x));
+                uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, two)));
+                while (mask) {
+                    int bit = countTrailingZeros(mask);
+                    stack.push_back(row + x + bit);
+                    mask &= mask - 1;
+                }
+            }
+        }
+#endif
+        for (; x < width; ++x) {
+            if (row[x] == 2) stack.push_back(row + x);
+        }
+    }
+
+    // Iterative propagation; the zero border keeps neighbour access in bounds
+    const std::ptrdiff_t offsets[8] = {
+        -stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1
+    };
+    while (!stack.empty()) {
+        uint8_t* p = stack.back();
+        stack.pop_back();
+        for (std::ptrdiff_t offset : offsets) {
+            uint8_t* q = p + offset;
+            if (*q == 1) {
+                *q = 2;
+                stack.push_back(q);
+            }
+        }
+    }
+}
+
+void finalizeEdges(SimdLevel level, const uint8_t* state, std::ptrdiff_t stride, std::size_t width,
+                   std::size_t height, uint8_t* output) {
+    (void)level;
+    for (std::size_t y = 0; y < height; ++y) {
+        const uint8_t* row = state + static_cast<std::ptrdiff_t>(y) * stride;
+        uint8_t* out = output + y * width;
+        std::size_t x = 0;
+#if defined(__AVX2__)
+        if (level == SimdLevel::AVX2) {
+            const __m256i two = _mm256_set1_epi8(2);
+            for (; x + 32 <= width; x += 32) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), _mm256_cmpeq_epi8(v, two));
+            }
+        }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+        if (level != SimdLevel::Scalar) {
+            const __m128i two = _mm_set1_epi8(2);
+            for (; x + 16 <= width; x += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_cmpeq_epi8(v, two));
+            }
+        }
+#endif
+        for (; x < width; ++x) {
+            out[x] = row[x] == 2 ? 255 : 0;
+        }
+    }
+}
+
+} // namespace sobel
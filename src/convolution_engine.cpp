@@ -0,0 +1,377 @@
+/**
+ * @file convolution_engine.cpp
+ * @brief Implementation of the runtime-configurable convolution engine
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "convolution_engine.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace sobel {
+
+ConvolutionKernel::ConvolutionKernel(std::size_t width, std::size_t height, std::vector<int> coefficients)
+    : width_(width), height_(height), coefficients_(std::move(coefficients)) {
+    if (width == 0 || height == 0 || width % 2 == 0 || height % 2 == 0) {
+        throw std::invalid_argument("Kernel dimensions must be odd and positive");
+    }
+    if (coefficients_.size() != width * height) {
+        throw std::invalid_argument("Coefficient count doesn't match kernel dimensions");
+    }
+}
+
+ConvolutionKernel ConvolutionKernel::sobelX(int size) {
+    switch (size) {
+        case 3: return fromArray<3>(makeSobelKernelX<3>());
+        case 5: return fromArray<5>(makeSobelKernelX<5>());
+        case 7: return fromArray<7>(makeSobelKernelX<7>());
+        default: throw std::invalid_argument("Sobel kernel size must be 3, 5 or 7");
+    }
+}
+
+ConvolutionKernel ConvolutionKernel::sobelY(int size) {
+    switch (size) {
+        case 3: return fromArray<3>(makeSobelKernelY<3>());
+        case 5: return fromArray<5>(makeSobelKernelY<5>());
+        case 7: return fromArray<7>(makeSobelKernelY<7>());
+        default: throw std::invalid_argument("Sobel kernel size must be 3, 5 or 7");
+    }
+}
+
+ConvolutionKernel ConvolutionKernel::scharrX() {
+    return ConvolutionKernel(3, 3, { -3, 0,  3,
+                                    -10, 0, 10,
+                                     -3, 0,  3 });
+}
+
+ConvolutionKernel ConvolutionKernel::scharrY() {
+    return ConvolutionKernel(3, 3, { -3, -10, -3,
+                                      0,   0,  0,
+                                      3,  10,  3 });
+}
+
+ConvolutionEngine::ConvolutionEngine(const ConvolutionKernel& kernel) : kernel_(kernel) {
+    analyse();
+}
+
+void ConvolutionEngine::analyse() {
+    const std::size_t kw = kernel_.width();
+    const std::size_t kh = kernel_.height();
+    const int rx = static_cast<int>(kw / 2);
+    const int ry = static_cast<int>(kh / 2);
+
+    // Worst case for 8-bit input: all positive taps at 255 or all negative taps at 255
+    int64_t positive = 0, negative = 0;
+    taps_.clear();
+    for (std::size_t y = 0; y < kh; ++y) {
+        for (std::size_t x = 0; x < kw; ++x) {
+            const int w = kernel_.at(x, y);
+            if (w == 0) continue;
+            (w > 0 ? positive : negative) += std::abs(w);
+            taps_.push_back({static_cast<int>(x) - rx, static_cast<int>(y) - ry, w});
+        }
+    }
+    const int64_t worst = 255 * std::max(positive, negative);
+    if (255 * (positive + negative) > INT32_MAX) {
+        throw std::invalid_argument("Kernel response would overflow int32 accumulation");
+    }
+    worstCase_ = static_cast<int32_t>(worst);
+
+    // Rank-1 test: pivot on the first non-zero coefficient, every 2x2 minor through it must vanish
+    separable_ = false;
+    rowFactor_.clear();
+    columnFactor_.clear();
+    if (!taps_.empty()) {
+        const std::size_t py = static_cast<std::size_t>(taps_.front().dy + ry);
+        const std::size_t px = static_cast<std::size_t>(taps_.front().dx + rx);
+        const int64_t pivot = kernel_.at(px, py);
+        bool rankOne = true;
+        for (std::size_t y = 0; y < kh && rankOne; ++y) {
+            for (std::size_t x = 0; x < kw && rankOne; ++x) {
+                rankOne = static_cast<int64_t>(kernel_.at(x, y)) * pivot ==
+                          static_cast<int64_t>(kernel_.at(px, y)) * kernel_.at(x, py);
+            }
+        }
+        if (rankOne) {
+            // Primitive row factor makes every column factor an exact integer
+            int g = 0;
+            for (std::size_t x = 0; x < kw; ++x) g = std::gcd(g, kernel_.at(x, py));
+            rowFactor_.resize(kw);
+            columnFactor_.resize(kh);
+            for (std::size_t x = 0; x < kw; ++x) rowFactor_[x] = kernel_.at(x, py) / g;
+            for (std::size_t y = 0; y < kh; ++y) columnFactor_[y] = kernel_.at(px, y) / rowFactor_[px];
+            separable_ = true;
+        }
+    }
+
+    if (separable_) path_ = ConvolutionPath::Separable;
+    else if (worstCase_ <= 32767) path_ = ConvolutionPath::DenseInt16;
+    else path_ = ConvolutionPath::DenseInt32;
+}
+
+void ConvolutionEngine::setPath(ConvolutionPath path) {
+    if (path == ConvolutionPath::Separable && !separable_) {
+        throw std::invalid_argument("Kernel is not separable");
+    }
+    if (path == ConvolutionPath::DenseInt16 && worstCase_ > 32767) {
+        throw std::invalid_argument("Kernel response does not fit int16 accumulation");
+    }
+    path_ = path;
+}
+
+std::size_t ConvolutionEngine::halo() const noexcept {
+    return std::max(kernel_.width(), kernel_.height()) / 2;
+}
+
+std::size_t ConvolutionEngine::scratchSize(std::size_t width) const noexcept {
+    return width + 2 * halo() + kRowSlack;
+}
+
+void ConvolutionEngine::convolveRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride,
+                                    std::size_t width, int32_t* output, int32_t* scratch) const {
+    if (path_ == ConvolutionPath::Separable) {
+        separableRow(level, src, stride, width, output, scratch);
+    } else {
+        denseRow(level, src, stride, width, output);
+    }
+}
+
+// Column factor over width + 2*rx columns into int32 scratch, then row factor
+void ConvolutionEngine::separableRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride,
+                                     std::size_t width, int32_t* output, int32_t* scratch) const {
+    (void)level;
+    const int kw = static_cast<int>(rowFactor_.size());
+    const int kh = static_cast<int>(columnFactor_.size());
+    const int rx = kw / 2;
+    const int ry = kh / 2;
+    const std::size_t length = width + 2 * rx;
+    const uint8_t* base = src - rx;
+    std::size_t x = 0;
+
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        for (; x + 8 <= length; x += 8) {
+            __m256i acc = _mm256_setzero_si256();
+            for (int j = 0; j < kh; ++j) {
+                if (columnFactor_[j] == 0) continue;
+                const __m256i p = _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                    reinterpret_cast<const __m128i*>(base + (j - ry) * stride + static_cast<std::ptrdiff_t>(x))));
+                acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(p, _mm256_set1_epi32(columnFactor_[j])));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(scratch + x), acc);
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        for (; x + 4 <= length; x += 4) {
+            __m128i acc = _mm_setzero_si128();
+            for (int j = 0; j < kh; ++j) {
+                if (columnFactor_[j] == 0) continue;
+                int32_t word;
+                std::memcpy(&word, base + (j - ry) * stride + static_cast<std::ptrdiff_t>(x), sizeof(word));
+                const __m128i p = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(word));
+                acc = _mm_add_epi32(acc, _mm_mullo_epi32(p, _mm_set1_epi32(columnFactor_[j])));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(scratch + x), acc);
+        }
+    }
+#endif
+    for (; x < length; ++x) {
+        int32_t sum = 0;
+        for (int j = 0; j < kh; ++j) {
+            sum += columnFactor_[j] * base[(j - ry) * stride + static_cast<std::ptrdiff_t>(x)];
+        }
+        scratch[x] = sum;
+    }
+
+    x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        for (; x + 8 <= width; x += 8) {
+            __m256i acc = _mm256_setzero_si256();
+            for (int i = 0; i < kw; ++i) {
+                if (rowFactor_[i] == 0) continue;
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scratch + x + i));
+                acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(v, _mm256_set1_epi32(rowFactor_[i])));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + x), acc);
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        for (; x + 4 <= width; x += 4) {
+            __m128i acc = _mm_setzero_si128();
+            for (int i = 0; i < kw; ++i) {
+                if (rowFactor_[i] == 0) continue;
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(scratch + x + i));
+                acc = _mm_add_epi32(acc, _mm_mullo_epi32(v, _mm_set1_epi32(rowFactor_[i])));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), acc);
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        int32_t sum = 0;
+        for (int i = 0; i < kw; ++i) {
+            sum += rowFactor_[i] * scratch[x + i];
+        }
+        output[x] = sum;
+    }
+}
+
+// Every non-zero tap as a shifted multiply-add; int16 lanes when the worst case allows
+void ConvolutionEngine::denseRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride,
+                                 std::size_t width, int32_t* output) const {
+    (void)level;
+    std::size_t x = 0;
+    auto at = [&](const Tap& t, std::size_t col) {
+        return src + t.dy * stride + t.dx + static_cast<std::ptrdiff_t>(col);
+    };
+
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        if (path_ == ConvolutionPath::DenseInt16) {
+            for (; x + 16 <= width; x += 16) {
+                __m256i acc = _mm256_setzero_si256();
+                for (const Tap& t : taps_) {
+                    const __m256i p = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(at(t, x))));
+                    acc = _mm256_add_epi16(acc, _mm256_mullo_epi16(p, _mm256_set1_epi16(static_cast<short>(t.weight))));
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + x), _mm256_cvtepi16_epi32(_mm256_castsi256_si128(acc)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + x + 8), _mm256_cvtepi16_epi32(_mm256_extracti128_si256(acc, 1)));
+            }
+        } else {
+            for (; x + 8 <= width; x += 8) {
+                __m256i acc = _mm256_setzero_si256();
+                for (const Tap& t : taps_) {
+                    const __m256i p = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(at(t, x))));
+                    acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(p, _mm256_set1_epi32(t.weight)));
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + x), acc);
+            }
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        if (path_ == ConvolutionPath::DenseInt16) {
+            for (; x + 8 <= width; x += 8) {
+                __m128i acc = _mm_setzero_si128();
+                for (const Tap& t : taps_) {
+                    const __m128i p = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(at(t, x))));
+                    acc = _mm_add_epi16(acc, _mm_mullo_epi16(p, _mm_set1_epi16(static_cast<short>(t.weight))));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), _mm_cvtepi16_epi32(acc));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x + 4), _mm_cvtepi16_epi32(_mm_srli_si128(acc, 8)));
+            }
+        } else {
+            for (; x + 4 <= width; x += 4) {
+                __m128i acc = _mm_setzero_si128();
+                for (const Tap& t : taps_) {
+                    int32_t word;
+                    std::memcpy(&word, at(t, x), sizeof(word));
+                    const __m128i p = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(word));
+                    acc = _mm_add_epi32(acc, _mm_mullo_epi32(p, _mm_set1_epi32(t.weight)));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), acc);
+            }
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        int32_t sum = 0;
+        for (const Tap& t : taps_) {
+            sum += t.weight * *at(t, x);
+        }
+        output[x] = sum;
+    }
+}
+
+std::vector<int32_t> ConvolutionEngine::convolve(const GrayscaleImage& image, BorderMode border,
+                                                 SimdLevel level) const {
+    if (image.empty()) {
+        return {};
+    }
+
+    const std::size_t width = image.width();
+    const std::size_t height = image.height();
+    const std::size_t pad = halo();
+    std::size_t stride = 0;
+    std::vector<uint8_t> padded = makePaddedImage(image, pad, border, stride);
+    const uint8_t* origin = padded.data() + pad * stride + pad;
+
+    // Rows are written in place; only the final row needs the vector slack
+    std::vector<int32_t> result(width * height + kRowSlack);
+    std::vector<int32_t> scratch(scratchSize(width));
+    for (std::size_t y = 0; y < height; ++y) {
+        convolveRow(level, origin + y * stride, static_cast<std::ptrdiff_t>(stride), width,
+                    result.data() + y * width, scratch.data());
+    }
+    result.resize(width * height);
+    return result;
+}
+
+namespace {
+
+template<typename T>
+void fillBorderT(T* origin, std::size_t stride, std::size_t width, std::size_t height,
+                 std::size_t halo, BorderMode border) {
+    if (halo == 0) return;
+
+    const bool zero = border == BorderMode::Zero;
+    for (std::size_t y = 0; y < height; ++y) {
+        T* row = origin + y * stride;
+        std::fill(row - halo, row, zero ? T(0) : row[0]);
+        std::fill(row + width, row + width + halo, zero ? T(0) : row[width - 1]);
+    }
+    const std::size_t rowLength = width + 2 * halo;
+    for (std::size_t i = 1; i <= halo; ++i) {
+        T* top = origin - i * stride - halo;
+        T* bottom = origin + (height - 1 + i) * stride - halo;
+        if (zero) {
+            std::fill(top, top + rowLength, T(0));
+            std::fill(bottom, bottom + rowLength, T(0));
+        } else {
+            std::copy_n(origin - halo, rowLength, top);
+            std::copy_n(origin + (height - 1) * stride - halo, rowLength, bottom);
+        }
+    }
+}
+
+} // namespace
+
+void fillBorder(uint8_t* origin, std::size_t stride, std::size_t width, std::size_t height,
+                std::size_t halo, BorderMode border) {
+    fillBorderT(origin, stride, width, height, halo, border);
+}
+
+void fillBorder(uint16_t* origin, std::size_t stride, std::size_t width, std::size_t height,
+                std::size_t halo, BorderMode border) {
+    fillBorderT(origin, stride, width, height, halo, border);
+}
+
+std::vector<uint8_t> makePaddedImage(const GrayscaleImage& image, std::size_t halo,
+                                     BorderMode border, std::size_t& stride) {
+    const std::size_t width = image.width();
+    const std::size_t height = image.height();
+    stride = (width + 2 * halo + 31) & ~std::size_t(31);
+
+    // Vector loads may run up to one register past the last halo row
+    std::vector<uint8_t> padded(stride * (height + 2 * halo) + 64, 0);
+    uint8_t* origin = padded.data() + halo * stride + halo;
+    for (std::size_t y = 0; y < height; ++y) {
+        std::memcpy(origin + y * stride, image.data() + y * width, width);
+    }
+    fillBorder(origin, stride, width, height, halo, border);
+    return padded;
+}
+
+} // namespace sobel
@@ -0,0 +1,62 @@
+/**
+ * @file gray_frame.cpp
+ * @brief Implementation of the haloed gray plane
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "gray_frame.hpp"
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace sobel {
+
+namespace {
+
+constexpr std::size_t kAlignment = 32;
+// Vector loads may run up to one register past the last halo row
+constexpr std::size_t kLoadSlack = 64;
+
+} // namespace
+
+template<typename T>
+BasicGrayFrame<T>::BasicGrayFrame(std::size_t width, std::size_t height) {
+    resize(width, height);
+}
+
+template<typename T>
+void BasicGrayFrame<T>::AlignedDelete::operator()(T* p) const noexcept {
+    // Aligned operator new/delete, so allocation accounting sees the buffer
+    ::operator delete(p, std::align_val_t(kAlignment));
+}
+
+template<typename T>
+void BasicGrayFrame<T>::resize(std::size_t width, std::size_t height) {
+    if (width == 0 || height == 0) {
+        throw std::invalid_argument("Gray frame dimensions must be positive");
+    }
+    constexpr std::size_t kAlignSamples = kAlignment / sizeof(T);
+    const std::size_t stride = (width + 2 * kHalo + kAlignSamples - 1) & ~(kAlignSamples - 1);
+    const std::size_t bytes = stride * (height + 2 * kHalo) * sizeof(T) + kLoadSlack;
+    if (bytes > capacity_) {
+        buffer_.reset(static_cast<T*>(::operator new(bytes, std::align_val_t(kAlignment))));
+        std::memset(buffer_.get(), 0, bytes);
+        capacity_ = bytes;
+    }
+    width_ = width;
+    height_ = height;
+    stride_ = stride;
+}
+
+template<typename T>
+void BasicGrayFrame<T>::fillBorder(BorderMode border) {
+    if (empty()) return;
+    sobel::fillBorder(origin(), stride_, width_, height_, kHalo, border);
+}
+
+template class BasicGrayFrame<uint8_t>;
+template class BasicGrayFrame<uint16_t>;
+
+} // namespace sobel
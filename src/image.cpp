@@ -23,6 +23,16 @@ uint8_t RGBPixel::toGrayscale() const {
     return static_cast<uint8_t>(std::round(std::clamp(gray, 0.0, 255.0)));
 }
 
+uint16_t RGBPixel16::toGrayscale() const {
+    // Same weights as RGBPixel::toGrayscale()
+    constexpr double R_WEIGHT = 0.2126;
+    constexpr double G_WEIGHT = 0.7152;
+    constexpr double B_WEIGHT = 0.0722;
+    
+    double gray = R_WEIGHT * r + G_WEIGHT * g + B_WEIGHT * b;
+    return static_cast<uint16_t>(std::round(std::clamp(gray, 0.0, 65535.0)));
+}
+
 // Template specializations for Image class
 template<typename PixelType>
 Image<PixelType>::Image(size_type width, size_type height)
@@ -95,5 +105,7 @@ void Image<PixelType>::resize(size_type width, size_type height) {
 // Explicit template instantiations for common types
 template class Image<RGBPixel>;
 template class Image<uint8_t>;
+template class Image<RGBPixel16>;
+template class Image<uint16_t>;
 
 } // namespace sobel
@@ -7,14 +7,324 @@
  */
 
 #include "image_io.hpp"
+#include "tracer.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
+#include <limits>
 
 namespace sobel {
 
+static_assert(sizeof(RGBPixel) == 3, "RGB images are read and written as packed bytes");
+
+namespace {
+
+constexpr std::size_t kBmpFileHeaderSize = 14;
+constexpr std::size_t kBmpInfoHeaderSize = 40;
+constexpr std::size_t kMaxPnmDimension = std::size_t(1) << 30;
+// Streaming loaders read this much per chunk: large reads, still cache resident
+constexpr std::size_t kStreamChunkBytes = 256 * 1024;
+
+/**
+ * @brief Where and how the pixels of a PPM/PGM/BMP file are stored
+ */
+struct PixelLayout {
+    ImageFormat format = ImageFormat::Raw;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    int bitsPerPixel = 0;          // 24 (PPM, BMP) or 8 (PGM, palettized BMP)
+    std::size_t rowBytes = 0;      // Stored row size, including BMP padding to 4 bytes
+    bool bottomUp = false;         // BMP with positive height: last row first
+    std::size_t dataOffset = 0;
+    std::array<RGBPixel, 256> palette{};
+};
+
+uint16_t readLE16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void writeLE16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void writeLE32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+/**
+ * @brief Next decimal field of a PNM header, skipping whitespace and '#' comments
+ *
+ * Consumes the single whitespace character that ends the field, so after
+ * the maxval the stream sits on the first pixel byte.
+ */
+bool readPnmField(std::istream& in, std::size_t& value) {
+    int c = in.get();
+    for (;;) {
+        if (c == '#') {
+            while (c != '\n' && c != std::char_traits<char>::eof()) c = in.get();
+        } else if (c != std::char_traits<char>::eof() && std::isspace(c)) {
+            c = in.get();
+        } else {
+            break;
+        }
+    }
+    if (c == std::char_traits<char>::eof() || !std::isdigit(c)) return false;
+    value = 0;
+    while (c != std::char_traits<char>::eof() && std::isdigit(c)) {
+        value = value * 10 + static_cast<std::size_t>(c - '0');
+        if (value > kMaxPnmDimension) return false;
+        c = in.get();
+    }
+    return c != std::char_traits<char>::eof() && std::isspace(c);
+}
+
+std::optional<ImageIOError> parsePnmHeader(std::istream& in, PixelLayout& layout) {
+    std::size_t maxValue = 0;
+    if (!readPnmField(in, layout.width) || !readPnmField(in, layout.height) || !readPnmField(in, maxValue)) {
+        return ImageIOError::InvalidHeader;
+    }
+    if (maxValue != 255) return ImageIOError::UnsupportedFormat;
+    layout.bitsPerPixel = layout.format == ImageFormat::PPM ? 24 : 8;
+    layout.rowBytes = layout.width * static_cast<std::size_t>(layout.bitsPerPixel / 8);
+    layout.dataOffset = static_cast<std::size_t>(in.tellg());
+    return std::nullopt;
+}
+
+std::optional<ImageIOError> parseBmpHeader(std::istream& in, PixelLayout& layout) {
+    std::array<uint8_t, kBmpFileHeaderSize + kBmpInfoHeaderSize> header{};
+    header[0] = 'B';
+    header[1] = 'M';
+    if (!in.read(reinterpret_cast<char*>(header.data() + 2), header.size() - 2)) return ImageIOError::InvalidHeader;
+    const uint8_t* info = header.data() + kBmpFileHeaderSize;
+
+    // BITMAPINFOHEADER or a later version (V4/V5 extend it); OS/2 core headers are not supported
+    const uint32_t infoSize = readLE32(info);
+    if (infoSize < kBmpInfoHeaderSize) return ImageIOError::UnsupportedFormat;
+    const auto width = static_cast<int32_t>(readLE32(info + 4));
+    const auto height = static_cast<int32_t>(readLE32(info + 8));
+    const uint16_t planes = readLE16(info + 12);
+    const uint16_t bitsPerPixel = readLE16(info + 14);
+    const uint32_t compression = readLE32(info + 16);
+    uint32_t colorsUsed = readLE32(info + 32);
+    if (planes != 1) return ImageIOError::InvalidHeader;
+    if ((bitsPerPixel != 24 && bitsPerPixel != 8) || compression != 0) return ImageIOError::UnsupportedFormat;
+    if (width <= 0 || height == 0 || height == std::numeric_limits<int32_t>::min()) {
+        return ImageIOError::InvalidDimensions;
+    }
+
+    layout.width = static_cast<std::size_t>(width);
+    layout.height = static_cast<std::size_t>(height < 0 ? -static_cast<int64_t>(height) : height);
+    layout.bottomUp = height > 0;
+    layout.bitsPerPixel = bitsPerPixel;
+    layout.rowBytes = (layout.width * bitsPerPixel + 31) / 32 * 4;
+    layout.dataOffset = readLE32(header.data() + 10);
+
+    if (bitsPerPixel == 8) {
+        if (colorsUsed == 0) colorsUsed = 256;
+        if (colorsUsed > 256) return ImageIOError::InvalidHeader;
+        std::array<uint8_t, 256 * 4> entries{};
+        in.seekg(static_cast<std::streamoff>(kBmpFileHeaderSize + infoSize));
+        if (!in.read(reinterpret_cast<char*>(entries.data()), colorsUsed * 4)) return ImageIOError::InvalidHeader;
+        for (std::size_t i = 0; i < colorsUsed; ++i) {
+            layout.palette[i] = RGBPixel(entries[4 * i + 2], entries[4 * i + 1], entries[4 * i]);
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Open a PPM/PGM/BMP file and parse its header, leaving `file` at the first pixel byte
+ */
+std::optional<ImageIOError> openImage(const std::string& filepath, std::ifstream& file, PixelLayout& layout) {
+    if (!std::filesystem::exists(filepath)) return ImageIOError::FileNotFound;
+    file.open(filepath, std::ios::binary);
+    if (!file.is_open()) return ImageIOError::ReadError;
+
+    char magic[2] = {};
+    if (!file.read(magic, 2)) return ImageIOError::InvalidHeader;
+    std::optional<ImageIOError> error;
+    if (magic[0] == 'P' && (magic[1] == '6' || magic[1] == '5')) {
+        layout.format = magic[1] == '6' ? ImageFormat::PPM : ImageFormat::PGM;
+        error = parsePnmHeader(file, layout);
+    } else if (magic[0] == 'B' && magic[1] == 'M') {
+        layout.format = ImageFormat::BMP;
+        error = parseBmpHeader(file, layout);
+    } else {
+        return ImageIOError::UnsupportedFormat;
+    }
+    if (error) return error;
+    if (layout.width == 0 || layout.height == 0) return ImageIOError::InvalidDimensions;
+
+    // Reject truncated files before allocating anything
+    const std::size_t fileSize = ImageIO::getFileSize(filepath);
+    if (layout.dataOffset > fileSize || (fileSize - layout.dataOffset) / layout.height < layout.rowBytes) {
+        return ImageIOError::InvalidFileSize;
+    }
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(layout.dataOffset));
+    return std::nullopt;
+}
+
+bool readBytes(std::ifstream& file, void* destination, std::size_t bytes) {
+    file.read(static_cast<char*>(destination), static_cast<std::streamsize>(bytes));
+    return file.gcount() == static_cast<std::streamsize>(bytes);
+}
+
+/**
+ * @brief Read all BMP rows with one bulk read and hand them to `convert(row, y)` in top-down order
+ */
+template<typename Convert>
+bool readBmpRows(std::ifstream& file, const PixelLayout& layout, Convert&& convert) {
+    std::vector<uint8_t> rows(layout.rowBytes * layout.height);
+    if (!readBytes(file, rows.data(), rows.size())) return false;
+    for (std::size_t y = 0; y < layout.height; ++y) {
+        const std::size_t stored = layout.bottomUp ? layout.height - 1 - y : y;
+        convert(rows.data() + stored * layout.rowBytes, y);
+    }
+    return true;
+}
+
+/**
+ * @brief Read `rows` stored rows in chunks and hand each to `convert(row, index)` in file order
+ */
+template<typename Convert>
+bool streamRows(std::ifstream& file, std::size_t rowBytes, std::size_t rows, Convert&& convert) {
+    const std::size_t chunkRows = std::max<std::size_t>(1, kStreamChunkBytes / rowBytes);
+    std::vector<uint8_t> chunk(std::min(chunkRows, rows) * rowBytes);
+    for (std::size_t first = 0; first < rows; first += chunkRows) {
+        const std::size_t count = std::min(chunkRows, rows - first);
+        if (!readBytes(file, chunk.data(), count * rowBytes)) return false;
+        for (std::size_t i = 0; i < count; ++i) convert(chunk.data() + i * rowBytes, first + i);
+    }
+    return true;
+}
+
+/**
+ * @brief Convert the pixel data at the current file position to gray, row y going to `outRow(y)`
+ */
+template<typename OutRow>
+bool streamGrayRows(std::ifstream& file, const PixelLayout& layout, OutRow&& outRow) {
+    const SimdLevel level = detectSimdLevel();
+    const std::size_t w = layout.width;
+    std::array<uint8_t, 256> paletteGray{};
+    for (std::size_t i = 0; i < paletteGray.size(); ++i) paletteGray[i] = layout.palette[i].toGrayscale();
+
+    return streamRows(file, layout.rowBytes, layout.height, [&](const uint8_t* row, std::size_t stored) {
+        uint8_t* out = outRow(layout.bottomUp ? layout.height - 1 - stored : stored);
+        if (layout.format == ImageFormat::PGM) {
+            std::memcpy(out, row, w);
+        } else if (layout.bitsPerPixel == 8) {
+            for (std::size_t x = 0; x < w; ++x) out[x] = paletteGray[row[x]];
+        } else {
+            packedToGrayRow(level, layout.format == ImageFormat::BMP ? PixelFormat::BGR : PixelFormat::RGB, row, w,
+                            out);
+        }
+    });
+}
+
+/**
+ * @brief Convert the pixel data at the current file position into `frame`
+ */
+bool streamGrayFrame(std::ifstream& file, const PixelLayout& layout, GrayFrame& frame) {
+    frame.resize(layout.width, layout.height);
+    return streamGrayRows(file, layout, [&](std::size_t y) { return frame.row(y); });
+}
+
+std::optional<ImageIOError> createParentDirectories(const std::string& filepath) {
+    std::filesystem::path path(filepath);
+    if (path.has_parent_path()) {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        if (ec) return ImageIOError::WriteError;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Write an optional header followed by the pixel bytes
+ */
+Result<bool> writeImageFile(const std::string& filepath, const std::string& header,
+                            const void* pixels, std::size_t bytes) {
+    if (auto error = createParentDirectories(filepath)) return Result<bool>(*error);
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return Result<bool>(ImageIOError::WriteError);
+    }
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(static_cast<const char*>(pixels), static_cast<std::streamsize>(bytes));
+    if (!file.good()) {
+        return Result<bool>(ImageIOError::WriteError);
+    }
+    return Result<bool>(true);
+}
+
+std::string pnmHeader(char kind, std::size_t width, std::size_t height) {
+    return std::string("P") + kind + "\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+}
+
+/**
+ * @brief Bottom-up BMP (24-bit, or 8-bit with a gray palette) built in memory and written at once
+ * @param pixel Writes the stored bytes of pixel (x, y) and returns the next output position
+ */
+template<typename WritePixel>
+Result<bool> writeBmp(const std::string& filepath, std::size_t width, std::size_t height, int bitsPerPixel,
+                      WritePixel&& pixel) {
+    const std::size_t rowBytes = (width * static_cast<std::size_t>(bitsPerPixel) + 31) / 32 * 4;
+    const std::size_t paletteBytes = bitsPerPixel == 8 ? 256 * 4 : 0;
+    const std::size_t dataOffset = kBmpFileHeaderSize + kBmpInfoHeaderSize + paletteBytes;
+    const std::size_t fileSize = dataOffset + rowBytes * height;
+    if (width > static_cast<std::size_t>(std::numeric_limits<int32_t>::max()) ||
+        height > static_cast<std::size_t>(std::numeric_limits<int32_t>::max()) ||
+        fileSize > std::numeric_limits<uint32_t>::max()) {
+        return Result<bool>(ImageIOError::InvalidDimensions);
+    }
+
+    std::vector<uint8_t> file(fileSize, 0);
+    uint8_t* header = file.data();
+    header[0] = 'B';
+    header[1] = 'M';
+    writeLE32(header + 2, static_cast<uint32_t>(fileSize));
+    writeLE32(header + 10, static_cast<uint32_t>(dataOffset));
+    uint8_t* info = header + kBmpFileHeaderSize;
+    writeLE32(info, static_cast<uint32_t>(kBmpInfoHeaderSize));
+    writeLE32(info + 4, static_cast<uint32_t>(width));
+    writeLE32(info + 8, static_cast<uint32_t>(height));   // Positive: bottom-up, readable everywhere
+    writeLE16(info + 12, 1);
+    writeLE16(info + 14, static_cast<uint16_t>(bitsPerPixel));
+    writeLE32(info + 20, static_cast<uint32_t>(rowBytes * height));
+    writeLE32(info + 24, 2835);   // 72 DPI
+    writeLE32(info + 28, 2835);
+    if (bitsPerPixel == 8) {
+        writeLE32(info + 32, 256);
+        uint8_t* palette = info + kBmpInfoHeaderSize;
+        for (int i = 0; i < 256; ++i) {
+            palette[4 * i] = palette[4 * i + 1] = palette[4 * i + 2] = static_cast<uint8_t>(i);
+        }
+    }
+
+    for (std::size_t y = 0; y < height; ++y) {
+        uint8_t* out = file.data() + dataOffset + (height - 1 - y) * rowBytes;
+        for (std::size_t x = 0; x < width; ++x) out = pixel(out, x, y);
+    }
+    return writeImageFile(filepath, std::string(), file.data(), file.size());
+}
+
+} // namespace
+
 Result<RGBImage> 
 ImageIO::loadRGBImage(const std::string& filepath, std::size_t width, std::size_t height) {
+    SOBEL_TRACE_SPAN("loadRGBImage");
+
     // Validate file exists
     if (!std::filesystem::exists(filepath)) {
         return Result<RGBImage>(ImageIOError::FileNotFound);
@@ -31,56 +341,218 @@ ImageIO::loadRGBImage(const std::string& filepath, std::size_t width, std::size_
         return Result<RGBImage>(ImageIOError::ReadError);
     }
     
-    // Read RGB data
-    const std::size_t expected_bytes = width * height * 3;
-    std::vector<uint8_t> raw_data(expected_bytes);
-    
-    file.read(reinterpret_cast<char*>(raw_data.data()), expected_bytes);
-    if (file.gcount() != static_cast<std::streamsize>(expected_bytes)) {
-        return Result<RGBImage>(ImageIOError::ReadError);
-    }
-    
-    // Convert raw bytes to RGB pixels
-    std::vector<RGBPixel> pixels;
-    pixels.reserve(width * height);
-    
-    for (std::size_t i = 0; i < expected_bytes; i += 3) {
-        pixels.emplace_back(raw_data[i], raw_data[i + 1], raw_data[i + 2]);
-    }
-    
+    // Read RGB data straight into the image (RGBPixel is packed r, g, b)
+    RGBImage image;
     try {
-        return Result<RGBImage>(RGBImage(std::move(pixels), width, height));
+        image = RGBImage(width, height);
     } catch (const std::exception&) {
         return Result<RGBImage>(ImageIOError::InvalidDimensions);
     }
+    if (!readBytes(file, image.data(), width * height * 3)) {
+        return Result<RGBImage>(ImageIOError::ReadError);
+    }
+    return Result<RGBImage>(std::move(image));
+}
+
+Result<RGBImage> ImageIO::loadRGBImage(const std::string& filepath) {
+    SOBEL_TRACE_SPAN("loadRGBImage");
+
+    std::ifstream file;
+    PixelLayout layout;
+    if (auto error = openImage(filepath, file, layout)) return Result<RGBImage>(*error);
+
+    RGBImage image(layout.width, layout.height);
+    RGBPixel* pixels = image.data();
+    const std::size_t w = layout.width;
+    bool ok = false;
+    switch (layout.format) {
+        case ImageFormat::PPM:
+            ok = readBytes(file, pixels, w * layout.height * 3);
+            break;
+        case ImageFormat::PGM: {
+            GrayscaleImage gray(w, layout.height);
+            ok = readBytes(file, gray.data(), gray.size());
+            for (std::size_t i = 0; ok && i < gray.size(); ++i) {
+                const uint8_t value = gray.data()[i];
+                pixels[i] = RGBPixel(value, value, value);
+            }
+            break;
+        }
+        default:
+            ok = readBmpRows(file, layout, [&](const uint8_t* row, std::size_t y) {
+                RGBPixel* out = pixels + y * w;
+                if (layout.bitsPerPixel == 8) {
+                    for (std::size_t x = 0; x < w; ++x) out[x] = layout.palette[row[x]];
+                } else {
+                    for (std::size_t x = 0; x < w; ++x) out[x] = RGBPixel(row[3 * x + 2], row[3 * x + 1], row[3 * x]);
+                }
+            });
+            break;
+    }
+    if (!ok) return Result<RGBImage>(ImageIOError::ReadError);
+    return Result<RGBImage>(std::move(image));
+}
+
+Result<GrayscaleImage>
+ImageIO::loadGrayscaleImage(const std::string& filepath, std::size_t width, std::size_t height) {
+    SOBEL_TRACE_SPAN("loadGrayscaleImage");
+
+    if (!std::filesystem::exists(filepath)) {
+        return Result<GrayscaleImage>(ImageIOError::FileNotFound);
+    }
+    if (width == 0 || height == 0) {
+        return Result<GrayscaleImage>(ImageIOError::InvalidDimensions);
+    }
+    if (getFileSize(filepath) != width * height) {
+        return Result<GrayscaleImage>(ImageIOError::InvalidFileSize);
+    }
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return Result<GrayscaleImage>(ImageIOError::ReadError);
+    }
+    GrayscaleImage image(width, height);
+    if (!readBytes(file, image.data(), image.size())) {
+        return Result<GrayscaleImage>(ImageIOError::ReadError);
+    }
+    return Result<GrayscaleImage>(std::move(image));
+}
+
+Result<GrayscaleImage> ImageIO::loadGrayscaleImage(const std::string& filepath) {
+    SOBEL_TRACE_SPAN("loadGrayscaleImage");
+
+    std::ifstream file;
+    PixelLayout layout;
+    if (auto error = openImage(filepath, file, layout)) return Result<GrayscaleImage>(*error);
+
+    GrayscaleImage image(layout.width, layout.height);
+    uint8_t* gray = image.data();
+    const std::size_t w = layout.width;
+    const bool ok = layout.format == ImageFormat::PGM
+                        ? readBytes(file, gray, image.size())
+                        : streamGrayRows(file, layout, [&](std::size_t y) { return gray + y * w; });
+    if (!ok) return Result<GrayscaleImage>(ImageIOError::ReadError);
+    return Result<GrayscaleImage>(std::move(image));
+}
+
+Result<bool> ImageIO::loadGrayFrame(const std::string& filepath, GrayFrame& frame) {
+    SOBEL_TRACE_SPAN("loadGrayFrame");
+
+    std::ifstream file;
+    PixelLayout layout;
+    if (auto error = openImage(filepath, file, layout)) return Result<bool>(*error);
+    if (!streamGrayFrame(file, layout, frame)) return Result<bool>(ImageIOError::ReadError);
+    return Result<bool>(true);
+}
+
+Result<bool> ImageIO::loadGrayFrame(const std::string& filepath, std::size_t width, std::size_t height,
+                                    GrayFrame& frame) {
+    SOBEL_TRACE_SPAN("loadGrayFrame");
+
+    if (!std::filesystem::exists(filepath)) {
+        return Result<bool>(ImageIOError::FileNotFound);
+    }
+    if (width == 0 || height == 0) {
+        return Result<bool>(ImageIOError::InvalidDimensions);
+    }
+    if (!validateRGBFileSize(filepath, width, height)) {
+        return Result<bool>(ImageIOError::InvalidFileSize);
+    }
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return Result<bool>(ImageIOError::ReadError);
+    }
+    PixelLayout layout;
+    layout.width = width;
+    layout.height = height;
+    layout.bitsPerPixel = 24;
+    layout.rowBytes = width * 3;
+    if (!streamGrayFrame(file, layout, frame)) return Result<bool>(ImageIOError::ReadError);
+    return Result<bool>(true);
+}
+
+ImageFormat ImageIO::detectFormat(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    char magic[2] = {};
+    if (!file.read(magic, 2)) return ImageFormat::Raw;
+    if (magic[0] == 'P' && magic[1] == '6') return ImageFormat::PPM;
+    if (magic[0] == 'P' && magic[1] == '5') return ImageFormat::PGM;
+    if (magic[0] == 'B' && magic[1] == 'M') return ImageFormat::BMP;
+    return ImageFormat::Raw;
+}
+
+ImageFormat ImageIO::formatFromExtension(const std::string& filepath) {
+    std::string extension = std::filesystem::path(filepath).extension().string();
+    for (char& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (extension == ".ppm") return ImageFormat::PPM;
+    if (extension == ".pgm") return ImageFormat::PGM;
+    if (extension == ".bmp") return ImageFormat::BMP;
+    return ImageFormat::Raw;
 }
 
 Result<bool> 
 ImageIO::saveGrayscaleImage(const GrayscaleImage& image, const std::string& filepath) {
+    SOBEL_TRACE_SPAN("saveGrayscaleImage");
+
     if (image.empty()) {
         return Result<bool>(ImageIOError::InvalidDimensions);
     }
     
-    // Create output directory if it doesn't exist
-    std::filesystem::path path(filepath);
-    if (path.has_parent_path()) {
-        std::filesystem::create_directories(path.parent_path());
+    // Write grayscale data (creates the output directory if needed)
+    return writeImageFile(filepath, std::string(), image.data(), image.size());
+}
+
+Result<bool>
+ImageIO::saveGrayscaleImage(const GrayscaleImage& image, const std::string& filepath, ImageFormat format) {
+    SOBEL_TRACE_SPAN("saveGrayscaleImage");
+
+    if (image.empty()) {
+        return Result<bool>(ImageIOError::InvalidDimensions);
     }
-    
-    // Open file for binary writing
-    std::ofstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        return Result<bool>(ImageIOError::WriteError);
+    const uint8_t* gray = image.data();
+    switch (format) {
+        case ImageFormat::PGM:
+            return writeImageFile(filepath, pnmHeader('5', image.width(), image.height()), gray, image.size());
+        case ImageFormat::PPM: {
+            std::vector<RGBPixel> rgb(image.size());
+            for (std::size_t i = 0; i < rgb.size(); ++i) rgb[i] = RGBPixel(gray[i], gray[i], gray[i]);
+            return writeImageFile(filepath, pnmHeader('6', image.width(), image.height()), rgb.data(), rgb.size() * 3);
+        }
+        case ImageFormat::BMP:
+            return writeBmp(filepath, image.width(), image.height(), 8, [&](uint8_t* out, std::size_t x, std::size_t y) {
+                *out = gray[y * image.width() + x];
+                return out + 1;
+            });
+        default:
+            return writeImageFile(filepath, std::string(), gray, image.size());
     }
-    
-    // Write grayscale data
-    file.write(reinterpret_cast<const char*>(image.data()), image.size());
-    
-    if (!file.good()) {
-        return Result<bool>(ImageIOError::WriteError);
+}
+
+Result<bool> ImageIO::saveRGBImage(const RGBImage& image, const std::string& filepath, ImageFormat format) {
+    SOBEL_TRACE_SPAN("saveRGBImage");
+
+    if (image.empty()) {
+        return Result<bool>(ImageIOError::InvalidDimensions);
+    }
+    const RGBPixel* pixels = image.data();
+    switch (format) {
+        case ImageFormat::PPM:
+            return writeImageFile(filepath, pnmHeader('6', image.width(), image.height()), pixels, image.size() * 3);
+        case ImageFormat::PGM: {
+            std::vector<uint8_t> gray(image.size());
+            for (std::size_t i = 0; i < gray.size(); ++i) gray[i] = pixels[i].toGrayscale();
+            return writeImageFile(filepath, pnmHeader('5', image.width(), image.height()), gray.data(), gray.size());
+        }
+        case ImageFormat::BMP:
+            return writeBmp(filepath, image.width(), image.height(), 24, [&](uint8_t* out, std::size_t x, std::size_t y) {
+                const RGBPixel& p = pixels[y * image.width() + x];
+                out[0] = p.b;
+                out[1] = p.g;
+                out[2] = p.r;
+                return out + 3;
+            });
+        default:
+            return writeImageFile(filepath, std::string(), pixels, image.size() * 3);
     }
-    
-    return Result<bool>(true);
 }
 
 bool ImageIO::validateRGBFileSize(const std::string& filepath, 
@@ -110,6 +582,10 @@ std::string toString(ImageIOError error) {
             return "Error writing to file";
         case ImageIOError::InvalidDimensions:
             return "Invalid image dimensions";
+        case ImageIOError::InvalidHeader:
+            return "Malformed image header";
+        case ImageIOError::UnsupportedFormat:
+            return "Unsupported image format (expected 8-bit P6/P5 or uncompressed 8/24-bit BMP)";
         default:
             return "Unknown error";
     }
@@ -0,0 +1,111 @@
+/**
+ * @file latency_histogram.cpp
+ * @brief Implementation of the log-linear latency histogram
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace sobel {
+
+namespace {
+
+constexpr uint64_t kSubBucketCount = uint64_t(1) << LatencyHistogram::kSubBucketBits;
+// Exact buckets [0, 2^bits) plus one group of sub-buckets per power of two above
+constexpr std::size_t kBucketCount =
+    static_cast<std::size_t>((LatencyHistogram::kMaxValueBits - LatencyHistogram::kSubBucketBits + 1) * kSubBucketCount);
+
+int highestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) ++bit;
+    return bit;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(std::chrono::nanoseconds deadline)
+    : buckets_(kBucketCount, 0), deadline_(deadline) {}
+
+std::size_t LatencyHistogram::bucketIndex(uint64_t ns) noexcept {
+    if (ns < kSubBucketCount) return static_cast<std::size_t>(ns);
+    const int shift = highestBit(ns) - kSubBucketBits;
+    const std::size_t index = static_cast<std::size_t>(shift + 1) * kSubBucketCount +
+                              static_cast<std::size_t>((ns >> shift) - kSubBucketCount);
+    return std::min(index, kBucketCount - 1);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) noexcept {
+    if (index < kSubBucketCount) return index;
+    const int shift = static_cast<int>(index / kSubBucketCount) - 1;
+    const uint64_t sub = index % kSubBucketCount + kSubBucketCount;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) noexcept {
+    ++buckets_[bucketIndex(ns)];
+    if (count_) {
+        totalDelta_ += static_cast<double>(ns > last_ ? ns - last_ : last_ - ns);
+        min_ = std::min(min_, ns);
+        max_ = std::max(max_, ns);
+    } else {
+        min_ = ns;
+        max_ = ns;
+    }
+    if (ns > static_cast<uint64_t>(deadline_.count())) ++deadlineMisses_;
+    total_ += static_cast<double>(ns);
+    last_ = ns;
+    ++count_;
+}
+
+void LatencyHistogram::reset() noexcept {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    deadlineMisses_ = 0;
+    min_ = 0;
+    max_ = 0;
+    last_ = 0;
+    total_ = 0.0;
+    totalDelta_ = 0.0;
+}
+
+double LatencyHistogram::mean() const noexcept {
+    return count_ ? total_ / static_cast<double>(count_) : 0.0;
+}
+
+double LatencyHistogram::jitter() const noexcept {
+    return count_ > 1 ? totalDelta_ / static_cast<double>(count_ - 1) : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const noexcept {
+    if (count_ == 0) return 0;
+    if (p <= 0.0) return min_;
+    p = std::min(p, 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(count_))));
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) return std::clamp(bucketUpperBound(i), min_, max_);
+    }
+    return max_;
+}
+
+LatencySummary LatencyHistogram::summary() const {
+    LatencySummary s;
+    s.frames = count_;
+    s.deadlineMisses = deadlineMisses_;
+    s.deadlineUs = static_cast<double>(deadline_.count()) / 1e3;
+    s.minUs = static_cast<double>(min()) / 1e3;
+    s.meanUs = mean() / 1e3;
+    s.p50Us = static_cast<double>(percentile(50.0)) / 1e3;
+    s.p99Us = static_cast<double>(percentile(99.0)) / 1e3;
+    s.p999Us = static_cast<double>(percentile(99.9)) / 1e3;
+    s.maxUs = static_cast<double>(max_) / 1e3;
+    s.jitterUs = jitter() / 1e3;
+    return s;
+}
+
+} // namespace sobel
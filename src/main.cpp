@@ -1,7 +1,7 @@
 /**
  * BK Park
  * Sobel Filter Implementation
- * Edge detection using 5x5 Sobel operator for 640x640 RGB images
+ * Edge detection using 5x5 Sobel operator for RGB images of any size
  */
 
 #include "image.hpp"
@@ -11,9 +11,10 @@
 #include <string>
 
 void printUsage(const std::string& programName) {
-    std::cout << "Usage: " << programName << " <input.raw> <output.raw>\n";
-    std::cout << "  input.raw  : 640x640 RGB raw image file (1,228,800 bytes)\n";
-    std::cout << "  output.raw : Output grayscale edge-detected image (409,600 bytes)\n";
+    std::cout << "Usage: " << programName << " <input> <output> [width height]\n";
+    std::cout << "  input  : PPM (P6), PGM (P5) or 8/24-bit BMP; anything else is read as raw RGB\n";
+    std::cout << "           of width x height (default 640x640)\n";
+    std::cout << "  output : Edge map; .pgm, .ppm and .bmp are written with a header, anything else as raw bytes\n";
     std::cout << "\nImplementation features:\n";
     std::cout << "  - 5x5 Sobel kernels for robust edge detection\n";
     std::cout << "  - RGB to grayscale conversion with proper weighting\n";
@@ -25,7 +26,7 @@ int main(int argc, char* argv[]) {
     std::cout << "Sobel Filter - Edge Detection Implementation\n";
     std::cout << "============================================\n";
     
-    if (argc != 3) {
+    if (argc != 3 && argc != 5) {
         printUsage(argv[0]);
         return 1;
     }
@@ -36,11 +37,22 @@ int main(int argc, char* argv[]) {
     std::cout << "Input file: " << inputFile << "\n";
     std::cout << "Output file: " << outputFile << "\n";
     
-    // Load RGB image
-    constexpr std::size_t IMAGE_WIDTH = 640;
-    constexpr std::size_t IMAGE_HEIGHT = 640;
+    // Load RGB image: dimensions come from the header, or from the command line for raw input
+    std::size_t rawWidth = 640;
+    std::size_t rawHeight = 640;
+    if (argc == 5) {
+        try {
+            rawWidth = std::stoul(argv[3]);
+            rawHeight = std::stoul(argv[4]);
+        } catch (const std::exception&) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
     
-    auto result = sobel::ImageIO::loadRGBImage(inputFile, IMAGE_WIDTH, IMAGE_HEIGHT);
+    const bool hasHeader = sobel::ImageIO::detectFormat(inputFile) != sobel::ImageFormat::Raw;
+    auto result = hasHeader ? sobel::ImageIO::loadRGBImage(inputFile)
+                            : sobel::ImageIO::loadRGBImage(inputFile, rawWidth, rawHeight);
     if (!result) {
         std::cerr << "Error loading image: " << toString(result.getError()) << std::endl;
         return 1;
@@ -58,7 +70,8 @@ int main(int argc, char* argv[]) {
     std::cout << "Edge detection completed. Saving output...\n";
     
     // Save edge-detected image
-    auto saveResult = sobel::ImageIO::saveGrayscaleImage(edgeImage, outputFile);
+    auto saveResult = sobel::ImageIO::saveGrayscaleImage(edgeImage, outputFile,
+                                                         sobel::ImageIO::formatFromExtension(outputFile));
     if (!saveResult) {
         std::cerr << "Error saving image: " << toString(saveResult.getError()) << std::endl;
         return 1;
@@ -0,0 +1,68 @@
+/**
+ * @file parallel_for.cpp
+ * @brief Persistent helper threads of sobel::ThreadPool
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "parallel_for.hpp"
+
+namespace sobel {
+
+void ThreadPool::resize(unsigned threads) {
+    const unsigned workers = resolveThreadCount(threads);
+    if (workers == size()) return;
+    stopHelpers();
+    helpers_.reserve(workers - 1);
+    for (unsigned worker = 1; worker < workers; ++worker) {
+        helpers_.emplace_back(&ThreadPool::helperLoop, this, worker, generation_);
+    }
+}
+
+void ThreadPool::dispatch(Task task, void* context, unsigned workers) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = task;
+        context_ = context;
+        active_ = workers;
+        pending_ = workers - 1;
+        ++generation_;
+    }
+    wake_.notify_all();
+    task(context, 0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return pending_ == 0; });
+}
+
+void ThreadPool::helperLoop(unsigned worker, uint64_t generation) {
+    for (;;) {
+        Task task = nullptr;
+        void* context = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != generation; });
+            if (stopping_) return;
+            generation = generation_;
+            if (worker >= active_) continue;   // Fewer items than workers: sit this loop out
+            task = task_;
+            context = context_;
+        }
+        task(context, worker);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) done_.notify_one();
+    }
+}
+
+void ThreadPool::stopHelpers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& helper : helpers_) helper.join();
+    helpers_.clear();
+    stopping_ = false;
+}
+
+} // namespace sobel
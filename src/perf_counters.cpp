@@ -0,0 +1,124 @@
+/**
+ * @file perf_counters.cpp
+ * @brief Implementation of perf_event_open counters
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "perf_counters.hpp"
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace sobel {
+
+namespace {
+
+#if defined(__linux__)
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+EventConfig eventConfig(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles:       return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+        case PerfEvent::Instructions: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+        case PerfEvent::L1DMisses:
+            return {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+        case PerfEvent::LLCMisses:    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+        default:                      return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+    }
+}
+
+int openEvent(PerfEvent event) {
+    const EventConfig ec = eventConfig(event);
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = ec.type;
+    attr.config = ec.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;   // Allowed at perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+} // namespace
+
+const char* perfEventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles:       return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::L1DMisses:    return "L1D misses";
+        case PerfEvent::LLCMisses:    return "LLC misses";
+        case PerfEvent::BranchMisses: return "branch misses";
+        default: return "unknown";
+    }
+}
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+#if defined(__linux__)
+    int firstError = 0;
+    for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+        fds_[i] = openEvent(static_cast<PerfEvent>(i));
+        if (fds_[i] >= 0) ++opened_;
+        else if (!firstError) firstError = errno;
+    }
+    if (opened_ == 0) {
+        reason_ = std::string("perf_event_open failed: ") + std::strerror(firstError);
+        if (firstError == EACCES || firstError == EPERM) reason_ += " (check /proc/sys/kernel/perf_event_paranoid)";
+        else if (firstError == ENOENT || firstError == ENODEV || firstError == EOPNOTSUPP) reason_ += " (no PMU, e.g. inside a VM)";
+    }
+#else
+    reason_ = "perf_event_open is only available on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+void PerfCounters::start() {
+#if defined(__linux__)
+    for (int fd : fds_) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+PerfSample PerfCounters::stop() {
+    PerfSample sample;
+#if defined(__linux__)
+    for (int fd : fds_) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+        if (fds_[i] < 0) continue;
+        uint64_t data[3] = {0, 0, 0};   // value, time enabled, time running
+        if (read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+        // Scale up when the kernel multiplexed this counter with others
+        sample.values[i] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        sample.valid[i] = true;
+    }
+#endif
+    return sample;
+}
+
+} // namespace sobel
@@ -0,0 +1,57 @@
+/**
+ * @file region.cpp
+ * @brief Clipping and merging of regions of interest
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "region.hpp"
+#include <algorithm>
+
+namespace sobel {
+
+namespace {
+
+RegionOfInterest boundingBox(const RegionOfInterest& a, const RegionOfInterest& b) {
+    const std::size_t x = std::min(a.x, b.x);
+    const std::size_t y = std::min(a.y, b.y);
+    return {x, y, std::max(a.right(), b.right()) - x, std::max(a.bottom(), b.bottom()) - y};
+}
+
+} // namespace
+
+std::vector<RegionOfInterest> mergeRegions(const std::vector<RegionOfInterest>& regions,
+                                           std::size_t width, std::size_t height) {
+    std::vector<RegionOfInterest> merged;
+    mergeRegions(regions, width, height, merged);
+    return merged;
+}
+
+void mergeRegions(const std::vector<RegionOfInterest>& regions, std::size_t width, std::size_t height,
+                  std::vector<RegionOfInterest>& merged) {
+    merged.clear();
+    for (RegionOfInterest region : regions) {
+        if (region.x >= width || region.y >= height) continue;
+        region.width = std::min(region.width, width - region.x);
+        region.height = std::min(region.height, height - region.y);
+        if (region.empty()) continue;
+
+        // `merged` never overlaps itself; a grown box may reach regions it missed before
+        for (auto it = merged.begin(); it != merged.end();) {
+            if (it->overlaps(region)) {
+                region = boundingBox(region, *it);
+                merged.erase(it);
+                it = merged.begin();
+            } else {
+                ++it;
+            }
+        }
+        merged.push_back(region);
+    }
+    std::sort(merged.begin(), merged.end(), [](const RegionOfInterest& a, const RegionOfInterest& b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    });
+}
+
+} // namespace sobel
@@ -0,0 +1,1055 @@
+/**
+ * @file sobel_engine.cpp
+ * @brief Implementation of the separable NxN Sobel gradient engine
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "sobel_engine.hpp"
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace sobel {
+
+namespace {
+
+/**
+ * @brief Horizontal results of N <= 5 stay within int16
+ */
+template<int N>
+constexpr bool horizontalFitsInt16() {
+    return SobelCoefficients<N>::maxResponse() <= 32767;
+}
+
+// ITU-R BT.709 weights of RGBPixel::toGrayscale()
+constexpr double kRedWeight = 0.2126;
+constexpr double kGreenWeight = 0.7152;
+constexpr double kBlueWeight = 0.0722;
+
+#if defined(__SSE4_1__) || defined(__AVX2__)
+/**
+ * @brief Channel `c` of 8 packed RGB pixels (24 bytes split over lo/hi) as bytes 0..7
+ */
+inline __m128i rgbChannel8(__m128i lo, __m128i hi, int c) {
+    static const __m128i kLo[3] = {
+        _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+        _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+        _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)};
+    static const __m128i kHi[3] = {
+        _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, -1, -1, -1, -1, -1, -1, -1, -1),
+        _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, -1, -1, -1, -1, -1, -1, -1, -1),
+        _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1)};
+    return _mm_or_si128(_mm_shuffle_epi8(lo, kLo[c]), _mm_shuffle_epi8(hi, kHi[c]));
+}
+
+/**
+ * @brief Byte `c` of 8 four-byte pixels (32 bytes split over lo/hi) as bytes 0..7
+ */
+inline __m128i quadChannel8(__m128i lo, __m128i hi, int c) {
+    static const __m128i kLo[3] = {
+        _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+        _mm_setr_epi8(1, 5, 9, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+        _mm_setr_epi8(2, 6, 10, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)};
+    static const __m128i kHi[3] = {
+        _mm_setr_epi8(-1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1),
+        _mm_setr_epi8(-1, -1, -1, -1, 1, 5, 9, 13, -1, -1, -1, -1, -1, -1, -1, -1),
+        _mm_setr_epi8(-1, -1, -1, -1, 2, 6, 10, 14, -1, -1, -1, -1, -1, -1, -1, -1)};
+    return _mm_or_si128(_mm_shuffle_epi8(lo, kLo[c]), _mm_shuffle_epi8(hi, kHi[c]));
+}
+
+/**
+ * @brief Gray of 2 pixels (int32 lanes 0-1 of r, g, b) in int32 lanes 0-1
+ *
+ * Same operation order as the scalar formula; rounding half away from zero is
+ * trunc(v) + (v - trunc(v) >= 0.5), where the subtraction is exact.
+ */
+inline __m128i grayPairSSE(__m128i r, __m128i g, __m128i b) {
+    const __m128d sum = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(kRedWeight), _mm_cvtepi32_pd(r)),
+                                              _mm_mul_pd(_mm_set1_pd(kGreenWeight), _mm_cvtepi32_pd(g))),
+                                   _mm_mul_pd(_mm_set1_pd(kBlueWeight), _mm_cvtepi32_pd(b)));
+    const __m128d whole = _mm_round_pd(sum, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m128d up = _mm_and_pd(_mm_cmpge_pd(_mm_sub_pd(sum, whole), _mm_set1_pd(0.5)), _mm_set1_pd(1.0));
+    return _mm_cvttpd_epi32(_mm_add_pd(whole, up));
+}
+#endif
+
+#if defined(__AVX2__)
+/**
+ * @brief Gray of 4 pixels (int32 lanes of r, g, b), as grayPairSSE
+ */
+inline __m128i grayQuadAVX2(__m128i r, __m128i g, __m128i b) {
+    const __m256d sum = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(kRedWeight), _mm256_cvtepi32_pd(r)),
+                      _mm256_mul_pd(_mm256_set1_pd(kGreenWeight), _mm256_cvtepi32_pd(g))),
+        _mm256_mul_pd(_mm256_set1_pd(kBlueWeight), _mm256_cvtepi32_pd(b)));
+    const __m256d whole = _mm256_round_pd(sum, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m256d up = _mm256_and_pd(_mm256_cmp_pd(_mm256_sub_pd(sum, whole), _mm256_set1_pd(0.5), _CMP_GE_OQ),
+                                     _mm256_set1_pd(1.0));
+    return _mm256_cvttpd_epi32(_mm256_add_pd(whole, up));
+}
+#endif
+
+// Scalar combination of three channel gradients; the vector versions below follow the same order
+inline float colorMagnitude(ColorGradientMode mode, const float fx[3], const float fy[3]) {
+    if (mode == ColorGradientMode::DiZenzo) {
+        const float gxx = (fx[0] * fx[0] + fx[1] * fx[1]) + fx[2] * fx[2];
+        const float gyy = (fy[0] * fy[0] + fy[1] * fy[1]) + fy[2] * fy[2];
+        const float gxy = (fx[0] * fy[0] + fx[1] * fy[1]) + fx[2] * fy[2];
+        const float d = gxx - gyy;
+        const float e = 2.0f * gxy;
+        return std::sqrt(((gxx + gyy) + std::sqrt(d * d + e * e)) * 0.5f);
+    }
+    float squares[3];
+    for (int c = 0; c < 3; ++c) squares[c] = fx[c] * fx[c] + fy[c] * fy[c];
+    if (mode == ColorGradientMode::MaxMagnitude) {
+        return std::sqrt(std::max(std::max(squares[0], squares[1]), squares[2]));
+    }
+    return std::sqrt((squares[0] + squares[1]) + squares[2]);
+}
+
+#if defined(__SSE4_1__) || defined(__AVX2__)
+inline __m128 colorMagnitudeSSE(ColorGradientMode mode, const __m128 fx[3], const __m128 fy[3]) {
+    auto dot = [](const __m128 a[3], const __m128 b[3]) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], b[0]), _mm_mul_ps(a[1], b[1])), _mm_mul_ps(a[2], b[2]));
+    };
+    if (mode == ColorGradientMode::DiZenzo) {
+        const __m128 gxx = dot(fx, fx);
+        const __m128 gyy = dot(fy, fy);
+        const __m128 gxy = dot(fx, fy);
+        const __m128 d = _mm_sub_ps(gxx, gyy);
+        const __m128 e = _mm_mul_ps(_mm_set1_ps(2.0f), gxy);
+        const __m128 disc = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(d, d), _mm_mul_ps(e, e)));
+        return _mm_sqrt_ps(_mm_mul_ps(_mm_add_ps(_mm_add_ps(gxx, gyy), disc), _mm_set1_ps(0.5f)));
+    }
+    __m128 squares[3];
+    for (int c = 0; c < 3; ++c) squares[c] = _mm_add_ps(_mm_mul_ps(fx[c], fx[c]), _mm_mul_ps(fy[c], fy[c]));
+    if (mode == ColorGradientMode::MaxMagnitude) {
+        return _mm_sqrt_ps(_mm_max_ps(_mm_max_ps(squares[0], squares[1]), squares[2]));
+    }
+    return _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(squares[0], squares[1]), squares[2]));
+}
+#endif
+
+#if defined(__AVX2__)
+inline __m256 colorMagnitudeAVX2(ColorGradientMode mode, const __m256 fx[3], const __m256 fy[3]) {
+    auto dot = [](const __m256 a[3], const __m256 b[3]) {
+        return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a[0], b[0]), _mm256_mul_ps(a[1], b[1])),
+                             _mm256_mul_ps(a[2], b[2]));
+    };
+    if (mode == ColorGradientMode::DiZenzo) {
+        const __m256 gxx = dot(fx, fx);
+        const __m256 gyy = dot(fy, fy);
+        const __m256 gxy = dot(fx, fy);
+        const __m256 d = _mm256_sub_ps(gxx, gyy);
+        const __m256 e = _mm256_mul_ps(_mm256_set1_ps(2.0f), gxy);
+        const __m256 disc = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(d, d), _mm256_mul_ps(e, e)));
+        return _mm256_sqrt_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(gxx, gyy), disc), _mm256_set1_ps(0.5f)));
+    }
+    __m256 squares[3];
+    for (int c = 0; c < 3; ++c) {
+        squares[c] = _mm256_add_ps(_mm256_mul_ps(fx[c], fx[c]), _mm256_mul_ps(fy[c], fy[c]));
+    }
+    if (mode == ColorGradientMode::MaxMagnitude) {
+        return _mm256_sqrt_ps(_mm256_max_ps(_mm256_max_ps(squares[0], squares[1]), squares[2]));
+    }
+    return _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(squares[0], squares[1]), squares[2]));
+}
+#endif
+
+} // namespace
+
+template<int N>
+void SobelEngine<N>::gradientRow(SimdLevel level, const uint8_t* src, std::ptrdiff_t stride,
+                                 std::size_t width, int32_t* gx, int32_t* gy, int16_t* scratch) {
+    switch (level) {
+        case SimdLevel::AVX2: gradientRowAVX2(src, stride, width, gx, gy, scratch); break;
+        case SimdLevel::SSE:  gradientRowSSE(src, stride, width, gx, gy, scratch);  break;
+        default: gradientRowScalar(src, stride, width, gx, gy, scratch); break;
+    }
+}
+
+// Scalar reference: vertical pass into two int16 rows, then horizontal pass
+template<int N>
+void SobelEngine<N>::gradientRowScalar(const uint8_t* src, std::ptrdiff_t stride, std::size_t width,
+                                       int32_t* gx, int32_t* gy, int16_t* scratch) {
+    constexpr auto s = Coefficients::smoothing();
+    constexpr auto d = Coefficients::derivative();
+    constexpr int r = radius;
+
+    const std::size_t length = width + 2 * r;
+    int16_t* vs = scratch;
+    int16_t* vd = scratch + length + kRowSlack;
+    const uint8_t* base = src - r;
+
+    for (std::size_t x = 0; x < length; ++x) {
+        int sumS = 0, sumD = 0;
+        for (int j = 0; j < N; ++j) {
+            const int p = base[(j - r) * stride + static_cast<std::ptrdiff_t>(x)];
+            sumS += s[j] * p;
+            sumD += d[j] * p;
+        }
+        vs[x] = static_cast<int16_t>(sumS);
+        vd[x] = static_cast<int16_t>(sumD);
+    }
+
+    for (std::size_t x = 0; x < width; ++x) {
+        int32_t sumX = 0, sumY = 0;
+        for (int i = 0; i < N; ++i) {
+            sumX += d[i] * vs[x + i];
+            sumY += s[i] * vd[x + i];
+        }
+        gx[x] = sumX;
+        gy[x] = sumY;
+    }
+}
+
+// SSE4.1: 8 columns per iteration, symmetric taps folded before multiplying
+template<int N>
+void SobelEngine<N>::gradientRowSSE(const uint8_t* src, std::ptrdiff_t stride, std::size_t width,
+                                    int32_t* gx, int32_t* gy, int16_t* scratch) {
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    constexpr auto s = Coefficients::smoothing();
+    constexpr auto d = Coefficients::derivative();
+    constexpr int r = radius;
+
+    const std::size_t length = width + 2 * r;
+    int16_t* vs = scratch;
+    int16_t* vd = scratch + length + kRowSlack;
+    const uint8_t* base = src - r;
+
+    for (std::size_t x = 0; x < length; x += 8) {
+        __m128i rows[N];
+        for (int j = 0; j < N; ++j) {
+            rows[j] = _mm_cvtepu8_epi16(_mm_loadl_epi64(
+                reinterpret_cast<const __m128i*>(base + (j - r) * stride + static_cast<std::ptrdiff_t>(x))));
+        }
+        __m128i accS = _mm_mullo_epi16(rows[r], _mm_set1_epi16(static_cast<short>(s[r])));
+        __m128i accD = _mm_setzero_si128();
+        for (int j = 0; j < r; ++j) {
+            const __m128i sum = _mm_add_epi16(rows[j], rows[N - 1 - j]);
+            const __m128i diff = _mm_sub_epi16(rows[N - 1 - j], rows[j]);
+            accS = _mm_add_epi16(accS, _mm_mullo_epi16(sum, _mm_set1_epi16(static_cast<short>(s[j]))));
+            accD = _mm_add_epi16(accD, _mm_mullo_epi16(diff, _mm_set1_epi16(static_cast<short>(d[N - 1 - j]))));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(vs + x), accS);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(vd + x), accD);
+    }
+
+    if constexpr (horizontalFitsInt16<N>()) {
+        for (std::size_t x = 0; x < width; x += 8) {
+            __m128i accX = _mm_setzero_si128();
+            __m128i accY = _mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(vd + x + r)),
+                                           _mm_set1_epi16(static_cast<short>(s[r])));
+            for (int i = 0; i < r; ++i) {
+                const __m128i sl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs + x + i));
+                const __m128i sr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs + x + N - 1 - i));
+                const __m128i dl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vd + x + i));
+                const __m128i dr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vd + x + N - 1 - i));
+                accX = _mm_add_epi16(accX, _mm_mullo_epi16(_mm_sub_epi16(sr, sl),
+                                                           _mm_set1_epi16(static_cast<short>(d[N - 1 - i]))));
+                accY = _mm_add_epi16(accY, _mm_mullo_epi16(_mm_add_epi16(dl, dr),
+                                                           _mm_set1_epi16(static_cast<short>(s[i]))));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gx + x), _mm_cvtepi16_epi32(accX));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gx + x + 4), _mm_cvtepi16_epi32(_mm_srli_si128(accX, 8)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gy + x), _mm_cvtepi16_epi32(accY));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gy + x + 4), _mm_cvtepi16_epi32(_mm_srli_si128(accY, 8)));
+        }
+    } else {
+        auto widen = [](const int16_t* p) {
+            return _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+        };
+        for (std::size_t x = 0; x < width; x += 4) {
+            __m128i accX = _mm_setzero_si128();
+            __m128i accY = _mm_mullo_epi32(widen(vd + x + r), _mm_set1_epi32(s[r]));
+            for (int i = 0; i < r; ++i) {
+                accX = _mm_add_epi32(accX, _mm_mullo_epi32(_mm_sub_epi32(widen(vs + x + N - 1 - i), widen(vs + x + i)),
+                                                           _mm_set1_epi32(d[N - 1 - i])));
+                accY = _mm_add_epi32(accY, _mm_mullo_epi32(_mm_add_epi32(widen(vd + x + i), widen(vd + x + N - 1 - i)),
+                                                           _mm_set1_epi32(s[i])));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gx + x), accX);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gy + x), accY);
+        }
+    }
+#else
+    gradientRowScalar(src, stride, width, gx, gy, scratch);
+#endif
+}
+
+// AVX2: 16 columns per iteration, same structure as the SSE path
+template<int N>
+void SobelEngine<N>::gradientRowAVX2(const uint8_t* src, std::ptrdiff_t stride, std::size_t width,
+                                     int32_t* gx, int32_t* gy, int16_t* scratch) {
+#if defined(__AVX2__)
+    constexpr auto s = Coefficients::smoothing();
+    constexpr auto d = Coefficients::derivative();
+    constexpr int r = radius;
+
+    const std::size_t length = width + 2 * r;
+    int16_t* vs = scratch;
+    int16_t* vd = scratch + length + kRowSlack;
+    const uint8_t* base = src - r;
+
+    for (std::size_t x = 0; x < length; x += 16) {
+        __m256i rows[N];
+        for (int j = 0; j < N; ++j) {
+            rows[j] = _mm256_cvtepu8_epi16(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(base + (j - r) * stride + static_cast<std::ptrdiff_t>(x))));
+        }
+        __m256i accS = _mm256_mullo_epi16(rows[r], _mm256_set1_epi16(static_cast<short>(s[r])));
+        __m256i accD = _mm256_setzero_si256();
+        for (int j = 0; j < r; ++j) {
+            const __m256i sum = _mm256_add_epi16(rows[j], rows[N - 1 - j]);
+            const __m256i diff = _mm256_sub_epi16(rows[N - 1 - j], rows[j]);
+            accS = _mm256_add_epi16(accS, _mm256_mullo_epi16(sum, _mm256_set1_epi16(static_cast<short>(s[j]))));
+            accD = _mm256_add_epi16(accD, _mm256_mullo_epi16(diff, _mm256_set1_epi16(static_cast<short>(d[N - 1 - j]))));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(vs + x), accS);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(vd + x), accD);
+    }
+
+    if constexpr (horizontalFitsInt16<N>()) {
+        for (std::size_t x = 0; x < width; x += 16) {
+            __m256i accX = _mm256_setzero_si256();
+            __m256i accY = _mm256_mullo_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(vd + x + r)),
+                                              _mm256_set1_epi16(static_cast<short>(s[r])));
+            for (int i = 0; i < r; ++i) {
+                const __m256i sl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vs + x + i));
+                const __m256i sr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vs + x + N - 1 - i));
+                const __m256i dl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vd + x + i));
+                const __m256i dr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vd + x + N - 1 - i));
+                accX = _mm256_add_epi16(accX, _mm256_mullo_epi16(_mm256_sub_epi16(sr, sl),
+                                                                 _mm256_set1_epi16(static_cast<short>(d[N - 1 - i]))));
+                accY = _mm256_add_epi16(accY, _mm256_mullo_epi16(_mm256_add_epi16(dl, dr),
+                                                                 _mm256_set1_epi16(static_cast<short>(s[i]))));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gx + x), _mm256_cvtepi16_epi32(_mm256_castsi256_si128(accX)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gx + x + 8), _mm256_cvtepi16_epi32(_mm256_extracti128_si256(accX, 1)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gy + x), _mm256_cvtepi16_epi32(_mm256_castsi256_si128(accY)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gy + x + 8), _mm256_cvtepi16_epi32(_mm256_extracti128_si256(accY, 1)));
+        }
+    } else {
+        auto widen = [](const int16_t* p) {
+            return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        };
+        for (std::size_t x = 0; x < width; x += 8) {
+            __m256i accX = _mm256_setzero_si256();
+            __m256i accY = _mm256_mullo_epi32(widen(vd + x + r), _mm256_set1_epi32(s[r]));
+            for (int i = 0; i < r; ++i) {
+                accX = _mm256_add_epi32(accX, _mm256_mullo_epi32(_mm256_sub_epi32(widen(vs + x + N - 1 - i), widen(vs + x + i)),
+                                                                 _mm256_set1_epi32(d[N - 1 - i])));
+                accY = _mm256_add_epi32(accY, _mm256_mullo_epi32(_mm256_add_epi32(widen(vd + x + i), widen(vd + x + N - 1 - i)),
+                                                                 _mm256_set1_epi32(s[i])));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gx + x), accX);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gy + x), accY);
+        }
+    }
+#else
+    gradientRowSSE(src, stride, width, gx, gy, scratch);
+#endif
+}
+
+template<int N>
+void SobelEngine<N>::gradientRow(SimdLevel level, const uint16_t* src, std::ptrdiff_t stride,
+                                 std::size_t width, int32_t* gx, int32_t* gy, int32_t* scratch) {
+    switch (level) {
+        case SimdLevel::AVX2: gradientRowAVX2(src, stride, width, gx, gy, scratch); break;
+        case SimdLevel::SSE:  gradientRowSSE(src, stride, width, gx, gy, scratch);  break;
+        default: gradientRowScalar(src, stride, width, gx, gy, scratch); break;
+    }
+}
+
+// 16-bit scalar reference: as the 8-bit one with int32 intermediate rows
+template<int N>
+void SobelEngine<N>::gradientRowScalar(const uint16_t* src, std::ptrdiff_t stride, std::size_t width,
+                                       int32_t* gx, int32_t* gy, int32_t* scratch) {
+    constexpr auto s = Coefficients::smoothing();
+    constexpr auto d = Coefficients::derivative();
+    constexpr int r = radius;
+
+    const std::size_t length = width + 2 * r;
+    int32_t* vs = scratch;
+    int32_t* vd = scratch + length + kRowSlack;
+    const uint16_t* base = src - r;
+
+    for (std::size_t x = 0; x < length; ++x) {
+        int32_t sumS = 0, sumD = 0;
+        for (int j = 0; j < N; ++j) {
+            const int32_t p = base[(j - r) * stride + static_cast<std::ptrdiff_t>(x)];
+            sumS += s[j] * p;
+            sumD += d[j] * p;
+        }
+        vs[x] = sumS;
+        vd[x] = sumD;
+    }
+
+    for (std::size_t x = 0; x < width; ++x) {
+        int32_t sumX = 0, sumY = 0;
+        for (int i = 0; i < N; ++i) {
+            sumX += d[i] * vs[x + i];
+            sumY += s[i] * vd[x + i];
+        }
+        gx[x] = sumX;
+        gy[x] = sumY;
+    }
+}
+
+// 16-bit SSE4.1: 4 columns of int32 per iteration, symmetric taps folded as in the 8-bit path
+template<int N>
+void SobelEngine<N>::gradientRowSSE(const uint16_t* src, std::ptrdiff_t stride, std::size_t width,
+                                    int32_t* gx, int32_t* gy, int32_t* scratch) {
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    constexpr auto s = Coefficients::smoothing();
+    constexpr auto d = Coefficients::derivative();
+    constexpr int r = radius;
+
+    const std::size_t length = width + 2 * r;
+    int32_t* vs = scratch;
+    int32_t* vd = scratch + length + kRowSlack;
+    const uint16_t* base = src - r;
+
+    for (std::size_t x = 0; x < length; x += 4) {
+        __m128i rows[N];
+        for (int j = 0; j < N; ++j) {
+            rows[j] = _mm_cvtepu16_epi32(_mm_loadl_epi64(
+                reinterpret_cast<const __m128i*>(base + (j - r) * stride + static_cast<std::ptrdiff_t>(x))));
+        }
+        __m128i accS = _mm_mullo_epi32(rows[r], _mm_set1_epi32(s[r]));
+        __m128i accD = _mm_setzero_si128();
+        for (int j = 0; j < r; ++j) {
+            const __m128i sum = _mm_add_epi32(rows[j], rows[N - 1 - j]);
+            const __m128i diff = _mm_sub_epi32(rows[N - 1 - j], rows[j]);
+            accS = _mm_add_epi32(accS, _mm_mullo_epi32(sum, _mm_set1_epi32(s[j])));
+            accD = _mm_add_epi32(accD, _mm_mullo_epi32(diff, _mm_set1_epi32(d[N - 1 - j])));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(vs + x), accS);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(vd + x), accD);
+    }
+
+    auto load = [](const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+    for (std::size_t x = 0; x < width; x += 4) {
+        __m128i accX = _mm_setzero_si128();
+        __m128i accY = _mm_mullo_epi32(load(vd + x + r), _mm_set1_epi32(s[r]));
+        for (int i = 0; i < r; ++i) {
+            accX = _mm_add_epi32(accX, _mm_mullo_epi32(_mm_sub_epi32(load(vs + x + N - 1 - i), load(vs + x + i)),
+                                                       _mm_set1_epi32(d[N - 1 - i])));
+            accY = _mm_add_epi32(accY, _mm_mullo_epi32(_mm_add_epi32(load(vd + x + i), load(vd + x + N - 1 - i)),
+                                                       _mm_set1_epi32(s[i])));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gx + x), accX);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gy + x), accY);
+    }
+#else
+    gradientRowScalar(src, stride, width, gx, gy, scratch);
+#endif
+}
+
+// 16-bit AVX2: 8 columns of int32 per iteration
+template<int N>
+void SobelEngine<N>::gradientRowAVX2(const uint16_t* src, std::ptrdiff_t stride, std::size_t width,
+                                     int32_t* gx, int32_t* gy, int32_t* scratch) {
+#if defined(__AVX2__)
+    constexpr auto s = Coefficients::smoothing();
+    constexpr auto d = Coefficients::derivative();
+    constexpr int r = radius;
+
+    const std::size_t length = width + 2 * r;
+    int32_t* vs = scratch;
+    int32_t* vd = scratch + length + kRowSlack;
+    const uint16_t* base = src - r;
+
+    for (std::size_t x = 0; x < length; x += 8) {
+        __m256i rows[N];
+        for (int j = 0; j < N; ++j) {
+            rows[j] = _mm256_cvtepu16_epi32(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(base + (j - r) * stride + static_cast<std::ptrdiff_t>(x))));
+        }
+        __m256i accS = _mm256_mullo_epi32(rows[r], _mm256_set1_epi32(s[r]));
+        __m256i accD = _mm256_setzero_si256();
+        for (int j = 0; j < r; ++j) {
+            const __m256i sum = _mm256_add_epi32(rows[j], rows[N - 1 - j]);
+            const __m256i diff = _mm256_sub_epi32(rows[N - 1 - j], rows[j]);
+            accS = _mm256_add_epi32(accS, _mm256_mullo_epi32(sum, _mm256_set1_epi32(s[j])));
+            accD = _mm256_add_epi32(accD, _mm256_mullo_epi32(diff, _mm256_set1_epi32(d[N - 1 - j])));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(vs + x), accS);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(vd + x), accD);
+    }
+
+    auto load = [](const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); };
+    for (std::size_t x = 0; x < width; x += 8) {
+        __m256i accX = _mm256_setzero_si256();
+        __m256i accY = _mm256_mullo_epi32(load(vd + x + r), _mm256_set1_epi32(s[r]));
+        for (int i = 0; i < r; ++i) {
+            accX = _mm256_add_epi32(accX, _mm256_mullo_epi32(_mm256_sub_epi32(load(vs + x + N - 1 - i), load(vs + x + i)),
+                                                             _mm256_set1_epi32(d[N - 1 - i])));
+            accY = _mm256_add_epi32(accY, _mm256_mullo_epi32(_mm256_add_epi32(load(vd + x + i), load(vd + x + N - 1 - i)),
+                                                             _mm256_set1_epi32(s[i])));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(gx + x), accX);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(gy + x), accY);
+    }
+#else
+    gradientRowSSE(src, stride, width, gx, gy, scratch);
+#endif
+}
+
+void magnitudeRow(SimdLevel level, const int32_t* gx, const int32_t* gy, std::size_t width,
+                  float* magnitude, float& minValue, float& maxValue) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2 && width >= 8) {
+        __m256 vmin = _mm256_set1_ps(minValue);
+        __m256 vmax = _mm256_set1_ps(maxValue);
+        for (; x + 8 <= width; x += 8) {
+            const __m256 fx = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(gx + x)));
+            const __m256 fy = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(gy + x)));
+            const __m256 m = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(fx, fx), _mm256_mul_ps(fy, fy)));
+            _mm256_storeu_ps(magnitude + x, m);
+            vmin = _mm256_min_ps(vmin, m);
+            vmax = _mm256_max_ps(vmax, m);
+        }
+        alignas(32) float lo[8], hi[8];
+        _mm256_store_ps(lo, vmin);
+        _mm256_store_ps(hi, vmax);
+        minValue = *std::min_element(lo, lo + 8);
+        maxValue = *std::max_element(hi, hi + 8);
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar && width - x >= 4) {
+        __m128 vmin = _mm_set1_ps(minValue);
+        __m128 vmax = _mm_set1_ps(maxValue);
+        for (; x + 4 <= width; x += 4) {
+            const __m128 fx = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gx + x)));
+            const __m128 fy = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gy + x)));
+            const __m128 m = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(fx, fx), _mm_mul_ps(fy, fy)));
+            _mm_storeu_ps(magnitude + x, m);
+            vmin = _mm_min_ps(vmin, m);
+            vmax = _mm_max_ps(vmax, m);
+        }
+        alignas(16) float lo[4], hi[4];
+        _mm_store_ps(lo, vmin);
+        _mm_store_ps(hi, vmax);
+        minValue = *std::min_element(lo, lo + 4);
+        maxValue = *std::max_element(hi, hi + 4);
+    }
+#endif
+    for (; x < width; ++x) {
+        const float fx = static_cast<float>(gx[x]);
+        const float fy = static_cast<float>(gy[x]);
+        const float m = std::sqrt(fx * fx + fy * fy);
+        magnitude[x] = m;
+        minValue = std::min(minValue, m);
+        maxValue = std::max(maxValue, m);
+    }
+}
+
+void packedToGrayRow(SimdLevel level, PixelFormat format, const uint8_t* pixels, std::size_t width,
+                     uint8_t* gray) {
+    (void)level;
+    const std::size_t bytes = pixelFormatBytes(format);
+    const int red = static_cast<int>(pixelFormatRedOffset(format));
+    std::size_t x = 0;
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        for (; x + 8 <= width; x += 8) {
+            const uint8_t* src = pixels + bytes * x;
+            __m128i r, g, b;
+            if (bytes == 4) {
+                const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+                r = quadChannel8(lo, hi, red);
+                g = quadChannel8(lo, hi, 1);
+                b = quadChannel8(lo, hi, 2 - red);
+            } else {
+                const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                const __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 16));
+                r = rgbChannel8(lo, hi, red);
+                g = rgbChannel8(lo, hi, 1);
+                b = rgbChannel8(lo, hi, 2 - red);
+            }
+            // Byte shifts take immediates, so the upper four pixels are split off up front
+            const __m128i rs[2] = {r, _mm_srli_si128(r, 4)};
+            const __m128i gs[2] = {g, _mm_srli_si128(g, 4)};
+            const __m128i bs[2] = {b, _mm_srli_si128(b, 4)};
+            __m128i quads[2];
+            for (int q = 0; q < 2; ++q) {
+                const __m128i r4 = _mm_cvtepu8_epi32(rs[q]);
+                const __m128i g4 = _mm_cvtepu8_epi32(gs[q]);
+                const __m128i b4 = _mm_cvtepu8_epi32(bs[q]);
+#if defined(__AVX2__)
+                if (level == SimdLevel::AVX2) {
+                    quads[q] = grayQuadAVX2(r4, g4, b4);
+                    continue;
+                }
+#endif
+                quads[q] = _mm_unpacklo_epi64(grayPairSSE(r4, g4, b4),
+                                              grayPairSSE(_mm_srli_si128(r4, 8), _mm_srli_si128(g4, 8),
+                                                          _mm_srli_si128(b4, 8)));
+            }
+            const __m128i words = _mm_packs_epi32(quads[0], quads[1]);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(gray + x), _mm_packus_epi16(words, words));
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        const uint8_t* p = pixels + bytes * x;
+        const double value = kRedWeight * p[red] + kGreenWeight * p[1] + kBlueWeight * p[2 - red];
+        gray[x] = static_cast<uint8_t>(std::round(std::clamp(value, 0.0, 255.0)));
+    }
+}
+
+void rgbToGrayRow(SimdLevel level, const uint8_t* rgb, std::size_t width, uint8_t* gray) {
+    packedToGrayRow(level, PixelFormat::RGB, rgb, width, gray);
+}
+
+void rgb16ToGrayRow(SimdLevel level, const uint16_t* rgb, std::size_t width, uint16_t* gray) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        // Samples of 4 pixels (24 bytes over lo/hi) zero-extended into int32 lanes
+        const __m128i loR = _mm_setr_epi8(0, 1, -1, -1, 6, 7, -1, -1, 12, 13, -1, -1, -1, -1, -1, -1);
+        const __m128i hiR = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 3, -1, -1);
+        const __m128i loG = _mm_setr_epi8(2, 3, -1, -1, 8, 9, -1, -1, 14, 15, -1, -1, -1, -1, -1, -1);
+        const __m128i hiG = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 4, 5, -1, -1);
+        const __m128i loB = _mm_setr_epi8(4, 5, -1, -1, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i hiB = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 0, 1, -1, -1, 6, 7, -1, -1);
+        for (; x + 4 <= width; x += 4) {
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * x));
+            const __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rgb + 3 * x + 8));
+            const __m128i r = _mm_or_si128(_mm_shuffle_epi8(lo, loR), _mm_shuffle_epi8(hi, hiR));
+            const __m128i g = _mm_or_si128(_mm_shuffle_epi8(lo, loG), _mm_shuffle_epi8(hi, hiG));
+            const __m128i b = _mm_or_si128(_mm_shuffle_epi8(lo, loB), _mm_shuffle_epi8(hi, hiB));
+            __m128i quad;
+#if defined(__AVX2__)
+            if (level == SimdLevel::AVX2) {
+                quad = grayQuadAVX2(r, g, b);
+            } else
+#endif
+            {
+                quad = _mm_unpacklo_epi64(grayPairSSE(r, g, b), grayPairSSE(_mm_srli_si128(r, 8), _mm_srli_si128(g, 8),
+                                                                            _mm_srli_si128(b, 8)));
+            }
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(gray + x), _mm_packus_epi32(quad, quad));
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        const uint16_t* p = rgb + 3 * x;
+        const double value = kRedWeight * p[0] + kGreenWeight * p[1] + kBlueWeight * p[2];
+        gray[x] = static_cast<uint16_t>(std::round(std::clamp(value, 0.0, 65535.0)));
+    }
+}
+
+void deinterleaveRow(SimdLevel level, PixelFormat format, const uint8_t* pixels, std::size_t width,
+                     uint8_t* const channels[3]) {
+    (void)level;
+    const std::size_t bytes = pixelFormatBytes(format);
+    const int red = static_cast<int>(pixelFormatRedOffset(format));
+    const int offsets[3] = {red, 1, 2 - red};
+    std::size_t x = 0;
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        for (; x + 8 <= width; x += 8) {
+            const uint8_t* src = pixels + bytes * x;
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i hi = bytes == 4 ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16))
+                                          : _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 16));
+            for (int c = 0; c < 3; ++c) {
+                const __m128i channel = bytes == 4 ? quadChannel8(lo, hi, offsets[c]) : rgbChannel8(lo, hi, offsets[c]);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(channels[c] + x), channel);
+            }
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        for (int c = 0; c < 3; ++c) channels[c][x] = pixels[bytes * x + offsets[c]];
+    }
+}
+
+void colorMagnitudeRow(SimdLevel level, ColorGradientMode mode, const int32_t* const gx[3],
+                       const int32_t* const gy[3], std::size_t width, float* magnitude,
+                       float& minValue, float& maxValue) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2 && width >= 8) {
+        __m256 vmin = _mm256_set1_ps(minValue);
+        __m256 vmax = _mm256_set1_ps(maxValue);
+        for (; x + 8 <= width; x += 8) {
+            __m256 fx[3], fy[3];
+            for (int c = 0; c < 3; ++c) {
+                fx[c] = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(gx[c] + x)));
+                fy[c] = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(gy[c] + x)));
+            }
+            const __m256 m = colorMagnitudeAVX2(mode, fx, fy);
+            _mm256_storeu_ps(magnitude + x, m);
+            vmin = _mm256_min_ps(vmin, m);
+            vmax = _mm256_max_ps(vmax, m);
+        }
+        alignas(32) float lo[8], hi[8];
+        _mm256_store_ps(lo, vmin);
+        _mm256_store_ps(hi, vmax);
+        minValue = *std::min_element(lo, lo + 8);
+        maxValue = *std::max_element(hi, hi + 8);
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar && width - x >= 4) {
+        __m128 vmin = _mm_set1_ps(minValue);
+        __m128 vmax = _mm_set1_ps(maxValue);
+        for (; x + 4 <= width; x += 4) {
+            __m128 fx[3], fy[3];
+            for (int c = 0; c < 3; ++c) {
+                fx[c] = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gx[c] + x)));
+                fy[c] = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gy[c] + x)));
+            }
+            const __m128 m = colorMagnitudeSSE(mode, fx, fy);
+            _mm_storeu_ps(magnitude + x, m);
+            vmin = _mm_min_ps(vmin, m);
+            vmax = _mm_max_ps(vmax, m);
+        }
+        alignas(16) float lo[4], hi[4];
+        _mm_store_ps(lo, vmin);
+        _mm_store_ps(hi, vmax);
+        minValue = *std::min_element(lo, lo + 4);
+        maxValue = *std::max_element(hi, hi + 4);
+    }
+#endif
+    for (; x < width; ++x) {
+        float fx[3], fy[3];
+        for (int c = 0; c < 3; ++c) {
+            fx[c] = static_cast<float>(gx[c][x]);
+            fy[c] = static_cast<float>(gy[c][x]);
+        }
+        const float m = colorMagnitude(mode, fx, fy);
+        magnitude[x] = m;
+        minValue = std::min(minValue, m);
+        maxValue = std::max(maxValue, m);
+    }
+}
+
+void dominantGradientRow(SimdLevel level, const int32_t* const gx[3], const int32_t* const gy[3],
+                         std::size_t width, int32_t* gxOut, int32_t* gyOut) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        auto load = [](const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+        auto energy = [](__m128i a, __m128i b) {
+            const __m128 fa = _mm_cvtepi32_ps(a);
+            const __m128 fb = _mm_cvtepi32_ps(b);
+            return _mm_add_ps(_mm_mul_ps(fa, fa), _mm_mul_ps(fb, fb));
+        };
+        for (; x + 4 <= width; x += 4) {
+            __m128i bestX = load(gx[0] + x);
+            __m128i bestY = load(gy[0] + x);
+            __m128 best = energy(bestX, bestY);
+            for (int c = 1; c < 3; ++c) {
+                const __m128i cx = load(gx[c] + x);
+                const __m128i cy = load(gy[c] + x);
+                const __m128 e = energy(cx, cy);
+                const __m128 larger = _mm_cmpgt_ps(e, best);
+                best = _mm_blendv_ps(best, e, larger);
+                bestX = _mm_blendv_epi8(bestX, cx, _mm_castps_si128(larger));
+                bestY = _mm_blendv_epi8(bestY, cy, _mm_castps_si128(larger));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gxOut + x), bestX);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gyOut + x), bestY);
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        int best = 0;
+        float bestEnergy = 0.0f;
+        for (int c = 0; c < 3; ++c) {
+            const float fx = static_cast<float>(gx[c][x]);
+            const float fy = static_cast<float>(gy[c][x]);
+            const float e = fx * fx + fy * fy;
+            if (c == 0 || e > bestEnergy) {
+                best = c;
+                bestEnergy = e;
+            }
+        }
+        gxOut[x] = gx[best][x];
+        gyOut[x] = gy[best][x];
+    }
+}
+
+void magnitudeL1Row(SimdLevel level, const int32_t* gx, const int32_t* gy, std::size_t width,
+                    float* magnitude, float& minValue, float& maxValue) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2 && width >= 8) {
+        __m256 vmin = _mm256_set1_ps(minValue);
+        __m256 vmax = _mm256_set1_ps(maxValue);
+        for (; x + 8 <= width; x += 8) {
+            const __m256i ax = _mm256_abs_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(gx + x)));
+            const __m256i ay = _mm256_abs_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(gy + x)));
+            const __m256 m = _mm256_cvtepi32_ps(_mm256_add_epi32(ax, ay));
+            _mm256_storeu_ps(magnitude + x, m);
+            vmin = _mm256_min_ps(vmin, m);
+            vmax = _mm256_max_ps(vmax, m);
+        }
+        alignas(32) float lo[8], hi[8];
+        _mm256_store_ps(lo, vmin);
+        _mm256_store_ps(hi, vmax);
+        minValue = *std::min_element(lo, lo + 8);
+        maxValue = *std::max_element(hi, hi + 8);
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar && width - x >= 4) {
+        __m128 vmin = _mm_set1_ps(minValue);
+        __m128 vmax = _mm_set1_ps(maxValue);
+        for (; x + 4 <= width; x += 4) {
+            const __m128i ax = _mm_abs_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gx + x)));
+            const __m128i ay = _mm_abs_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gy + x)));
+            const __m128 m = _mm_cvtepi32_ps(_mm_add_epi32(ax, ay));
+            _mm_storeu_ps(magnitude + x, m);
+            vmin = _mm_min_ps(vmin, m);
+            vmax = _mm_max_ps(vmax, m);
+        }
+        alignas(16) float lo[4], hi[4];
+        _mm_store_ps(lo, vmin);
+        _mm_store_ps(hi, vmax);
+        minValue = *std::min_element(lo, lo + 4);
+        maxValue = *std::max_element(hi, hi + 4);
+    }
+#endif
+    for (; x < width; ++x) {
+        const float m = static_cast<float>(std::abs(gx[x]) + std::abs(gy[x]));
+        magnitude[x] = m;
+        minValue = std::min(minValue, m);
+        maxValue = std::max(maxValue, m);
+    }
+}
+
+void quantizeMagnitudes(SimdLevel level, const float* magnitude, std::size_t count,
+                        float offset, float scale, uint8_t* output) {
+    (void)level;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        const __m256 vOffset = _mm256_set1_ps(offset);
+        const __m256 vScale = _mm256_set1_ps(scale);
+        const __m256 vZero = _mm256_setzero_ps();
+        const __m256 vMax = _mm256_set1_ps(255.0f);
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        auto convert = [&](const float* p) {
+            __m256 v = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(p), vOffset), vScale);
+            v = _mm256_min_ps(_mm256_max_ps(v, vZero), vMax);
+            return _mm256_cvttps_epi32(v);
+        };
+        for (; i + 32 <= count; i += 32) {
+            const __m256i a = _mm256_packs_epi32(convert(magnitude + i), convert(magnitude + i + 8));
+            const __m256i b = _mm256_packs_epi32(convert(magnitude + i + 16), convert(magnitude + i + 24));
+            const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(a, b), order);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        const __m128 vOffset = _mm_set1_ps(offset);
+        const __m128 vScale = _mm_set1_ps(scale);
+        const __m128 vZero = _mm_setzero_ps();
+        const __m128 vMax = _mm_set1_ps(255.0f);
+        auto convert = [&](const float* p) {
+            __m128 v = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p), vOffset), vScale);
+            v = _mm_min_ps(_mm_max_ps(v, vZero), vMax);
+            return _mm_cvttps_epi32(v);
+        };
+        for (; i + 16 <= count; i += 16) {
+            const __m128i a = _mm_packs_epi32(convert(magnitude + i), convert(magnitude + i + 4));
+            const __m128i b = _mm_packs_epi32(convert(magnitude + i + 8), convert(magnitude + i + 12));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi16(a, b));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const float v = (magnitude[i] - offset) * scale;
+        output[i] = static_cast<uint8_t>(std::clamp(v, 0.0f, 255.0f));
+    }
+}
+
+void narrowToInt16(SimdLevel level, const int32_t* input, std::size_t count, int16_t* output) {
+    (void)level;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        for (; i + 16 <= count; i += 16) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i + 8));
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        for (; i + 8 <= count; i += 8) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(a, b));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        output[i] = static_cast<int16_t>(std::clamp(input[i], int32_t(-32768), int32_t(32767)));
+    }
+}
+
+void upsampleRow2x(SimdLevel level, const uint8_t* src, std::size_t width, uint8_t* dst) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        for (; x + 64 <= width; x += 64) {
+            // Qwords 0,2,1,3 so the in-lane unpacks emit source bytes 0-15 and 16-31 in order
+            const __m256i v = _mm256_permute4x64_epi64(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x / 2)), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_unpacklo_epi8(v, v));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x + 32), _mm256_unpackhi_epi8(v, v));
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        for (; x + 32 <= width; x += 32) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x / 2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_unpacklo_epi8(v, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 16), _mm_unpackhi_epi8(v, v));
+        }
+    }
+#endif
+    for (; x < width; ++x) dst[x] = src[x / 2];
+}
+
+void downsampleRow2x(SimdLevel level, const uint8_t* top, const uint8_t* bottom, std::size_t width, uint8_t* dst) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        const __m256i ones = _mm256_set1_epi8(1);
+        const __m256i two = _mm256_set1_epi16(2);
+        const std::size_t pairs = width / 2;   // Output pixels with two source columns
+        auto pairSums = [&](const uint8_t* row) {
+            return _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row)), ones);
+        };
+        for (; x + 32 <= pairs; x += 32) {
+            const __m256i lo = _mm256_srli_epi16(
+                _mm256_add_epi16(_mm256_add_epi16(pairSums(top + 2 * x), pairSums(bottom + 2 * x)), two), 2);
+            const __m256i hi = _mm256_srli_epi16(
+                _mm256_add_epi16(_mm256_add_epi16(pairSums(top + 2 * x + 32), pairSums(bottom + 2 * x + 32)), two), 2);
+            // The in-lane pack leaves qwords as lo0 hi0 lo1 hi1; reorder to lo0 lo1 hi0 hi1
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x),
+                                _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8));
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        const __m128i ones = _mm_set1_epi8(1);
+        const __m128i two = _mm_set1_epi16(2);
+        const std::size_t pairs = width / 2;
+        auto pairSums = [&](const uint8_t* row) {
+            return _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row)), ones);
+        };
+        for (; x + 16 <= pairs; x += 16) {
+            const __m128i lo = _mm_srli_epi16(
+                _mm_add_epi16(_mm_add_epi16(pairSums(top + 2 * x), pairSums(bottom + 2 * x)), two), 2);
+            const __m128i hi = _mm_srli_epi16(
+                _mm_add_epi16(_mm_add_epi16(pairSums(top + 2 * x + 16), pairSums(bottom + 2 * x + 16)), two), 2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+    for (; x < (width + 1) / 2; ++x) {
+        const std::size_t x0 = 2 * x;
+        const std::size_t x1 = std::min(x0 + 1, width - 1);
+        dst[x] = static_cast<uint8_t>((top[x0] + top[x1] + bottom[x0] + bottom[x1] + 2) >> 2);
+    }
+}
+
+void yuyvToGrayRow(SimdLevel level, const uint8_t* yuyv, std::size_t width, uint8_t* gray) {
+    (void)level;
+    std::size_t x = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        const __m256i lumaMask = _mm256_set1_epi16(0x00FF);
+        for (; x + 32 <= width; x += 32) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(yuyv + 2 * x));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(yuyv + 2 * x + 32));
+            // The in-lane pack leaves qwords as a0 b0 a1 b1; reorder to a0 a1 b0 b1
+            const __m256i packed = _mm256_packus_epi16(_mm256_and_si256(a, lumaMask), _mm256_and_si256(b, lumaMask));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gray + x), _mm256_permute4x64_epi64(packed, 0xD8));
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        const __m128i evenBytes = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+        for (; x + 16 <= width; x += 16) {
+            const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(yuyv + 2 * x)),
+                                               evenBytes);
+            const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(yuyv + 2 * x + 16)),
+                                               evenBytes);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gray + x), _mm_unpacklo_epi64(a, b));
+        }
+    }
+#endif
+    for (; x < width; ++x) gray[x] = yuyv[2 * x];
+}
+
+bool isSimdLevelCompiled(SimdLevel level) {
+    switch (level) {
+#if defined(__AVX2__)
+        case SimdLevel::AVX2: return true;
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+        case SimdLevel::SSE: return true;
+#endif
+        case SimdLevel::Scalar: return true;
+        default: return false;
+    }
+}
+
+SimdLevel detectSimdLevel() {
+    bool avx2 = false, sse41 = false;
+#if defined(_MSC_VER)
+    int cpuInfo[4] = {0};
+    __cpuid(cpuInfo, 1);
+    sse41 = (cpuInfo[2] & (1 << 19)) != 0;
+    if ((cpuInfo[2] & (1 << 28)) != 0) {
+        __cpuidex(cpuInfo, 7, 0);
+        avx2 = (cpuInfo[1] & (1 << 5)) != 0;
+    }
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    sse41 = __builtin_cpu_supports("sse4.1");
+    avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2 && isSimdLevelCompiled(SimdLevel::AVX2)) return SimdLevel::AVX2;
+    if (sse41 && isSimdLevelCompiled(SimdLevel::SSE)) return SimdLevel::SSE;
+    return SimdLevel::Scalar;
+}
+
+// Explicit template instantiations for the supported kernel sizes
+template class SobelEngine<3>;
+template class SobelEngine<5>;
+template class SobelEngine<7>;
+
+} // namespace sobel
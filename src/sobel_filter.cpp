@@ -7,38 +7,41 @@
  */
 
 #include "sobel_filter.hpp"
+#include "allocation_tracker.hpp"
 #include <cmath>
 #include <algorithm>
-#include <limits>
+#include <stdexcept>
 
 namespace sobel {
 
-// 5x5 Sobel kernels for more accurate edge detection
-const SobelKernel5x5 SOBEL_X_5x5 = {{
-    {{-1, -2,  0,  2,  1}},
-    {{-4, -8,  0,  8,  4}},
-    {{-6, -12, 0, 12,  6}},
-    {{-4, -8,  0,  8,  4}},
-    {{-1, -2,  0,  2,  1}}
-}};
-
-const SobelKernel5x5 SOBEL_Y_5x5 = {{
-    {{-1, -4, -6, -4, -1}},
-    {{-2, -8, -12, -8, -2}},
-    {{ 0,  0,  0,  0,  0}},
-    {{ 2,  8, 12,  8,  2}},
-    {{ 1,  4,  6,  4,  1}}
-}};
-
-SobelFilter::SobelFilter(const SobelConfig& config) : config_(config) {}
+// 5x5 Sobel kernels generated from binomial coefficients at compile time
+constexpr SobelKernel5x5 SOBEL_X_5x5 = makeSobelKernelX<5>();
+constexpr SobelKernel5x5 SOBEL_Y_5x5 = makeSobelKernelY<5>();
+
+namespace {
+
+void validateKernelSize(int kernel_size) {
+    if (kernel_size != 3 && kernel_size != 5 && kernel_size != 7) {
+        throw std::invalid_argument("Sobel kernel size must be 3, 5 or 7");
+    }
+}
+
+} // namespace
+
+SobelFilter::SobelFilter(const SobelConfig& config) : config_(config) {
+    validateKernelSize(config_.kernel_size);
+}
 
 GrayscaleImage SobelFilter::apply(const RGBImage& input) const {
     // Convert RGB to grayscale first
-    GrayscaleImage grayscale(input.width(), input.height());
-    
-    for (std::size_t y = 0; y < input.height(); ++y) {
-        for (std::size_t x = 0; x < input.width(); ++x) {
-            grayscale.setPixel(x, y, input.at(x, y).toGrayscale());
+    GrayscaleImage grayscale;
+    {
+        SOBEL_ALLOC_STAGE(PipelineStage::GrayConversion);
+        grayscale.resize(input.width(), input.height());
+        for (std::size_t y = 0; y < input.height(); ++y) {
+            for (std::size_t x = 0; x < input.width(); ++x) {
+                grayscale.setPixel(x, y, input.at(x, y).toGrayscale());
+            }
         }
     }
     
@@ -53,17 +56,30 @@ GrayscaleImage SobelFilter::apply(const GrayscaleImage& input) const {
     const std::size_t width = input.width();
     const std::size_t height = input.height();
     
-    // Apply convolution with both kernels
-    auto gx = convolve(input, SOBEL_X_5x5);
-    auto gy = convolve(input, SOBEL_Y_5x5);
+    // Stages attribute their allocations for memory accounting (see allocation_tracker.hpp)
+    std::vector<int32_t> gx, gy;
+    {
+        SOBEL_ALLOC_STAGE(PipelineStage::Convolution);
+        gx = convolve(input, kernelX());
+        gy = convolve(input, kernelY());
+    }
     
     // Calculate gradient magnitudes
-    auto magnitudes = calculateMagnitude(gx, gy, width, height);
+    std::vector<double> magnitudes;
+    {
+        SOBEL_ALLOC_STAGE(PipelineStage::Magnitude);
+        magnitudes = calculateMagnitude(gx, gy, width, height);
+    }
     
     // Apply quantization
-    auto quantized = quantize(magnitudes);
+    std::vector<uint8_t> quantized;
+    {
+        SOBEL_ALLOC_STAGE(PipelineStage::Quantization);
+        quantized = quantize(magnitudes);
+    }
     
     // Create output image
+    SOBEL_ALLOC_STAGE(PipelineStage::Output);
     GrayscaleImage result(width, height);
     for (std::size_t i = 0; i < quantized.size(); ++i) {
         std::size_t x = i % width;
@@ -83,53 +99,19 @@ const SobelKernel5x5& SobelFilter::getKernelY() {
 }
 
 void SobelFilter::setConfig(const SobelConfig& config) {
+    validateKernelSize(config.kernel_size);
     config_ = config;
 }
 
-std::vector<int16_t> SobelFilter::convolve(const GrayscaleImage& image, 
-                                          const SobelKernel5x5& kernel) const {
-    const std::size_t width = image.width();
-    const std::size_t height = image.height();
-    const int kernel_size = 5;
-    const int kernel_half = kernel_size / 2;
-    
-    std::vector<int16_t> result(width * height, 0);
-    
-    for (std::size_t y = 0; y < height; ++y) {
-        for (std::size_t x = 0; x < width; ++x) {
-            int32_t sum = 0;
-            
-            // Apply 5x5 kernel with edge replication instead of zero-padding
-            for (int ky = -kernel_half; ky <= kernel_half; ++ky) {
-                for (int kx = -kernel_half; kx <= kernel_half; ++kx) {
-                    // Use edge replication instead of zero padding
-                    int px = static_cast<int>(x) + kx;
-                    int py = static_cast<int>(y) + ky;
-                    
-                    // Clamp coordinates to image boundaries (edge replication)
-                    px = std::max(0, std::min(px, static_cast<int>(width) - 1));
-                    py = std::max(0, std::min(py, static_cast<int>(height) - 1));
-                    
-                    uint8_t pixel_value = image.at(px, py);
-                    int kernel_value = kernel[ky + kernel_half][kx + kernel_half];
-                    sum += pixel_value * kernel_value;
-                }
-            }
-            
-            // Clamp to int16_t range to prevent overflow
-            sum = std::clamp(sum, 
-                            static_cast<int32_t>(std::numeric_limits<int16_t>::min()), 
-                            static_cast<int32_t>(std::numeric_limits<int16_t>::max()));
-            
-            result[y * width + x] = static_cast<int16_t>(sum);
-        }
-    }
-    
-    return result;
+std::vector<int32_t> SobelFilter::convolve(const GrayscaleImage& image, 
+                                          const ConvolutionKernel& kernel) const {
+    // Kernel analysis picks the separable path for Sobel; border mode from config
+    static const SimdLevel level = detectSimdLevel();
+    return ConvolutionEngine(kernel).convolve(image, config_.border_mode, level);
 }
 
-std::vector<double> SobelFilter::calculateMagnitude(const std::vector<int16_t>& gx,
-                                                   const std::vector<int16_t>& gy,
+std::vector<double> SobelFilter::calculateMagnitude(const std::vector<int32_t>& gx,
+                                                   const std::vector<int32_t>& gy,
                                                    std::size_t width,
                                                    std::size_t height) const {
     std::vector<double> magnitudes(width * height);
@@ -1,230 +1,1217 @@
 #include "sobel_filter_simd.hpp"
+#include "convolution_engine.hpp"
+#include "tracer.hpp"
 #include <immintrin.h>
+#ifdef _MSC_VER
 #include <intrin.h>
+#endif
 #include <sstream>
 #include <cstdlib>
-#include <cstring>
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace {
+
+void validateKernelSize(int kernelSize) {
+    if (kernelSize != 3 && kernelSize != 5 && kernelSize != 7) {
+        throw std::invalid_argument("Sobel kernel size must be 3, 5 or 7");
+    }
+}
+
+sobel::PackedImageView rgbView(const sobel::RGBImage& image) {
+    return {sobel::PixelFormat::RGB, reinterpret_cast<const uint8_t*>(image.data()), image.width(), image.height(), 0};
+}
+
+void validateOutputStrides(const SobelFilterSIMD::OutputDescriptor& outputs, size_t width) {
+    for (size_t stride : {outputs.gxStride, outputs.gyStride, outputs.magnitudeStride, outputs.edgesStride}) {
+        if (stride != 0 && stride < width) {
+            throw std::invalid_argument("Output stride must be at least the image width");
+        }
+    }
+}
+
+// Row stages run on a sub-size of the allocated frame until the end of the scope
+struct LogicalSize {
+    size_t& width;
+    size_t& height;
+    size_t savedWidth, savedHeight;
+    LogicalSize(size_t& w, size_t& h) : width(w), height(h), savedWidth(w), savedHeight(h) {}
+    ~LogicalSize() { width = savedWidth; height = savedHeight; }
+};
+
+} // namespace
 
 SobelFilterSIMD::SobelFilterSIMD(OptimizationLevel level) : config_(), optimizationLevel_(level) {
     if (optimizationLevel_ == OptimizationLevel::AUTO) {
-        std::string caps = getCPUCapabilities();
-        if (caps.find("AVX2") != std::string::npos) optimizationLevel_ = OptimizationLevel::AVX2;
-        else if (caps.find("SSE4.1") != std::string::npos) optimizationLevel_ = OptimizationLevel::SSE;
-        else optimizationLevel_ = OptimizationLevel::SCALAR;
+        resolveAutoLevel();
     }
 }
 
 SobelFilterSIMD::SobelFilterSIMD(const sobel::SobelConfig& config, OptimizationLevel level) 
     : config_(config), optimizationLevel_(level) {
+    validateKernelSize(config_.kernel_size);
     if (optimizationLevel_ == OptimizationLevel::AUTO) {
-        std::string caps = getCPUCapabilities();
-        if (caps.find("AVX2") != std::string::npos) optimizationLevel_ = OptimizationLevel::AVX2;
-        else if (caps.find("SSE4.1") != std::string::npos) optimizationLevel_ = OptimizationLevel::SSE;
-        else optimizationLevel_ = OptimizationLevel::SCALAR;
+        resolveAutoLevel();
     }
 }
 
-// Aligned allocation helpers
-void* SobelFilterSIMD::alignedAlloc(size_t bytes, size_t alignment) {
-#if defined(_MSC_VER)
-    return _aligned_malloc(bytes, alignment);
-#else
-    void* p = nullptr;
-    if (posix_memalign(&p, alignment, bytes) != 0) return nullptr;
-    return p;
-#endif
+// AUTO starts from the best level the CPU features allow; wisdom may refine it per resolution
+void SobelFilterSIMD::resolveAutoLevel() {
+    std::string caps = getCPUCapabilities();
+    if (caps.find("AVX2") != std::string::npos) featureLevel_ = OptimizationLevel::AVX2;
+    else if (caps.find("SSE4.1") != std::string::npos) featureLevel_ = OptimizationLevel::SSE;
+    else featureLevel_ = OptimizationLevel::SCALAR;
+    optimizationLevel_ = featureLevel_;
+    autoTuning_ = true;
 }
 
-void SobelFilterSIMD::alignedDeleter(void* p) {
-    if (!p) return;
-#if defined(_MSC_VER)
-    _aligned_free(p);
-#else
-    free(p);
-#endif
+void SobelFilterSIMD::applyWisdom(size_t width, size_t height) {
+    sobel::TuningParameters tuning;
+    if (auto wisdom = sobel::lookupWisdom(width, height)) {
+        tuning = *wisdom;
+    } else {
+        tuning.level = featureLevel_ == OptimizationLevel::AVX2 ? sobel::SimdLevel::AVX2
+                     : featureLevel_ == OptimizationLevel::SSE  ? sobel::SimdLevel::SSE
+                                                                : sobel::SimdLevel::Scalar;
+    }
+    setTuning(tuning);
+    autoTuning_ = true;
+}
+
+void SobelFilterSIMD::setTuning(const sobel::TuningParameters& tuning) {
+    switch (tuning.level) {
+        case sobel::SimdLevel::AVX2: optimizationLevel_ = OptimizationLevel::AVX2; break;
+        case sobel::SimdLevel::SSE:  optimizationLevel_ = OptimizationLevel::SSE;  break;
+        default: optimizationLevel_ = OptimizationLevel::SCALAR; break;
+    }
+    bandHeight_ = tuning.band_height;
+    threads_ = tuning.threads;
+    // Helpers persist across frames and are only restarted when the worker count changes
+    const unsigned workers = sobel::resolveThreadCount(threads_);
+    if (workers <= 1) pool_.reset();
+    else if (!pool_) pool_ = std::make_unique<sobel::ThreadPool>(workers);
+    else pool_->resize(workers);
+    autoTuning_ = false;
+}
+
+void SobelFilterSIMD::setAdaptiveQuality(const sobel::AdaptiveQualityConfig& adaptive) {
+    quality_ = sobel::QualityController(adaptive);
+}
+
+sobel::TuningParameters SobelFilterSIMD::getTuning() const {
+    sobel::TuningParameters tuning;
+    tuning.level = simdLevel();
+    tuning.band_height = bandHeight_;
+    tuning.threads = threads_;
+    return tuning;
 }
 
+void SobelFilterSIMD::setPreSmoothing(const sobel::PreSmoothingConfig& smoothing) {
+    if (smoothing.sigma == 0.0f) {
+        preSmoothing_ = smoothing;
+        smoothedEngines_ = {};
+        return;
+    }
+    // Build all three sizes up front: adaptive tiers switch kernels between frames
+    std::array<sobel::SmoothedGradientEngine, 3> engines = {
+        sobel::SmoothedGradientEngine(3, smoothing), sobel::SmoothedGradientEngine(5, smoothing),
+        sobel::SmoothedGradientEngine(7, smoothing)
+    };
+    preSmoothing_ = smoothing;
+    smoothedEngines_ = std::move(engines);
+    if (!rowScratch_.empty()) ensureSmoothingScratch();
+}
+
+void SobelFilterSIMD::setConfig(const sobel::SobelConfig& config) {
+    validateKernelSize(config.kernel_size);
+    config_ = config;
+}
+
+// Row scratch and magnitudes for a frame size; the gray plane is sized by whoever fills it
 void SobelFilterSIMD::ensureBuffers(size_t width, size_t height) {
-    if (width == bufferWidth_ && height == bufferHeight_ && grayBuffer_) return;
+    if (buffersPinned_) return;
+    const bool resized = width != bufferWidth_ || height != bufferHeight_ || rowScratch_.empty();
+    if (resized && autoTuning_) applyWisdom(width, height);
+    if (!resized && rowScratch_.size() == workerCount()) return;
     bufferWidth_ = width;
     bufferHeight_ = height;
-    // Pad width to next multiple of 32 for AVX2 convenience
-    paddedWidth_ = (width + 31) & ~size_t(31);
-    size_t bytes = paddedWidth_ * height; // 1 byte per grayscale pixel
-    grayBuffer_.reset(static_cast<uint8_t*>(alignedAlloc(bytes, 32)));
-    if (!grayBuffer_) throw std::bad_alloc();
-    std::memset(grayBuffer_.get(), 0, bytes);
+
+    rowScratch_.resize(workerCount());
+    for (RowScratch& scratch : rowScratch_) {
+        scratch.gx.assign(width + sobel::kRowSlack, 0);
+        scratch.gy.assign(width + sobel::kRowSlack, 0);
+        scratch.engine.assign(sobel::SobelEngine<7>::scratchSize(width), 0);
+    }
+    magnitudes_.assign(width * height, 0.0f);
+    if (preSmoothing_.enabled()) ensureSmoothingScratch();
 }
 
-void SobelFilterSIMD::convertRGBToGrayscaleScalar(const sobel::RGBImage& input) {
-    const size_t w = bufferWidth_;
+// Scratch of the widest smoothed engine for every worker, kept once allocated like engineWide
+void SobelFilterSIMD::ensureSmoothingScratch() {
+    const size_t size = smoothedEngines_[2].scratchSize(bufferWidth_);
+    for (RowScratch& scratch : rowScratch_) {
+        if (scratch.engineSmoothed.size() < size) scratch.engineSmoothed.assign(size, 0.0f);
+    }
+}
+
+template<typename Work>
+void SobelFilterSIMD::forEachBand(Work&& work) const {
     const size_t h = bufferHeight_;
-    uint8_t* dst = grayBuffer_.get();
-    // Use EXACT same formula as baseline RGBPixel::toGrayscale()
-    constexpr double R_WEIGHT = 0.2126;
-    constexpr double G_WEIGHT = 0.7152;
-    constexpr double B_WEIGHT = 0.0722;
-    
-    for (size_t y = 0; y < h; ++y) {
-        const auto rowOffsetDst = y * paddedWidth_;
-        for (size_t x = 0; x < w; ++x) {
-            const auto& p = input.at(x, y);
-            double gray = R_WEIGHT * p.r + G_WEIGHT * p.g + B_WEIGHT * p.b;
-            dst[rowOffsetDst + x] = static_cast<uint8_t>(std::round(std::clamp(gray, 0.0, 255.0)));
+    const size_t band = bandHeight_ ? std::min(bandHeight_, h) : h;
+    const size_t bands = (h + band - 1) / band;
+    const uint64_t frameId = sobel::Tracer::currentFrame();
+    const sobel::AllocationContext allocations = sobel::currentAllocationContext();
+    auto runBand = [&](unsigned worker, size_t b) {
+        SOBEL_ALLOC_CONTEXT(allocations);        // Helper allocations count towards the caller's recorder
+        sobel::TraceFrameScope frame(frameId);   // Spans on helper threads belong to the caller's frame
+        SOBEL_TRACE_SPAN("band");
+        work(worker, b * band, std::min(h, (b + 1) * band));
+    };
+    if (pool_) pool_->parallelFor(bands, runBand);
+    else sobel::parallelFor(bands, 1, runBand);
+}
+
+// Row stages are timed per worker; with several threads they sum the time of all workers
+void SobelFilterSIMD::foldWorkerTicks() {
+    for (RowScratch& scratch : rowScratch_) {
+        for (size_t i = 0; i < sobel::kPipelineStageCount; ++i) stageTicks_[i] += scratch.ticks[i];
+        scratch.ticks.fill(0);
+    }
+}
+
+sobel::SimdLevel SobelFilterSIMD::simdLevel() const {
+    switch (optimizationLevel_) {
+        case OptimizationLevel::AVX2: return sobel::SimdLevel::AVX2;
+        case OptimizationLevel::SSE:  return sobel::SimdLevel::SSE;
+        default: return sobel::SimdLevel::Scalar;
+    }
+}
+
+void SobelFilterSIMD::convertPackedToHalfGray(const sobel::PackedImageView& input, size_t y0, size_t y1) {
+    const size_t w = input.width;
+    const size_t h = input.height;
+    const size_t stride = input.resolvedStride();
+    const size_t bytes = sobel::pixelFormatBytes(input.format);
+    const size_t red = sobel::pixelFormatRedOffset(input.format);
+    const size_t blue = 2 - red;
+    for (size_t y = y0; y < y1; ++y) {
+        const uint8_t* top = input.data + 2 * y * stride;
+        const uint8_t* bottom = input.data + std::min(2 * y + 1, h - 1) * stride;
+        uint8_t* out = gray_.row(y);
+        for (size_t x = 0; x < bufferWidth_; ++x) {
+            const size_t x0 = 2 * x * bytes;
+            const size_t x1 = std::min(2 * x + 1, w - 1) * bytes;
+            const uint32_t r = top[x0 + red] + top[x1 + red] + bottom[x0 + red] + bottom[x1 + red];
+            const uint32_t g = top[x0 + 1] + top[x1 + 1] + bottom[x0 + 1] + bottom[x1 + 1];
+            const uint32_t b = top[x0 + blue] + top[x1 + blue] + bottom[x0 + blue] + bottom[x1 + blue];
+            // BT.709 weights in 8.8 fixed point (54 + 183 + 19 = 256) over a sum of four pixels
+            out[x] = static_cast<uint8_t>((54 * r + 183 * g + 19 * b + 512) >> 10);
         }
-        // Remaining padded bytes already zeroed
     }
 }
 
-// SSE RGB->gray - Use scalar for exact baseline compatibility
-void SobelFilterSIMD::convertRGBToGrayscaleSSE(const sobel::RGBImage& input) {
-    // For perfect accuracy, use same method as baseline
-    convertRGBToGrayscaleScalar(input);
+void SobelFilterSIMD::convertRGB16ToHalfGray(const sobel::RGBImage16& input, size_t y0, size_t y1) {
+    const size_t w = input.width();
+    const size_t h = input.height();
+    for (size_t y = y0; y < y1; ++y) {
+        const sobel::RGBPixel16* top = input.data() + 2 * y * w;
+        const sobel::RGBPixel16* bottom = input.data() + std::min(2 * y + 1, h - 1) * w;
+        uint16_t* out = gray16_.row(y);
+        for (size_t x = 0; x < bufferWidth_; ++x) {
+            const size_t x0 = 2 * x;
+            const size_t x1 = std::min(x0 + 1, w - 1);
+            const uint64_t r = top[x0].r + top[x1].r + bottom[x0].r + bottom[x1].r;
+            const uint64_t g = top[x0].g + top[x1].g + bottom[x0].g + bottom[x1].g;
+            const uint64_t b = top[x0].b + top[x1].b + bottom[x0].b + bottom[x1].b;
+            out[x] = static_cast<uint16_t>((54 * r + 183 * g + 19 * b + 512) >> 10);
+        }
+    }
 }
 
-// AVX2 RGB->gray - Use scalar for exact baseline compatibility  
-void SobelFilterSIMD::convertRGBToGrayscaleAVX2(const sobel::RGBImage& input) {
-    // For perfect accuracy, use same method as baseline
-    convertRGBToGrayscaleScalar(input);
+template<typename T>
+void SobelFilterSIMD::convertGrayToHalfGray(const T* src, size_t stride, size_t step, size_t w, size_t h,
+                                            sobel::BasicGrayFrame<T>& out, size_t y0, size_t y1) {
+    for (size_t y = y0; y < y1; ++y) {
+        const T* top = src + 2 * y * stride;
+        const T* bottom = src + std::min(2 * y + 1, h - 1) * stride;
+        T* row = out.row(y);
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            if (step == 1) {
+                sobel::downsampleRow2x(simdLevel(), top, bottom, w, row);
+                continue;
+            }
+        }
+        for (size_t x = 0; x < bufferWidth_; ++x) {
+            const size_t x0 = 2 * x * step;
+            const size_t x1 = std::min(2 * x + 1, w - 1) * step;
+            row[x] = static_cast<T>((uint32_t(top[x0]) + top[x1] + bottom[x0] + bottom[x1] + 2) >> 2);
+        }
+    }
 }
 
-// Scalar 5x5 Sobel using grayscale buffer WITH PROPER MAGNITUDE + QUANTIZATION
-void SobelFilterSIMD::sobel5x5Scalar(const uint8_t* gray, sobel::GrayscaleImage& out) {
-    const int w = (int)bufferWidth_; const int h = (int)bufferHeight_;
-    out.resize(bufferWidth_, bufferHeight_);
-    
-    // 5x5 Sobel kernels
-    static const int kx[5][5] = { { -1,-2,0,2,1 }, { -4,-8,0,8,4 }, { -6,-12,0,12,6 }, { -4,-8,0,8,4 }, { -1,-2,0,2,1 } };
-    static const int ky[5][5] = { { -1,-4,-6,-4,-1 }, { -2,-8,-12,-8,-2 }, { 0,0,0,0,0 }, { 2,8,12,8,2 }, { 1,4,6,4,1 } };
-    
-    // Calculate gradients for ALL pixels (like baseline) - use zero padding for boundaries
-    std::vector<int16_t> gx(w * h, 0), gy(w * h, 0);
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            int gx_sum = 0, gy_sum = 0;
-            
-            // Apply 5x5 kernel with zero-padding (like baseline)
-            for (int j = -2; j <= 2; ++j) {
-                for (int i = -2; i <= 2; ++i) {
-                    int src_y = y + j;
-                    int src_x = x + i;
-                    
-                    // Zero padding for out-of-bounds
-                    uint8_t pixel_value = 0;
-                    if (src_y >= 0 && src_y < h && src_x >= 0 && src_x < w) {
-                        pixel_value = gray[src_y * paddedWidth_ + src_x];
-                    }
-                    
-                    gx_sum += pixel_value * kx[j + 2][i + 2];
-                    gy_sum += pixel_value * ky[j + 2][i + 2];
+template<int N, typename T>
+void SobelFilterSIMD::gradientRowFrom(const T* src, int32_t* gx, int32_t* gy, RowScratch& scratch) const {
+    const auto stride = static_cast<std::ptrdiff_t>(sourceStride_);
+    if (preSmoothing_.enabled()) {
+        smoothedEngines_[N / 2 - 1].gradientRow(simdLevel(), src, stride, bufferWidth_, gx, gy,
+                                                scratch.engineSmoothed.data());
+    } else if constexpr (std::is_same_v<T, uint16_t>) {
+        sobel::SobelEngine<N>::gradientRow(simdLevel(), src, stride, bufferWidth_, gx, gy, scratch.engineWide.data());
+    } else {
+        sobel::SobelEngine<N>::gradientRow(simdLevel(), src, stride, bufferWidth_, gx, gy, scratch.engine.data());
+    }
+}
+
+template<int N>
+void SobelFilterSIMD::sourceGradientRow(size_t y, int32_t* gx, int32_t* gy, RowScratch& scratch) const {
+    if (source16_) gradientRowFrom<N>(source16_ + y * sourceStride_, gx, gy, scratch);
+    else gradientRowFrom<N>(source_ + y * sourceStride_, gx, gy, scratch);
+}
+
+template<int N>
+void SobelFilterSIMD::channelGradientRows(size_t y, RowScratch& scratch) const {
+    const size_t row = bufferWidth_ + sobel::kRowSlack;
+    int32_t* gradients = scratch.colorGradients.data();
+    // source_ points into channels_[0] (shifted to a region by applyRegions); the planes share a layout
+    const std::ptrdiff_t offset = source_ - channels_[0].origin();
+    for (size_t c = 0; c < 3; ++c) {
+        gradientRowFrom<N>(channels_[c].origin() + offset + y * sourceStride_, gradients + c * row,
+                           gradients + (3 + c) * row, scratch);
+    }
+}
+
+// Separable NxN Sobel: one gradient row at a time. Requested Gx/Gy planes are
+// narrowed straight from the engine rows, magnitudes go to the caller's plane
+// (or internal storage when only the edge map is wanted) and the edge map is
+// quantized afterwards from the global min/max. A color source runs the engine
+// on each channel and combines the three gradients instead
+template<int N>
+SobelFilterSIMD::MagnitudeRange SobelFilterSIMD::sobelSeparable(const OutputDescriptor& outputs, bool l1Magnitude) {
+    SOBEL_TRACE_SPAN("gradients");
+    const size_t w = bufferWidth_;
+    const sobel::SimdLevel level = simdLevel();
+
+    const size_t gxStride = outputs.gxStride ? outputs.gxStride : w;
+    const size_t gyStride = outputs.gyStride ? outputs.gyStride : w;
+    const size_t edgesStride = outputs.edgesStride ? outputs.edgesStride : w;
+    float* magnitudes = outputs.magnitude ? outputs.magnitude : magnitudes_.data();
+    const size_t magnitudeStride = outputs.magnitude && outputs.magnitudeStride ? outputs.magnitudeStride : w;
+    const bool needMagnitude = outputs.magnitude || outputs.edges;
+    const bool color = colorSource_;
+    const size_t colorRow = w + sobel::kRowSlack;
+
+    for (RowScratch& scratch : rowScratch_) {
+        scratch.minMagnitude = std::numeric_limits<float>::max();
+        scratch.maxMagnitude = 0.0f;
+    }
+    forEachBand([&](unsigned worker, size_t y0, size_t y1) {
+        RowScratch& scratch = rowScratch_[worker];
+        const int32_t* channelGx[3];
+        const int32_t* channelGy[3];
+        for (size_t c = 0; c < 3 && color; ++c) {
+            channelGx[c] = scratch.colorGradients.data() + c * colorRow;
+            channelGy[c] = scratch.colorGradients.data() + (3 + c) * colorRow;
+        }
+        for (size_t y = y0; y < y1; ++y) {
+            {
+                SOBEL_TIME_STAGE(scratch.ticks, sobel::PipelineStage::Convolution);
+                if (color) channelGradientRows<N>(y, scratch);
+                else sourceGradientRow<N>(y, scratch.gx.data(), scratch.gy.data(), scratch);
+            }
+            if (outputs.gx || outputs.gy) {
+                SOBEL_TIME_STAGE(scratch.ticks, sobel::PipelineStage::Output);
+                if (color) {
+                    sobel::dominantGradientRow(level, channelGx, channelGy, w, scratch.gx.data(), scratch.gy.data());
+                }
+                if (outputs.gx) sobel::narrowToInt16(level, scratch.gx.data(), w, outputs.gx + y * gxStride);
+                if (outputs.gy) sobel::narrowToInt16(level, scratch.gy.data(), w, outputs.gy + y * gyStride);
+            }
+            if (needMagnitude) {
+                SOBEL_TIME_STAGE(scratch.ticks, sobel::PipelineStage::Magnitude);
+                if (color) {
+                    sobel::colorMagnitudeRow(level, colorMode_, channelGx, channelGy, w, magnitudes + y * magnitudeStride,
+                                             scratch.minMagnitude, scratch.maxMagnitude);
+                    continue;
                 }
+                auto magnitudeRow = l1Magnitude ? sobel::magnitudeL1Row : sobel::magnitudeRow;
+                magnitudeRow(level, scratch.gx.data(), scratch.gy.data(), w,
+                             magnitudes + y * magnitudeStride, scratch.minMagnitude, scratch.maxMagnitude);
             }
-            
-            size_t idx = y * w + x;
-            gx[idx] = (int16_t)std::clamp(gx_sum, -32768, 32767);
-            gy[idx] = (int16_t)std::clamp(gy_sum, -32768, 32767);
         }
+    });
+    foldWorkerTicks();
+
+    float minMagnitude = std::numeric_limits<float>::max();
+    float maxMagnitude = 0.0f;
+    for (const RowScratch& scratch : rowScratch_) {
+        minMagnitude = std::min(minMagnitude, scratch.minMagnitude);
+        maxMagnitude = std::max(maxMagnitude, scratch.maxMagnitude);
     }
-    
-    // Calculate magnitude using same method as baseline
-    std::vector<double> magnitudes(w * h);
-    for (size_t i = 0; i < gx.size(); ++i) {
-        double magnitude = std::sqrt(
-            static_cast<double>(gx[i]) * gx[i] + 
-            static_cast<double>(gy[i]) * gy[i]
-        );
-        magnitudes[i] = magnitude;
+
+    if (outputs.edges) {
+        SOBEL_TRACE_SPAN("quantization");
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Quantization);
+        quantizeWithConfig(minMagnitude, maxMagnitude, magnitudes, magnitudeStride, outputs.edges, edgesStride);
     }
-    
-    // Apply quantization using baseline method
-    std::vector<uint8_t> quantized = quantizeWithConfig(magnitudes);
-    
-    // Copy to output
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            out.at(x, y) = quantized[y * w + x];
-        }
+    return {minMagnitude, maxMagnitude};
+}
+
+SobelFilterSIMD::MagnitudeRange SobelFilterSIMD::runSobel(int kernelSize, const OutputDescriptor& outputs,
+                                                          bool l1Magnitude) {
+    switch (kernelSize) {
+        case 3: return sobelSeparable<3>(outputs, l1Magnitude);
+        case 7: return sobelSeparable<7>(outputs, l1Magnitude);
+        default: return sobelSeparable<5>(outputs, l1Magnitude);
     }
 }
 
-// Placeholder SIMD 5x5 (will implement later). Currently calls scalar.
-void SobelFilterSIMD::sobel5x5SSE(const uint8_t* gray, sobel::GrayscaleImage& out) { sobel5x5Scalar(gray,out); }
-void SobelFilterSIMD::sobel5x5AVX2(const uint8_t* gray, sobel::GrayscaleImage& out) { sobel5x5Scalar(gray,out); }
+// The halved frame goes into `plane`, which keeps its full-size allocation, and the row
+// scratch stays sized for the full width, so moving between tiers never reallocates
+template<typename Plane, typename Halve>
+void SobelFilterSIMD::applyHalfResolution(Plane& plane, size_t width, size_t height, Halve&& halve,
+                                          uint8_t* edges, size_t edgesStride) {
+    const size_t w = width;
+    const size_t h = height;
+    const size_t halfWidth = (w + 1) / 2;
+    const size_t halfHeight = (h + 1) / 2;
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        ensureBuffers(w, h);
+        if constexpr (std::is_same_v<Plane, sobel::GrayFrame16>) ensureWideScratch();
+        plane.resize(halfWidth, halfHeight);
+        if (halfEdges_.size() < halfWidth * halfHeight) halfEdges_.resize(halfWidth * halfHeight);
+    }
+
+    {
+        // Run the row stages on the halved size; the full size is back before upsampling
+        LogicalSize restore(bufferWidth_, bufferHeight_);
+        bufferWidth_ = halfWidth;
+        bufferHeight_ = halfHeight;
+
+        {
+            SOBEL_TRACE_SPAN("gray_conversion");
+            SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::GrayConversion);
+            forEachBand([&](unsigned, size_t y0, size_t y1) { halve(y0, y1); });
+            plane.fillBorder(config_.border_mode);
+            useSource(plane);
+        }
+        OutputDescriptor half;
+        half.edges = halfEdges_.data();
+        sobelSeparable<3>(half, true);
+    }
+
+    SOBEL_TRACE_SPAN("upsample");
+    SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Output);
+    const sobel::SimdLevel level = simdLevel();
+    forEachBand([&](unsigned, size_t y0, size_t y1) {
+        for (size_t y = y0; y < y1; ++y) {
+            sobel::upsampleRow2x(level, halfEdges_.data() + (y / 2) * halfWidth, w, edges + y * edgesStride);
+        }
+    });
+}
 
 // Quantization helper - same logic as baseline SobelFilter::quantize
-std::vector<uint8_t> SobelFilterSIMD::quantizeWithConfig(const std::vector<double>& magnitudes) const {
-    if (magnitudes.empty()) return {};
-    std::vector<uint8_t> result(magnitudes.size());
-    
-    if (!config_.use_quantization) {
-        for (size_t i = 0; i < magnitudes.size(); ++i) {
-            result[i] = static_cast<uint8_t>(std::clamp(magnitudes[i], 0.0, 255.0));
+void SobelFilterSIMD::quantizeWithConfig(float minMagnitude, float maxMagnitude, const float* magnitudes,
+                                         size_t magnitudeStride, uint8_t* out, size_t outStride) const {
+    const size_t w = bufferWidth_;
+    const size_t h = bufferHeight_;
+    float offset = 0.0f;
+    float scale = 1.0f;
+    if (config_.use_quantization) {
+        double range = static_cast<double>(maxMagnitude) - minMagnitude;
+        if (range < 1e-10) {
+            for (size_t y = 0; y < h; ++y) std::fill(out + y * outStride, out + y * outStride + w, uint8_t(0));
+            return;
         }
-        return result;
+
+        // (m - min) * levels / range, optionally rescaled from [0, levels] to [0, 255]
+        double levelScale = static_cast<double>(config_.quantization_levels) / range;
+        if (config_.normalize_output) levelScale = levelScale / config_.quantization_levels * 255.0;
+        offset = minMagnitude;
+        scale = static_cast<float>(levelScale);
     }
-    
-    auto minmax = std::minmax_element(magnitudes.begin(), magnitudes.end());
-    double min_mag = *minmax.first, max_mag = *minmax.second, range = max_mag - min_mag;
-    if (range < 1e-10) { std::fill(result.begin(), result.end(), uint8_t(0)); return result; }
-    
-    double scale = static_cast<double>(config_.quantization_levels) / range;
-    for (size_t i = 0; i < magnitudes.size(); ++i) {
-        double normalized = (magnitudes[i] - min_mag) * scale;
-        if (config_.normalize_output) normalized = (normalized / config_.quantization_levels) * 255.0;
-        result[i] = static_cast<uint8_t>(std::clamp(normalized, 0.0, 255.0));
+
+    forEachBand([&](unsigned, size_t y0, size_t y1) {
+        if (magnitudeStride == w && outStride == w) {
+            sobel::quantizeMagnitudes(simdLevel(), magnitudes + y0 * w, (y1 - y0) * w, offset, scale, out + y0 * w);
+            return;
+        }
+        for (size_t y = y0; y < y1; ++y) {
+            sobel::quantizeMagnitudes(simdLevel(), magnitudes + y * magnitudeStride, w, offset, scale,
+                                      out + y * outStride);
+        }
+    });
+}
+
+// Color -> grayscale into the haloed buffer, then fill the halo per border mode
+void SobelFilterSIMD::prepareGray(const sobel::PackedImageView& input) {
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        ensureBuffers(input.width, input.height);
+        gray_.resize(input.width, input.height);
     }
-    return result;
+
+    SOBEL_TRACE_SPAN("gray_conversion");
+    SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::GrayConversion);
+    SOBEL_ALLOC_STAGE(sobel::PipelineStage::GrayConversion);
+    const sobel::SimdLevel level = simdLevel();
+    const size_t stride = input.resolvedStride();
+    forEachBand([&](unsigned, size_t y0, size_t y1) {
+        for (size_t y = y0; y < y1; ++y) {
+            sobel::packedToGrayRow(level, input.format, input.data + y * stride, input.width, gray_.row(y));
+        }
+    });
+    gray_.fillBorder(config_.border_mode);
+    useSource(gray_);
+}
+
+// A caller's frame is read in place; only its halo is (re)filled
+void SobelFilterSIMD::prepareGray(sobel::GrayFrame& frame) {
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        ensureBuffers(frame.width(), frame.height());
+    }
+    frame.fillBorder(config_.border_mode);
+    useSource(frame);
+}
+
+// Luma samples `step` bytes apart (1 = gray plane, 2 = YUYV) are copied into the haloed
+// buffer: the caller's rows have no halo for the kernels to read
+void SobelFilterSIMD::prepareLuma(const uint8_t* src, size_t stride, size_t step, size_t w, size_t h) {
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        ensureBuffers(w, h);
+        gray_.resize(w, h);
+    }
+
+    SOBEL_TRACE_SPAN("gray_conversion");
+    SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::GrayConversion);
+    SOBEL_ALLOC_STAGE(sobel::PipelineStage::GrayConversion);
+    const sobel::SimdLevel level = simdLevel();
+    forEachBand([&](unsigned, size_t y0, size_t y1) {
+        for (size_t y = y0; y < y1; ++y) {
+            if (step == 1) std::memcpy(gray_.row(y), src + y * stride, w);
+            else sobel::yuyvToGrayRow(level, src + y * stride, w, gray_.row(y));
+        }
+    });
+    gray_.fillBorder(config_.border_mode);
+    useSource(gray_);
+}
+
+// 16-bit engine scratch for every worker, kept once allocated so 8-bit-only filters never pay for it
+void SobelFilterSIMD::ensureWideScratch() {
+    const size_t size = sobel::SobelEngine<7>::scratchSize(bufferWidth_);
+    for (RowScratch& scratch : rowScratch_) {
+        if (scratch.engineWide.size() < size) scratch.engineWide.assign(size, 0);
+    }
+}
+
+// Per-channel gradient rows for every worker, kept once allocated like engineWide
+void SobelFilterSIMD::ensureColorScratch() {
+    const size_t size = 6 * (bufferWidth_ + sobel::kRowSlack);
+    for (RowScratch& scratch : rowScratch_) {
+        if (scratch.colorGradients.size() < size) scratch.colorGradients.assign(size, 0);
+    }
+}
+
+// Color -> three haloed channel planes; channels_[0] doubles as the source for stride and size
+void SobelFilterSIMD::prepareChannels(const sobel::PackedImageView& input) {
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        ensureBuffers(input.width, input.height);
+        ensureColorScratch();
+        for (sobel::GrayFrame& channel : channels_) channel.resize(input.width, input.height);
+    }
+
+    SOBEL_TRACE_SPAN("gray_conversion");
+    SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::GrayConversion);
+    SOBEL_ALLOC_STAGE(sobel::PipelineStage::GrayConversion);
+    const sobel::SimdLevel level = simdLevel();
+    const size_t stride = input.resolvedStride();
+    forEachBand([&](unsigned, size_t y0, size_t y1) {
+        for (size_t y = y0; y < y1; ++y) {
+            uint8_t* const rows[3] = {channels_[0].row(y), channels_[1].row(y), channels_[2].row(y)};
+            sobel::deinterleaveRow(level, input.format, input.data + y * stride, input.width, rows);
+        }
+    });
+    for (sobel::GrayFrame& channel : channels_) channel.fillBorder(config_.border_mode);
+    useSource(channels_[0]);
+    colorSource_ = true;
+}
+
+template<typename Convert>
+void SobelFilterSIMD::prepareGray16(size_t w, size_t h, Convert&& convert) {
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        ensureBuffers(w, h);
+        ensureWideScratch();
+        gray16_.resize(w, h);
+    }
+
+    SOBEL_TRACE_SPAN("gray_conversion");
+    SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::GrayConversion);
+    SOBEL_ALLOC_STAGE(sobel::PipelineStage::GrayConversion);
+    forEachBand([&](unsigned, size_t y0, size_t y1) { convert(y0, y1); });
+    gray16_.fillBorder(config_.border_mode);
+    useSource(gray16_);
+}
+
+// Canny over a rolling window: row y+1 is produced by the engine while row y is
+// suppressed, so NMS reads gradients that are still in cache
+template<int N>
+void SobelFilterSIMD::cannySeparable(const sobel::CannyConfig& canny, sobel::GrayscaleImage& out) {
+    SOBEL_TRACE_SPAN("suppression");
+    using Coefficients = sobel::SobelCoefficients<N>;
+    const size_t w = bufferWidth_;
+    const size_t h = bufferHeight_;
+    const sobel::SimdLevel level = simdLevel();
+    out.resize(w, h);
+
+    const size_t magStride = w + 2 + sobel::kRowSlack;
+    const size_t gradStride = w + sobel::kRowSlack;
+    const size_t stateStride = w + 2;
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        cannyMagnitude_.assign(4 * magStride, 0.0f);
+        cannyGx_.assign(3 * gradStride, 0);
+        cannyGy_.assign(3 * gradStride, 0);
+        cannyState_.assign(stateStride * (h + 2), 0);
+    }
+
+    // Thresholds on the 3x3 Sobel scale (gain 4) -> this kernel's scale
+    const float gain = static_cast<float>(Coefficients::smoothingSum() * Coefficients::derivativeGain()) / 4.0f;
+    const float low = canny.low_threshold * gain;
+    const float high = canny.high_threshold * gain;
+
+    auto magRow = [&](size_t slot) { return cannyMagnitude_.data() + slot * magStride + 1; };
+    const float* zeroRow = magRow(3);
+    auto produce = [&](size_t y) {
+        const size_t slot = y % 3;
+        float minMagnitude = 0.0f, maxMagnitude = 0.0f;
+        {
+            SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Convolution);
+            sourceGradientRow<N>(y, cannyGx_.data() + slot * gradStride, cannyGy_.data() + slot * gradStride,
+                                 rowScratch_[0]);
+        }
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Magnitude);
+        sobel::magnitudeRow(level, cannyGx_.data() + slot * gradStride, cannyGy_.data() + slot * gradStride, w,
+                            magRow(slot), minMagnitude, maxMagnitude);
+    };
+
+    uint8_t* state = cannyState_.data() + stateStride + 1;
+    produce(0);
+    for (size_t y = 0; y < h; ++y) {
+        if (y + 1 < h) produce(y + 1);
+        const size_t slot = y % 3;
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Suppression);
+        sobel::nonMaximumSuppressionRow(level,
+                                        y > 0 ? magRow((y - 1) % 3) : zeroRow,
+                                        magRow(slot),
+                                        y + 1 < h ? magRow((y + 1) % 3) : zeroRow,
+                                        cannyGx_.data() + slot * gradStride, cannyGy_.data() + slot * gradStride,
+                                        w, low, high, state + y * stateStride);
+    }
+
+    SOBEL_TRACE_SPAN("hysteresis");
+    SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Hysteresis);
+    SOBEL_ALLOC_STAGE(sobel::PipelineStage::Hysteresis);   // The edge-tracing stack may grow
+    sobel::hysteresis(level, state, static_cast<std::ptrdiff_t>(stateStride), w, h, cannyStack_);
+    sobel::finalizeEdges(level, state, static_cast<std::ptrdiff_t>(stateStride), w, h, out.data());
+}
+
+template<int N>
+void SobelFilterSIMD::orientationSeparable(sobel::GrayscaleImage& out) {
+    SOBEL_TRACE_SPAN("orientation");
+    const size_t w = bufferWidth_;
+    const size_t h = bufferHeight_;
+    const sobel::SimdLevel level = simdLevel();
+    out.resize(w, h);
+
+    RowScratch& scratch = rowScratch_[0];
+    for (size_t y = 0; y < h; ++y) {
+        {
+            SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Convolution);
+            sourceGradientRow<N>(y, scratch.gx.data(), scratch.gy.data(), scratch);
+        }
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Output);
+        sobel::orientationRow(level, scratch.gx.data(), scratch.gy.data(), w, out.data() + y * w);
+    }
+}
+
+bool SobelFilterSIMD::applyCanny(const sobel::RGBImage& input, sobel::GrayscaleImage& output,
+                                 const sobel::CannyConfig& canny) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    SOBEL_TRACE_FRAME();
+    SOBEL_TRACE_SPAN("applyCanny");
+    beginFrame();
+    prepareGray(rgbView(input));
+    switch (config_.kernel_size) {
+        case 3: cannySeparable<3>(canny, output); break;
+        case 7: cannySeparable<7>(canny, output); break;
+        default: cannySeparable<5>(canny, output); break;
+    }
+    endFrame();
+    return true;
+}
+
+bool SobelFilterSIMD::computeOrientation(const sobel::RGBImage& input, sobel::GrayscaleImage& directions) {
+    if (input.empty()) {
+        directions = sobel::GrayscaleImage();
+        return false;
+    }
+
+    SOBEL_TRACE_FRAME();
+    SOBEL_TRACE_SPAN("computeOrientation");
+    beginFrame();
+    prepareGray(rgbView(input));
+    switch (config_.kernel_size) {
+        case 3: orientationSeparable<3>(directions); break;
+        case 7: orientationSeparable<7>(directions); break;
+        default: orientationSeparable<5>(directions); break;
+    }
+    endFrame();
+    return true;
 }
 
 bool SobelFilterSIMD::apply(const sobel::RGBImage& input, sobel::GrayscaleImage& output, bool enableProfiling) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(input.width(), input.height());
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return apply(input, outputs, enableProfiling);
+}
+
+template<typename Plane, typename Prepare, typename Halve>
+bool SobelFilterSIMD::applyFrame(Plane& halfPlane, size_t width, size_t height, size_t inputPixelBytes,
+                                 const OutputDescriptor& outputs, bool enableProfiling,
+                                 Prepare&& prepare, Halve&& halve) {
     if (enableProfiling) {
         startProfiling();
     }
 
-    ensureBuffers(input.width(), input.height());
+    if (width == 0 || height == 0 || (!outputs.gx && !outputs.gy && !outputs.magnitude && !outputs.edges)) {
+        return false;
+    }
 
-    // RGB -> grayscale (choose path)
-    switch (optimizationLevel_) {
-        case OptimizationLevel::AVX2: convertRGBToGrayscaleAVX2(input); break;
-        case OptimizationLevel::SSE:  convertRGBToGrayscaleSSE(input);  break;
-        default: convertRGBToGrayscaleScalar(input); break;
+    validateOutputStrides(outputs, width);
+
+    const bool adaptive = quality_.config().enabled && !outputs.gx && !outputs.gy && !outputs.magnitude;
+    const sobel::QualityTier tier = adaptive ? quality_.tier() : sobel::QualityTier::Full;
+
+    SOBEL_TRACE_FRAME();
+    SOBEL_TRACE_SPAN("apply");
+    beginFrame();
+    if (tier == sobel::QualityTier::HalfResolution) {
+        applyHalfResolution(halfPlane, width, height, halve, outputs.edges, outputs.edgesStride ? outputs.edgesStride : width);
+    } else {
+        prepare();
+        // Separable Sobel at the configured kernel size, or the tier's cheaper settings
+        runSobel(tier >= sobel::QualityTier::Kernel3x3 ? 3 : config_.kernel_size, outputs,
+                 tier >= sobel::QualityTier::L1Magnitude);
     }
+    endFrame();
+    if (adaptive) quality_.update(lastFrameTime_);
+    lastMetrics_.qualityTier = tier;
+    ++lastMetrics_.tierFrames[static_cast<size_t>(tier)];
 
-    // 5x5 Sobel (currently scalar; SIMD later)
-    switch (optimizationLevel_) {
-        case OptimizationLevel::AVX2: sobel5x5AVX2(grayBuffer_.get(), output); break;
-        case OptimizationLevel::SSE:  sobel5x5SSE(grayBuffer_.get(), output);  break;
-        default: sobel5x5Scalar(grayBuffer_.get(), output); break;
+    if (enableProfiling) {
+        endProfiling();
+        recordMetrics(width * height, inputPixelBytes);
     }
 
+    return true;
+}
+
+bool SobelFilterSIMD::apply(const sobel::RGBImage& input, const OutputDescriptor& outputs, bool enableProfiling) {
+    return apply(rgbView(input), outputs, enableProfiling);
+}
+
+bool SobelFilterSIMD::apply(const sobel::PackedImageView& input, sobel::GrayscaleImage& output,
+                            bool enableProfiling) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(input.width, input.height);
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return apply(input, outputs, enableProfiling);
+}
+
+bool SobelFilterSIMD::apply(const sobel::PackedImageView& input, const OutputDescriptor& outputs,
+                            bool enableProfiling) {
+    if (!input.empty() && (!input.data || input.resolvedStride() < input.rowBytes())) {
+        throw std::invalid_argument("Pixel view needs a data pointer and a stride of at least one row");
+    }
+    return applyFrame(gray_, input.width, input.height, sobel::pixelFormatBytes(input.format), outputs, enableProfiling,
+                      [&] {
+                          if (colorMode_ == sobel::ColorGradientMode::Luma) prepareGray(input);
+                          else prepareChannels(input);
+                      },
+                      [&](size_t y0, size_t y1) { convertPackedToHalfGray(input, y0, y1); });
+}
+
+bool SobelFilterSIMD::apply(const sobel::GrayscaleImage& input, sobel::GrayscaleImage& output, bool enableProfiling) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(input.width(), input.height());
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return apply(input, outputs, enableProfiling);
+}
+
+bool SobelFilterSIMD::apply(const sobel::GrayscaleImage& input, const OutputDescriptor& outputs, bool enableProfiling) {
+    return applyFrame(gray_, input.width(), input.height(), 1, outputs, enableProfiling,
+                      [&] { prepareLuma(input.data(), input.width(), 1, input.width(), input.height()); },
+                      [&](size_t y0, size_t y1) {
+                          convertGrayToHalfGray(input.data(), input.width(), 1, input.width(), input.height(), gray_, y0, y1);
+                      });
+}
+
+bool SobelFilterSIMD::apply(const sobel::YuvImageView& input, sobel::GrayscaleImage& output, bool enableProfiling) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(input.width, input.height);
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return apply(input, outputs, enableProfiling);
+}
+
+bool SobelFilterSIMD::apply(const sobel::YuvImageView& input, const OutputDescriptor& outputs, bool enableProfiling) {
+    const size_t stride = input.resolvedStride();
+    if (!input.empty() && (!input.luma || stride < input.rowBytes())) {
+        throw std::invalid_argument("YUV view needs a luma pointer and a stride of at least one row");
+    }
+    const size_t step = input.pixelStep();
+    return applyFrame(gray_, input.width, input.height, step, outputs, enableProfiling,
+                      [&] { prepareLuma(input.luma, stride, step, input.width, input.height); },
+                      [&](size_t y0, size_t y1) {
+                          convertGrayToHalfGray(input.luma, stride, step, input.width, input.height, gray_, y0, y1);
+                      });
+}
+
+bool SobelFilterSIMD::apply(sobel::GrayFrame& gray, sobel::GrayscaleImage& output, bool enableProfiling) {
+    if (gray.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(gray.width(), gray.height());
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return apply(gray, outputs, enableProfiling);
+}
+
+bool SobelFilterSIMD::apply(sobel::GrayFrame& gray, const OutputDescriptor& outputs, bool enableProfiling) {
+    return applyFrame(gray_, gray.width(), gray.height(), 1, outputs, enableProfiling,
+                      [&] { prepareGray(gray); },
+                      [&](size_t y0, size_t y1) {
+                          convertGrayToHalfGray(gray.origin(), gray.stride(), 1, gray.width(), gray.height(), gray_,
+                                                y0, y1);
+                      });
+}
+
+bool SobelFilterSIMD::apply(const sobel::GrayscaleImage16& input, sobel::GrayscaleImage& output,
+                            bool enableProfiling) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(input.width(), input.height());
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return apply(input, outputs, enableProfiling);
+}
+
+bool SobelFilterSIMD::apply(const sobel::GrayscaleImage16& input, const OutputDescriptor& outputs,
+                            bool enableProfiling) {
+    const size_t w = input.width();
+    const size_t h = input.height();
+    return applyFrame(gray16_, w, h, sizeof(uint16_t), outputs, enableProfiling,
+                      [&] {
+                          prepareGray16(w, h, [&](size_t y0, size_t y1) {
+                              for (size_t y = y0; y < y1; ++y) {
+                                  std::memcpy(gray16_.row(y), input.data() + y * w, w * sizeof(uint16_t));
+                              }
+                          });
+                      },
+                      [&](size_t y0, size_t y1) { convertGrayToHalfGray(input.data(), w, 1, w, h, gray16_, y0, y1); });
+}
+
+bool SobelFilterSIMD::apply(const sobel::RGBImage16& input, sobel::GrayscaleImage& output, bool enableProfiling) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(input.width(), input.height());
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return apply(input, outputs, enableProfiling);
+}
+
+bool SobelFilterSIMD::apply(const sobel::RGBImage16& input, const OutputDescriptor& outputs, bool enableProfiling) {
+    const size_t w = input.width();
+    const size_t h = input.height();
+    return applyFrame(gray16_, w, h, sizeof(sobel::RGBPixel16), outputs, enableProfiling,
+                      [&] {
+                          const sobel::SimdLevel level = simdLevel();
+                          prepareGray16(w, h, [&](size_t y0, size_t y1) {
+                              for (size_t y = y0; y < y1; ++y) {
+                                  sobel::rgb16ToGrayRow(level, reinterpret_cast<const uint16_t*>(input.data() + y * w), w,
+                                                        gray16_.row(y));
+                              }
+                          });
+                      },
+                      [&](size_t y0, size_t y1) { convertRGB16ToHalfGray(input, y0, y1); });
+}
+
+// Each merged region is converted together with its halo (cut off at the frame edge, where the
+// border fill takes over) into the internal plane and filtered at its own size; the buffers stay
+// sized for the full frame, so a changing set of regions never reallocates. For a union range the
+// magnitudes of all regions are kept until the last one has been filtered.
+template<typename Prepare>
+bool SobelFilterSIMD::applyRegionsFrame(size_t width, size_t height, size_t inputPixelBytes, bool colorInput,
+                                        const std::vector<sobel::RegionOfInterest>& regions,
+                                        const OutputDescriptor& outputs, sobel::RegionNormalization normalization,
+                                        bool enableProfiling, Prepare&& prepare) {
+    if (enableProfiling) {
+        startProfiling();
+    }
+
+    if (width == 0 || height == 0 || (!outputs.gx && !outputs.gy && !outputs.magnitude && !outputs.edges)) {
+        return false;
+    }
+    validateOutputStrides(outputs, width);
+
+    const int kernel = config_.kernel_size;
+    const size_t halo = preSmoothing_.enabled() ? smoothedEngines_[kernel / 2 - 1].radius() : kernel / 2;
+    const bool unionRange = normalization == sobel::RegionNormalization::Union && outputs.edges;
+    const size_t gxStride = outputs.gxStride ? outputs.gxStride : width;
+    const size_t gyStride = outputs.gyStride ? outputs.gyStride : width;
+    const size_t magnitudeStride = outputs.magnitudeStride ? outputs.magnitudeStride : width;
+    const size_t edgesStride = outputs.edgesStride ? outputs.edgesStride : width;
+
+    SOBEL_TRACE_FRAME();
+    SOBEL_TRACE_SPAN("applyRegions");
+    beginFrame();
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        ensureBuffers(width, height);
+        // Planes at full size up front: smaller regions then never grow them
+        if (colorInput && colorMode_ != sobel::ColorGradientMode::Luma) {
+            ensureColorScratch();
+            for (sobel::GrayFrame& channel : channels_) channel.resize(width, height);
+        } else {
+            gray_.resize(width, height);
+        }
+        sobel::mergeRegions(regions, width, height, regions_);
+    }
+    const std::vector<sobel::RegionOfInterest>& merged = regions_;
+    struct Pin {
+        bool& pinned;
+        ~Pin() { pinned = false; }
+    } pin{buffersPinned_};
+    buffersPinned_ = true;
+
+    MagnitudeRange range{std::numeric_limits<float>::max(), 0.0f};
+    size_t pixels = 0;
+    for (const sobel::RegionOfInterest& region : merged) {
+        LogicalSize logical(bufferWidth_, bufferHeight_);
+        const size_t x0 = region.x - std::min(region.x, halo);
+        const size_t y0 = region.y - std::min(region.y, halo);
+        const sobel::RegionOfInterest area{x0, y0, std::min(width, region.right() + halo) - x0,
+                                           std::min(height, region.bottom() + halo) - y0};
+        bufferWidth_ = area.width;
+        bufferHeight_ = area.height;
+        prepare(area);
+        source_ += (region.y - y0) * sourceStride_ + (region.x - x0);
+        bufferWidth_ = region.width;
+        bufferHeight_ = region.height;
+
+        OutputDescriptor view;
+        if (outputs.gx) view.gx = outputs.gx + region.y * gxStride + region.x;
+        if (outputs.gy) view.gy = outputs.gy + region.y * gyStride + region.x;
+        if (outputs.magnitude) view.magnitude = outputs.magnitude + region.y * magnitudeStride + region.x;
+        if (outputs.edges) view.edges = outputs.edges + region.y * edgesStride + region.x;
+        view.gxStride = gxStride;
+        view.gyStride = gyStride;
+        view.magnitudeStride = magnitudeStride;
+        view.edgesStride = edgesStride;
+        if (unionRange) {
+            view.edges = nullptr;
+            if (!view.magnitude) {
+                view.magnitude = magnitudes_.data() + pixels;
+                view.magnitudeStride = region.width;
+            }
+        }
+        const MagnitudeRange regionRange = runSobel(kernel, view, false);
+        range.min = std::min(range.min, regionRange.min);
+        range.max = std::max(range.max, regionRange.max);
+        pixels += region.area();
+    }
+
+    if (unionRange) {
+        SOBEL_TRACE_SPAN("quantization");
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Quantization);
+        size_t offset = 0;
+        for (const sobel::RegionOfInterest& region : merged) {
+            LogicalSize logical(bufferWidth_, bufferHeight_);
+            bufferWidth_ = region.width;
+            bufferHeight_ = region.height;
+            const float* magnitudes = outputs.magnitude
+                ? outputs.magnitude + region.y * magnitudeStride + region.x
+                : magnitudes_.data() + offset;
+            quantizeWithConfig(range.min, range.max, magnitudes, outputs.magnitude ? magnitudeStride : region.width,
+                               outputs.edges + region.y * edgesStride + region.x, edgesStride);
+            offset += region.area();
+        }
+    }
+    endFrame();
+
     if (enableProfiling) {
         endProfiling();
-        
-        // Calculate basic performance metrics
-        auto timeUs = lastMetrics_.processingTime.count();
-        size_t totalPixels = input.width() * input.height();
-        lastMetrics_.pixelsPerSecond = (timeUs > 0) ? (totalPixels * 1000000ull) / timeUs : 0;
-        lastMetrics_.memoryBandwidth = totalPixels; // bytes read approx
-        
-        switch (optimizationLevel_) {
-            case OptimizationLevel::AVX2:
-                lastMetrics_.optimizationUsed = "AVX2";
-                break;
-            case OptimizationLevel::SSE:
-                lastMetrics_.optimizationUsed = "SSE";
-                break;
-            default:
-                lastMetrics_.optimizationUsed = "Scalar";
-                break;
+        recordMetrics(pixels, inputPixelBytes);
+    }
+    return true;
+}
+
+bool SobelFilterSIMD::applyRegions(const sobel::RGBImage& input, const std::vector<sobel::RegionOfInterest>& regions,
+                                   sobel::GrayscaleImage& output, sobel::RegionNormalization normalization,
+                                   bool enableProfiling) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(input.width(), input.height());
+    std::fill(output.data(), output.data() + output.size(), uint8_t(0));
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return applyRegions(rgbView(input), regions, outputs, normalization, enableProfiling);
+}
+
+bool SobelFilterSIMD::applyRegions(const sobel::PackedImageView& input,
+                                   const std::vector<sobel::RegionOfInterest>& regions,
+                                   const OutputDescriptor& outputs, sobel::RegionNormalization normalization,
+                                   bool enableProfiling) {
+    if (!input.empty() && (!input.data || input.resolvedStride() < input.rowBytes())) {
+        throw std::invalid_argument("Pixel view needs a data pointer and a stride of at least one row");
+    }
+    const size_t bytes = sobel::pixelFormatBytes(input.format);
+    const size_t stride = input.resolvedStride();
+    return applyRegionsFrame(input.width, input.height, bytes, true, regions, outputs, normalization, enableProfiling,
+                             [&](const sobel::RegionOfInterest& area) {
+                                 const sobel::PackedImageView view{input.format,
+                                                                   input.data + area.y * stride + area.x * bytes,
+                                                                   area.width, area.height, stride};
+                                 if (colorMode_ == sobel::ColorGradientMode::Luma) prepareGray(view);
+                                 else prepareChannels(view);
+                             });
+}
+
+bool SobelFilterSIMD::applyRegions(const sobel::GrayscaleImage& input,
+                                   const std::vector<sobel::RegionOfInterest>& regions,
+                                   sobel::GrayscaleImage& output, sobel::RegionNormalization normalization,
+                                   bool enableProfiling) {
+    if (input.empty()) {
+        output = sobel::GrayscaleImage();
+        return false;
+    }
+
+    output.resize(input.width(), input.height());
+    std::fill(output.data(), output.data() + output.size(), uint8_t(0));
+    OutputDescriptor outputs;
+    outputs.edges = output.data();
+    return applyRegions(input, regions, outputs, normalization, enableProfiling);
+}
+
+bool SobelFilterSIMD::applyRegions(const sobel::GrayscaleImage& input,
+                                   const std::vector<sobel::RegionOfInterest>& regions,
+                                   const OutputDescriptor& outputs, sobel::RegionNormalization normalization,
+                                   bool enableProfiling) {
+    const size_t w = input.width();
+    return applyRegionsFrame(w, input.height(), 1, false, regions, outputs, normalization, enableProfiling,
+                             [&](const sobel::RegionOfInterest& area) {
+                                 prepareLuma(input.data() + area.y * w + area.x, w, 1, area.width, area.height);
+                             });
+}
+
+// Level 0 is filtered straight from the converted gray source; each further level decimates the
+// previous gray plane into pyramid_, so the input is read once and no level converts color again.
+// The row scratch and magnitudes_ are sized for level 0 and serve every smaller level.
+template<typename Prepare>
+bool SobelFilterSIMD::applyPyramidFrame(size_t width, size_t height, size_t inputPixelBytes, size_t levels,
+                                        std::vector<sobel::GrayscaleImage>& outputs, bool enableProfiling,
+                                        Prepare&& prepare) {
+    if (levels == 0) {
+        throw std::invalid_argument("Pyramid needs at least one level");
+    }
+    if (enableProfiling) {
+        startProfiling();
+    }
+
+    if (width == 0 || height == 0) {
+        outputs.clear();
+        return false;
+    }
+
+    SOBEL_TRACE_FRAME();
+    SOBEL_TRACE_SPAN("applyPyramid");
+    beginFrame();
+    {
+        SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::Setup);
+        SOBEL_ALLOC_STAGE(sobel::PipelineStage::Setup);
+        if (pyramid_.size() < levels - 1) pyramid_.resize(levels - 1);
+        outputs.resize(levels);
+        size_t w = width;
+        size_t h = height;
+        for (size_t level = 0; level < levels; ++level) {
+            if (level > 0) {
+                w = (w + 1) / 2;
+                h = (h + 1) / 2;
+                pyramid_[level - 1].resize(w, h);
+            }
+            outputs[level].resize(w, h);
+        }
+    }
+
+    prepare();
+    const int kernel = config_.kernel_size;
+    OutputDescriptor edges;
+    edges.edges = outputs[0].data();
+    runSobel(kernel, edges, false);
+
+    // Levels run at their own logical size; the full size is back for the next call
+    LogicalSize restore(bufferWidth_, bufferHeight_);
+    size_t pixels = width * height;
+    const sobel::SimdLevel simd = simdLevel();
+    for (size_t level = 1; level < levels; ++level) {
+        // The previous level's plane is still the source
+        const uint8_t* previous = source_;
+        const size_t previousStride = sourceStride_;
+        const size_t previousWidth = bufferWidth_;
+        const size_t previousHeight = bufferHeight_;
+        sobel::GrayFrame& plane = pyramid_[level - 1];
+        bufferWidth_ = plane.width();
+        bufferHeight_ = plane.height();
+        {
+            SOBEL_TRACE_SPAN("downsample");
+            SOBEL_TIME_STAGE(stageTicks_, sobel::PipelineStage::GrayConversion);
+            forEachBand([&](unsigned, size_t y0, size_t y1) {
+                for (size_t y = y0; y < y1; ++y) {
+                    const uint8_t* top = previous + 2 * y * previousStride;
+                    const uint8_t* bottom = previous + std::min(2 * y + 1, previousHeight - 1) * previousStride;
+                    sobel::downsampleRow2x(simd, top, bottom, previousWidth, plane.row(y));
+                }
+            });
+            plane.fillBorder(config_.border_mode);
+            useSource(plane);
         }
+        edges.edges = outputs[level].data();
+        runSobel(kernel, edges, false);
+        pixels += plane.width() * plane.height();
     }
+    endFrame();
 
+    if (enableProfiling) {
+        endProfiling();
+        recordMetrics(pixels, inputPixelBytes);
+    }
     return true;
 }
 
+bool SobelFilterSIMD::applyPyramid(const sobel::RGBImage& input, size_t levels,
+                                   std::vector<sobel::GrayscaleImage>& outputs, bool enableProfiling) {
+    return applyPyramid(rgbView(input), levels, outputs, enableProfiling);
+}
+
+bool SobelFilterSIMD::applyPyramid(const sobel::PackedImageView& input, size_t levels,
+                                   std::vector<sobel::GrayscaleImage>& outputs, bool enableProfiling) {
+    if (!input.empty() && (!input.data || input.resolvedStride() < input.rowBytes())) {
+        throw std::invalid_argument("Pixel view needs a data pointer and a stride of at least one row");
+    }
+    return applyPyramidFrame(input.width, input.height, sobel::pixelFormatBytes(input.format), levels, outputs,
+                             enableProfiling, [&] { prepareGray(input); });
+}
+
+bool SobelFilterSIMD::applyPyramid(const sobel::GrayscaleImage& input, size_t levels,
+                                   std::vector<sobel::GrayscaleImage>& outputs, bool enableProfiling) {
+    return applyPyramidFrame(input.width(), input.height(), 1, levels, outputs, enableProfiling,
+                             [&] { prepareLuma(input.data(), input.width(), 1, input.width(), input.height()); });
+}
+
+void SobelFilterSIMD::beginFrame() {
+    stageTicks_.fill(0);
+    allocationRecorder_.begin();
+    frameStart_ = std::chrono::steady_clock::now();
+}
+
+// Record the call's latency and fold its stage ticks into the running per-stage statistics
+void SobelFilterSIMD::endFrame() {
+    lastFrameTime_ = std::chrono::steady_clock::now() - frameStart_;
+    latency_.record(lastFrameTime_);
+    allocationRecorder_.end();
+    for (size_t i = 0; i < sobel::kPipelineStageCount; ++i) {
+        lastMetrics_.allocations[i].merge(allocationRecorder_.stages()[i]);
+    }
+    lastMetrics_.allocationTotal.merge(allocationRecorder_.total());
+#if SOBEL_STAGE_TIMERS
+    const double ticksPerUs = sobel::timestampTicksPerMicrosecond();
+    for (size_t i = 0; i < sobel::kPipelineStageCount; ++i) {
+        if (stageTicks_[i] != 0) lastMetrics_.stages[i].add(static_cast<double>(stageTicks_[i]) / ticksPerUs);
+    }
+#endif
+}
+
+void SobelFilterSIMD::recordMetrics(size_t totalPixels, size_t inputPixelBytes) {
+    // Calculate basic performance metrics
+    auto timeUs = lastMetrics_.processingTime.count();
+    lastMetrics_.pixelsPerSecond = (timeUs > 0) ? (totalPixels * 1000000ull) / timeUs : 0;
+    // Bytes streamed per second: input plus 8-bit output
+    lastMetrics_.memoryBandwidth = (timeUs > 0) ? (totalPixels * (inputPixelBytes + 1) * 1000000ull) / timeUs : 0;
+
+    switch (optimizationLevel_) {
+        case OptimizationLevel::AVX2:
+            lastMetrics_.optimizationUsed = "AVX2";
+            break;
+        case OptimizationLevel::SSE:
+            lastMetrics_.optimizationUsed = "SSE";
+            break;
+        default:
+            lastMetrics_.optimizationUsed = "Scalar";
+            break;
+    }
+}
+
 std::string SobelFilterSIMD::getCPUCapabilities() {
     std::stringstream ss;
     
@@ -252,6 +1239,15 @@ std::string SobelFilterSIMD::getCPUCapabilities() {
         bool avx2 = (cpuInfo[1] & (1 << 5)) != 0;
         if (avx2) ss << "AVX2 ";
     }
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse")) ss << "SSE ";
+    if (__builtin_cpu_supports("sse2")) ss << "SSE2 ";
+    if (__builtin_cpu_supports("sse3")) ss << "SSE3 ";
+    if (__builtin_cpu_supports("sse4.1")) ss << "SSE4.1 ";
+    if (__builtin_cpu_supports("sse4.2")) ss << "SSE4.2 ";
+    if (__builtin_cpu_supports("avx")) ss << "AVX ";
+    if (__builtin_cpu_supports("avx2")) ss << "AVX2 ";
 #else
     ss << "Unknown ";
 #endif
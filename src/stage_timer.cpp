@@ -0,0 +1,42 @@
+/**
+ * @file stage_timer.cpp
+ * @brief Stage names and timestamp counter calibration
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "stage_timer.hpp"
+
+namespace sobel {
+
+const char* stageName(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::Setup:          return "Buffer setup";
+        case PipelineStage::GrayConversion: return "Gray conversion";
+        case PipelineStage::Convolution:    return "Convolution";
+        case PipelineStage::Magnitude:      return "Magnitude";
+        case PipelineStage::Quantization:   return "Quantization";
+        case PipelineStage::Output:         return "Output";
+        case PipelineStage::Suppression:    return "Suppression";
+        case PipelineStage::Hysteresis:     return "Hysteresis";
+        default: return "Unknown";
+    }
+}
+
+double timestampTicksPerMicrosecond() {
+    // Invariant TSC runs at a fixed rate: a short spin against steady_clock is enough
+    static const double ticksPerUs = [] {
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        const uint64_t startTicks = readTimestamp();
+        while (Clock::now() - start < std::chrono::milliseconds(5)) {
+        }
+        const uint64_t ticks = readTimestamp() - startTicks;
+        const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        return us > 0.0 && ticks > 0 ? static_cast<double>(ticks) / us : 1000.0;
+    }();
+    return ticksPerUs;
+}
+
+} // namespace sobel
@@ -0,0 +1,235 @@
+/**
+ * @file tensor_export.cpp
+ * @brief Implementation of batched NCHW tensor export
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "tensor_export.hpp"
+#include "parallel_for.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sobel {
+
+namespace {
+
+#if defined(__AVX2__)
+inline __m256 loadFloats8(const uint8_t* p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+inline __m256 loadFloats8(const int16_t* p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+}
+inline __m256 loadFloats8(const float* p) { return _mm256_loadu_ps(p); }
+
+inline void storeFloats8(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+inline void storeFloats8(int8_t* p, __m256 v) {
+    // Clamp first: out-of-range conversions would otherwise wrap to INT_MIN
+    v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-128.0f)), _mm256_set1_ps(127.0f));
+    const __m256i i32 = _mm256_cvtps_epi32(v);
+    const __m128i i16 = _mm_packs_epi32(_mm256_castsi256_si128(i32), _mm256_extracti128_si256(i32, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packs_epi16(i16, i16));
+}
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX2__)
+inline __m128 loadFloats4(const uint8_t* p) {
+    int32_t bytes;
+    std::memcpy(&bytes, p, sizeof(bytes));
+    return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)));
+}
+inline __m128 loadFloats4(const int16_t* p) {
+    return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+inline __m128 loadFloats4(const float* p) { return _mm_loadu_ps(p); }
+
+inline void storeFloats4(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+inline void storeFloats4(int8_t* p, __m128 v) {
+    v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-128.0f)), _mm_set1_ps(127.0f));
+    const __m128i i16 = _mm_packs_epi32(_mm_cvtps_epi32(v), _mm_setzero_si128());
+    const int32_t bytes = _mm_cvtsi128_si32(_mm_packs_epi16(i16, i16));
+    std::memcpy(p, &bytes, sizeof(bytes));
+}
+#endif
+
+inline void storeScalar(float* p, float v) { *p = v; }
+inline void storeScalar(int8_t* p, float v) {
+    // nearbyint follows the current rounding mode (ties to even), like cvtps
+    *p = static_cast<int8_t>(std::nearbyint(std::clamp(v, -128.0f, 127.0f)));
+}
+
+template<typename In, typename Out>
+void convertAffine(SimdLevel level, const In* input, std::size_t count, float scale, float offset, Out* output) {
+    (void)level;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if (level == SimdLevel::AVX2) {
+        const __m256 vScale = _mm256_set1_ps(scale);
+        const __m256 vOffset = _mm256_set1_ps(offset);
+        for (; i + 8 <= count; i += 8) {
+            storeFloats8(output + i, _mm256_add_ps(_mm256_mul_ps(loadFloats8(input + i), vScale), vOffset));
+        }
+    }
+#endif
+#if defined(__SSE4_1__) || defined(__AVX2__)
+    if (level != SimdLevel::Scalar) {
+        const __m128 vScale = _mm_set1_ps(scale);
+        const __m128 vOffset = _mm_set1_ps(offset);
+        for (; i + 4 <= count; i += 4) {
+            storeFloats4(output + i, _mm_add_ps(_mm_mul_ps(loadFloats4(input + i), vScale), vOffset));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        storeScalar(output + i, static_cast<float>(input[i]) * scale + offset);
+    }
+}
+
+SimdLevel levelFor(SobelFilterSIMD::OptimizationLevel level) {
+    switch (level) {
+        case SobelFilterSIMD::OptimizationLevel::AVX2: return SimdLevel::AVX2;
+        case SobelFilterSIMD::OptimizationLevel::SSE: return SimdLevel::SSE;
+        case SobelFilterSIMD::OptimizationLevel::SCALAR: return SimdLevel::Scalar;
+        default: return detectSimdLevel();
+    }
+}
+
+} // namespace
+
+void convertToTensor(SimdLevel level, const uint8_t* input, std::size_t count, float scale, float offset, float* output) {
+    convertAffine(level, input, count, scale, offset, output);
+}
+void convertToTensor(SimdLevel level, const int16_t* input, std::size_t count, float scale, float offset, float* output) {
+    convertAffine(level, input, count, scale, offset, output);
+}
+void convertToTensor(SimdLevel level, const float* input, std::size_t count, float scale, float offset, float* output) {
+    convertAffine(level, input, count, scale, offset, output);
+}
+void convertToTensor(SimdLevel level, const uint8_t* input, std::size_t count, float scale, float offset, int8_t* output) {
+    convertAffine(level, input, count, scale, offset, output);
+}
+void convertToTensor(SimdLevel level, const int16_t* input, std::size_t count, float scale, float offset, int8_t* output) {
+    convertAffine(level, input, count, scale, offset, output);
+}
+void convertToTensor(SimdLevel level, const float* input, std::size_t count, float scale, float offset, int8_t* output) {
+    convertAffine(level, input, count, scale, offset, output);
+}
+
+TensorExporter::TensorExporter(const TensorExportConfig& config)
+    : config_(config), level_(levelFor(config.optimization)) {}
+
+template<typename T>
+void TensorExporter::exportEdgeMapsImpl(const std::vector<GrayscaleImage>& maps, T* tensor) const {
+    if (maps.empty()) return;
+    const std::size_t w = maps.front().width();
+    const std::size_t h = maps.front().height();
+    for (const auto& map : maps) {
+        if (map.width() != w || map.height() != h) {
+            throw std::invalid_argument("All edge maps in a batch must have the same size");
+        }
+    }
+
+    const std::size_t plane = w * h;
+    parallelFor(maps.size(), config_.threads, [&](unsigned, std::size_t n) {
+        convertToTensor(level_, maps[n].data(), plane, config_.scale, config_.offset, tensor + n * plane);
+    });
+}
+
+template<typename T>
+void TensorExporter::exportBatchImpl(const std::vector<RGBImage>& frames, const SobelConfig& filterConfig,
+                                     TensorContent content, T* tensor) const {
+    if (frames.empty()) return;
+    const std::size_t w = frames.front().width();
+    const std::size_t h = frames.front().height();
+    for (const auto& frame : frames) {
+        if (frame.empty() || frame.width() != w || frame.height() != h) {
+            throw std::invalid_argument("All frames in a batch must be non-empty and of the same size");
+        }
+    }
+
+    // Per-worker filter and scratch planes, reused for every frame the worker takes
+    struct Worker {
+        std::optional<SobelFilterSIMD> filter;
+        std::vector<uint8_t> edges;
+        std::vector<int16_t> gx;
+        std::vector<int16_t> gy;
+        std::vector<float> magnitude;
+    };
+    const unsigned threads = resolveThreadCount(config_.threads);
+    std::vector<Worker> workers(std::min<std::size_t>(threads, frames.size()));
+
+    const std::size_t plane = w * h;
+    const std::size_t channels = tensorChannels(content);
+    parallelFor(frames.size(), config_.threads, [&](unsigned index, std::size_t n) {
+        Worker& worker = workers[index];
+        if (!worker.filter) {
+            worker.filter.emplace(filterConfig, config_.optimization);
+            if (workers.size() > 1) {
+                // Parallelism is across frames; keep each filter on its worker thread
+                TuningParameters tuning;
+                tuning.level = levelFor(config_.optimization);
+                worker.filter->setTuning(tuning);
+            }
+            if (content == TensorContent::EdgeMap) {
+                worker.edges.resize(plane);
+            } else {
+                worker.gx.resize(plane);
+                worker.gy.resize(plane);
+            }
+        }
+
+        T* slice = tensor + n * channels * plane;
+        SobelFilterSIMD::OutputDescriptor outputs;
+        outputs.edges = worker.edges.empty() ? nullptr : worker.edges.data();
+        outputs.gx = worker.gx.empty() ? nullptr : worker.gx.data();
+        outputs.gy = worker.gy.empty() ? nullptr : worker.gy.data();
+        if (content == TensorContent::GradientsAndMagnitude) {
+            // A float tensor receives the magnitude in place; int8 needs a staging plane
+            if constexpr (std::is_same_v<T, float>) {
+                outputs.magnitude = slice + 2 * plane;
+            } else {
+                if (worker.magnitude.empty()) worker.magnitude.resize(plane);
+                outputs.magnitude = worker.magnitude.data();
+            }
+        }
+        worker.filter->apply(frames[n], outputs);
+
+        if (outputs.edges) {
+            convertToTensor(level_, outputs.edges, plane, config_.scale, config_.offset, slice);
+        }
+        if (outputs.gx) {
+            convertToTensor(level_, outputs.gx, plane, config_.scale, config_.offset, slice);
+            convertToTensor(level_, outputs.gy, plane, config_.scale, config_.offset, slice + plane);
+        }
+        if (outputs.magnitude && (!std::is_same_v<T, float> || config_.scale != 1.0f || config_.offset != 0.0f)) {
+            convertToTensor(level_, outputs.magnitude, plane, config_.scale, config_.offset, slice + 2 * plane);
+        }
+    });
+}
+
+void TensorExporter::exportEdgeMaps(const std::vector<GrayscaleImage>& maps, float* tensor) const {
+    exportEdgeMapsImpl(maps, tensor);
+}
+
+void TensorExporter::exportEdgeMaps(const std::vector<GrayscaleImage>& maps, int8_t* tensor) const {
+    exportEdgeMapsImpl(maps, tensor);
+}
+
+void TensorExporter::exportBatch(const std::vector<RGBImage>& frames, const SobelConfig& filterConfig,
+                                 TensorContent content, float* tensor) const {
+    exportBatchImpl(frames, filterConfig, content, tensor);
+}
+
+void TensorExporter::exportBatch(const std::vector<RGBImage>& frames, const SobelConfig& filterConfig,
+                                 TensorContent content, int8_t* tensor) const {
+    exportBatchImpl(frames, filterConfig, content, tensor);
+}
+
+} // namespace sobel
@@ -0,0 +1,296 @@
+/**
+ * @file tracer.cpp
+ * @brief Implementation of the span tracer and Chrome Trace Event writer
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "tracer.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sobel {
+
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+
+constexpr std::size_t kChunkSpans = 4096;
+
+/**
+ * @brief Fixed block of spans written by one thread
+ *
+ * The owning thread fills slots in order and publishes each with a release
+ * store of `count`; readers load `count` with acquire and only touch slots
+ * below it. A full chunk gets a successor linked through `next`.
+ */
+struct Chunk {
+    std::array<TraceSpan, kChunkSpans> spans;
+    std::atomic<std::size_t> count{0};
+    std::atomic<Chunk*> next{nullptr};
+};
+
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    Chunk head;
+    Chunk* tail = &head;   // Only touched by the owning thread (and clear())
+
+    ~ThreadBuffer() { releaseChunks(); }
+
+    // Free every chunk after the head and empty the head
+    void releaseChunks() {
+        Chunk* chunk = head.next.load(std::memory_order_relaxed);
+        while (chunk) {
+            Chunk* next = chunk->next.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+        head.next.store(nullptr, std::memory_order_relaxed);
+        head.count.store(0, std::memory_order_relaxed);
+        tail = &head;
+    }
+
+    std::size_t spanCount() const {
+        std::size_t total = 0;
+        for (const Chunk* chunk = &head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            total += chunk->count.load(std::memory_order_acquire);
+        }
+        return total;
+    }
+
+    template<typename Visit>
+    void forEachSpan(Visit&& visit) const {
+        for (const Chunk* chunk = &head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            const std::size_t count = chunk->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; ++i) visit(chunk->spans[i]);
+        }
+    }
+};
+
+// Spans of a thread that has exited, without the chunk slack
+struct RetiredThread {
+    uint32_t tid;
+    std::vector<TraceSpan> spans;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadBuffer*> buffers;     // Live threads; each owned by its thread's BufferOwner
+    std::vector<RetiredThread> retired;
+    uint32_t nextTid = 1;
+    std::string outputPath;
+    bool exitHandlerInstalled = false;
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Trivially destructible, so it stays usable while thread_local destructors run
+struct ThreadState {
+    ThreadBuffer* buffer = nullptr;
+    uint64_t frame = 0;
+    bool exited = false;   // The buffer was retired; later spans of this thread are dropped
+};
+
+thread_local ThreadState threadState;
+
+// Retires the thread's buffer at thread exit: spans move to the registry, the chunks are freed
+struct BufferOwner {
+    std::unique_ptr<ThreadBuffer> buffer;
+
+    ~BufferOwner() {
+        threadState.buffer = nullptr;
+        threadState.exited = true;
+        if (!buffer) return;
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.erase(std::find(reg.buffers.begin(), reg.buffers.end(), buffer.get()));
+        RetiredThread thread{buffer->tid, {}};
+        thread.spans.reserve(buffer->spanCount());
+        buffer->forEachSpan([&](const TraceSpan& span) { thread.spans.push_back(span); });
+        if (!thread.spans.empty()) reg.retired.push_back(std::move(thread));
+    }
+};
+
+thread_local BufferOwner bufferOwner;
+
+std::atomic<uint64_t> frameCounter{0};
+
+ThreadBuffer* registerThread() {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffer->tid = reg.nextTid++;
+        reg.buffers.push_back(buffer.get());
+    }
+    bufferOwner.buffer = std::move(buffer);
+    return bufferOwner.buffer.get();
+}
+
+void dumpAtExit() {
+    Registry& reg = registry();
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        path = reg.outputPath;
+    }
+    if (!path.empty() && !Tracer::writeChromeTrace(path)) {
+        std::fprintf(stderr, "Warning: could not write trace to %s\n", path.c_str());
+    }
+}
+
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') out << '\\';
+        out << *p;
+    }
+    out << '"';
+}
+
+// Timestamps in Chrome traces are microseconds; keep nanosecond resolution
+void writeMicros(std::ostream& out, uint64_t ns) {
+    out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+}
+
+// Honour SOBEL_TRACE=<file> so any binary linked against the library can be traced
+struct EnvironmentInit {
+    EnvironmentInit() {
+        const char* path = std::getenv("SOBEL_TRACE");
+        if (path && *path) Tracer::enable(path);
+    }
+} environmentInit;
+
+} // namespace
+
+void Tracer::enable(const std::string& outputPath) {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (!outputPath.empty()) reg.outputPath = outputPath;
+        if (!reg.outputPath.empty() && !reg.exitHandlerInstalled) {
+            // Registered after the registry was constructed, so it runs before the registry is destroyed
+            std::atexit(dumpAtExit);
+            reg.exitHandlerInstalled = true;
+        }
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::now() noexcept {
+    const auto elapsed = std::chrono::steady_clock::now() - registry().epoch;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + 1;
+}
+
+void Tracer::record(const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadState& state = threadState;
+    if (!state.buffer) {
+        if (state.exited) return;
+        state.buffer = registerThread();
+    }
+
+    ThreadBuffer& buffer = *state.buffer;
+    Chunk* chunk = buffer.tail;
+    std::size_t n = chunk->count.load(std::memory_order_relaxed);
+    if (n == kChunkSpans) {
+        Chunk* next = new Chunk;
+        chunk->next.store(next, std::memory_order_release);
+        buffer.tail = next;
+        chunk = next;
+        n = 0;
+    }
+    chunk->spans[n] = TraceSpan{name, state.frame, startNs, endNs};
+    chunk->count.store(n + 1, std::memory_order_release);
+}
+
+uint64_t Tracer::currentFrame() noexcept {
+    return threadState.frame;
+}
+
+void Tracer::setCurrentFrame(uint64_t frameId) noexcept {
+    threadState.frame = frameId;
+}
+
+uint64_t Tracer::nextFrameId() noexcept {
+    return frameCounter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+std::size_t Tracer::spanCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::size_t total = 0;
+    for (const ThreadBuffer* buffer : reg.buffers) total += buffer->spanCount();
+    for (const RetiredThread& thread : reg.retired) total += thread.spans.size();
+    return total;
+}
+
+std::size_t Tracer::bufferCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.buffers.size();
+}
+
+void Tracer::writeChromeTrace(std::ostream& out) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto writeThread = [&](uint32_t tid) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+    };
+    auto writeSpan = [&](uint32_t tid, const TraceSpan& span) {
+        out << ",\n{\"name\":";
+        writeJsonString(out, span.name);
+        out << ",\"cat\":\"sobel\",\"ph\":\"X\",\"ts\":";
+        writeMicros(out, span.startNs);
+        out << ",\"dur\":";
+        writeMicros(out, span.endNs > span.startNs ? span.endNs - span.startNs : 0);
+        out << ",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"frame\":" << span.frameId << "}}";
+    };
+    for (const RetiredThread& thread : reg.retired) {
+        writeThread(thread.tid);
+        for (const TraceSpan& span : thread.spans) writeSpan(thread.tid, span);
+    }
+    for (const ThreadBuffer* buffer : reg.buffers) {
+        writeThread(buffer->tid);
+        buffer->forEachSpan([&](const TraceSpan& span) { writeSpan(buffer->tid, span); });
+    }
+    out << "\n]}\n";
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) return false;
+    writeChromeTrace(file);
+    return static_cast<bool>(file);
+}
+
+void Tracer::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (ThreadBuffer* buffer : reg.buffers) buffer->releaseChunks();
+    reg.retired.clear();
+}
+
+} // namespace sobel
@@ -0,0 +1,57 @@
+/**
+ * @file tsv_records.cpp
+ * @brief Implementation of the tab-separated record reader and writer
+ * @author BK Park
+ * @version 1.0.0
+ * @date 2025-08-27
+ */
+
+#include "tsv_records.hpp"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace sobel {
+
+void readTsvRecords(const std::string& path, std::size_t fieldCount,
+                    const std::function<void(const std::vector<std::string>& fields)>& parse) {
+    std::ifstream file(path);
+    std::string line;
+    std::size_t lineNumber = 0;
+    std::vector<std::string> fields;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') continue;
+        fields.clear();
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '\t')) fields.push_back(field);
+        const std::string where = path + ":" + std::to_string(lineNumber) + ": ";
+        if (fields.size() != fieldCount) {
+            throw std::runtime_error(where + "expected " + std::to_string(fieldCount) + " tab-separated fields");
+        }
+        try {
+            parse(fields);
+        } catch (const TsvFieldError& error) {
+            throw std::runtime_error(where + error.what());
+        } catch (const std::logic_error&) {   // std::invalid_argument / std::out_of_range from stoi and friends
+            throw std::runtime_error(where + "malformed number");
+        }
+    }
+}
+
+void writeTsvRecords(const std::string& path, const std::string& what, const std::vector<std::string>& columns,
+                     std::size_t count, const std::function<void(std::ostream& out, std::size_t index)>& writeRecord) {
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("Cannot write " + what + " " + path);
+    file << "#";
+    for (std::size_t i = 0; i < columns.size(); ++i) file << (i ? "\t" : " ") << columns[i];
+    file << '\n';
+    file << std::setprecision(1) << std::fixed;
+    for (std::size_t i = 0; i < count; ++i) {
+        writeRecord(file, i);
+        file << '\n';
+    }
+}
+
+} // namespace sobel
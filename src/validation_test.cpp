@@ -8,6 +8,17 @@
 #include "sobel_filter.hpp"
 #include "sobel_filter_simd.hpp"
 #include "image.hpp"
+#include "convolution_engine.hpp"
+#include "canny.hpp"
+#include "tensor_export.hpp"
+#include "benchmark_harness.hpp"
+#include "perf_counters.hpp"
+#include "tracer.hpp"
+#include "allocation_tracker.hpp"
+#include "autotuner.hpp"
+#include "adaptive_quality.hpp"
+#include "image_io.hpp"
+#include "yuv_image.hpp"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -15,6 +26,14 @@
 #include <random>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <stdexcept>
+#include <fstream>
+#include <type_traits>
+#include <atomic>
+#include <memory>
 
 using namespace sobel;
 
@@ -80,6 +99,45 @@ private:
         return img;
     }
     
+    GrayscaleImage createRandomGrayImage(size_t width, size_t height, uint32_t seed = 42) {
+        GrayscaleImage img(width, height);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, 255);
+        for (size_t i = 0; i < img.size(); ++i) {
+            img.data()[i] = static_cast<uint8_t>(dist(rng));
+        }
+        return img;
+    }
+    
+    // Direct 2D convolution used as the reference for every engine path
+    std::vector<int32_t> referenceConvolve(const GrayscaleImage& image, const ConvolutionKernel& kernel,
+                                           BorderMode border) {
+        const int w = static_cast<int>(image.width());
+        const int h = static_cast<int>(image.height());
+        const int rx = static_cast<int>(kernel.width() / 2);
+        const int ry = static_cast<int>(kernel.height() / 2);
+        std::vector<int32_t> result(image.size());
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                int32_t sum = 0;
+                for (int ky = -ry; ky <= ry; ++ky) {
+                    for (int kx = -rx; kx <= rx; ++kx) {
+                        int px = x + kx, py = y + ky;
+                        int value = 0;
+                        if (border == BorderMode::Replicate) {
+                            value = image.at(std::clamp(px, 0, w - 1), std::clamp(py, 0, h - 1));
+                        } else if (px >= 0 && px < w && py >= 0 && py < h) {
+                            value = image.at(px, py);
+                        }
+                        sum += value * kernel.at(kx + rx, ky + ry);
+                    }
+                }
+                result[y * w + x] = sum;
+            }
+        }
+        return result;
+    }
+    
     // Compare two grayscale images
     TestResult compareImages(const GrayscaleImage& baseline, const GrayscaleImage& simd, 
                            const std::string& testName, double maxAllowedDiff = 1.0) {
@@ -244,7 +302,2237 @@ public:
         }
     }
     
-    void printSummary() {
+    void testKernelSizes() {
+        std::cout << "\n=== Kernel Size Tests ===" << std::endl;
+        
+        std::vector<std::pair<RGBImage, std::string>> testImages = {
+            {createCheckerboardImage(48, 37, 4), "Checkerboard 4x4"},
+            {createRandomImage(61, 29, 7), "Random Noise"},
+            {createSolidColorImage(2, 2, 10, 200, 30), "2x2 image"}
+        };
+        
+        std::vector<std::pair<SobelFilterSIMD::OptimizationLevel, std::string>> levels = {
+            {SobelFilterSIMD::OptimizationLevel::SCALAR, "Scalar"},
+            {SobelFilterSIMD::OptimizationLevel::SSE, "SSE"},
+            {SobelFilterSIMD::OptimizationLevel::AVX2, "AVX2"}
+        };
+        
+        for (int kernelSize : {3, 5, 7}) {
+            SobelConfig config;
+            config.kernel_size = kernelSize;
+            
+            // The instance accessors follow kernel_size; the static ones stay 5x5
+            const SobelFilter sized(config);
+            const ConvolutionKernel kx = sized.kernelX(), ky = sized.kernelY();
+            bool matches = kx.width() == static_cast<size_t>(kernelSize) && ky.height() == kx.width();
+            for (size_t i = 0; matches && i < kx.coefficients().size(); ++i) {
+                matches = kx.coefficients()[i] == ConvolutionKernel::sobelX(kernelSize).coefficients()[i] &&
+                          ky.coefficients()[i] == ConvolutionKernel::sobelY(kernelSize).coefficients()[i];
+            }
+            matches = matches && SobelFilter::getKernelX()[2][0] == makeSobelKernelX<5>()[2][0] &&
+                      SobelFilter::getKernelY()[0][2] == makeSobelKernelY<5>()[0][2];
+            const std::string accessorName = std::to_string(kernelSize) + "x" + std::to_string(kernelSize) +
+                                             " | kernel accessors follow kernel_size";
+            results_.push_back({matches, accessorName, matches ? "OK" : "Mismatch", 0, 0});
+            std::cout << (matches ? "✅ PASS" : "❌ FAIL") << " " << accessorName << std::endl;
+            
+            for (const auto& [testImage, imageName] : testImages) {
+                SobelFilter baseline(config);
+                GrayscaleImage baselineResult = baseline.apply(testImage);
+                
+                for (const auto& [level, levelName] : levels) {
+                    SobelFilterSIMD simdFilter(config, level);
+                    GrayscaleImage simdResult;
+                    simdFilter.apply(testImage, simdResult, false);
+                    
+                    std::string testName = std::to_string(kernelSize) + "x" + std::to_string(kernelSize) +
+                                           " | " + imageName + " | " + levelName;
+                    TestResult result = compareImages(baselineResult, simdResult, testName, 1.0);
+                    results_.push_back(result);
+                    
+                    std::cout << (result.passed ? "✅ PASS" : "❌ FAIL") 
+                              << " " << testName << std::endl;
+                    std::cout << "   " << result.details << std::endl;
+                }
+            }
+        }
+    }
+    
+    void testConvolutionEngine() {
+        std::cout << "\n=== Convolution Engine Tests ===" << std::endl;
+        
+        struct KernelCase {
+            ConvolutionKernel kernel;
+            std::string name;
+            bool expectSeparable;
+            ConvolutionPath expectedPath;
+        };
+        std::vector<KernelCase> kernels = {
+            {ConvolutionKernel::sobelX(5), "Sobel 5x5 X", true, ConvolutionPath::Separable},
+            {ConvolutionKernel::sobelY(7), "Sobel 7x7 Y", true, ConvolutionPath::Separable},
+            {ConvolutionKernel::scharrX(), "Scharr X", true, ConvolutionPath::Separable},
+            {ConvolutionKernel(3, 3, {0, 1, 0, 1, -4, 1, 0, 1, 0}), "Laplacian 3x3", false, ConvolutionPath::DenseInt16},
+            {ConvolutionKernel(5, 3, {1, 2, 3, 2, 1, -9, 40, -9, 7, 0, 60, -1, 2, 5, 90}), "Custom 5x3", false, ConvolutionPath::DenseInt32}
+        };
+        
+        std::vector<std::pair<SimdLevel, std::string>> levels = {
+            {SimdLevel::Scalar, "Scalar"}, {SimdLevel::SSE, "SSE"}, {SimdLevel::AVX2, "AVX2"}
+        };
+        std::vector<std::pair<ConvolutionPath, std::string>> paths = {
+            {ConvolutionPath::Separable, "separable"}, {ConvolutionPath::DenseInt16, "dense int16"},
+            {ConvolutionPath::DenseInt32, "dense int32"}
+        };
+        
+        GrayscaleImage image = createRandomGrayImage(45, 23, 11);
+        
+        for (const auto& kc : kernels) {
+            ConvolutionEngine engine(kc.kernel);
+            bool analysisOk = engine.isSeparable() == kc.expectSeparable && engine.path() == kc.expectedPath;
+            std::string analysisName = kc.name + " | path selection";
+            results_.push_back({analysisOk, analysisName, analysisOk ? "OK" : "Unexpected path", 0, 0});
+            std::cout << (analysisOk ? "✅ PASS" : "❌ FAIL") << " " << analysisName << std::endl;
+            
+            for (BorderMode border : {BorderMode::Replicate, BorderMode::Zero}) {
+                std::vector<int32_t> expected = referenceConvolve(image, kc.kernel, border);
+                for (const auto& [path, pathName] : paths) {
+                    try {
+                        engine.setPath(path);
+                    } catch (const std::invalid_argument&) {
+                        continue; // Path not valid for this kernel
+                    }
+                    for (const auto& [level, levelName] : levels) {
+                        std::vector<int32_t> actual = engine.convolve(image, border, level);
+                        bool same = actual == expected;
+                        std::string testName = kc.name + " | " + pathName + " | " +
+                                               (border == BorderMode::Zero ? "zero" : "replicate") + " | " + levelName;
+                        results_.push_back({same, testName, same ? "Exact match" : "Mismatch vs reference", 0, 0});
+                        std::cout << (same ? "✅ PASS" : "❌ FAIL") << " " << testName << std::endl;
+                    }
+                }
+            }
+        }
+        
+        // Zero border mode must agree between the baseline and SIMD filters
+        SobelConfig config;
+        config.border_mode = BorderMode::Zero;
+        RGBImage testImage = createRandomImage(37, 21, 5);
+        GrayscaleImage baselineResult = SobelFilter(config).apply(testImage);
+        for (const auto& [level, levelName] : std::vector<std::pair<SobelFilterSIMD::OptimizationLevel, std::string>>{
+                 {SobelFilterSIMD::OptimizationLevel::SCALAR, "Scalar"},
+                 {SobelFilterSIMD::OptimizationLevel::AVX2, "AVX2"}}) {
+            SobelFilterSIMD simdFilter(config, level);
+            GrayscaleImage simdResult;
+            simdFilter.apply(testImage, simdResult, false);
+            TestResult result = compareImages(baselineResult, simdResult, "Zero border | " + levelName, 1.0);
+            results_.push_back(result);
+            std::cout << (result.passed ? "✅ PASS" : "❌ FAIL") << " " << result.testName << std::endl;
+            std::cout << "   " << result.details << std::endl;
+        }
+    }
+    
+    void testOrientationAndCanny() {
+        std::cout << "\n=== Orientation and Canny Tests ===" << std::endl;
+        
+        // Fixed-point direction bins agree with atan2 away from the bin boundaries
+        {
+            std::mt19937 rng(3);
+            std::uniform_int_distribution<int> dist(-20000, 20000);
+            size_t mismatches = 0;
+            for (int i = 0; i < 100000; ++i) {
+                int gx = dist(rng), gy = dist(rng);
+                if (gx == 0 && gy == 0) continue;
+                double angle = std::atan2(static_cast<double>(gy), static_cast<double>(gx)) * 180.0 / 3.14159265358979;
+                if (angle < 0) angle += 180.0;
+                double nearestBoundary = 1e9;
+                for (double b : {22.5, 67.5, 112.5, 157.5}) nearestBoundary = std::min(nearestBoundary, std::abs(angle - b));
+                if (nearestBoundary < 0.1) continue;
+                int expected = angle < 22.5 || angle >= 157.5 ? 0 : angle < 67.5 ? 1 : angle < 112.5 ? 2 : 3;
+                if (static_cast<int>(quantizeDirection(gx, gy)) != expected) ++mismatches;
+            }
+            bool passed = mismatches == 0;
+            results_.push_back({passed, "Direction quantization vs atan2", std::to_string(mismatches) + " mismatches", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " Direction quantization vs atan2" << std::endl;
+        }
+        
+        // Horizontal step edge whose contrast fades from strong (left) to weak (right)
+        const size_t w = 96, h = 40, edgeRow = 20;
+        RGBImage stepImage(w, h);
+        RGBImage weakOnly(w, h);
+        for (size_t y = 0; y < h; ++y) {
+            for (size_t x = 0; x < w; ++x) {
+                uint8_t v = y < edgeRow ? 0 : static_cast<uint8_t>(100 - 80 * x / (w - 1));
+                stepImage.at(x, y) = RGBPixel(v, v, v);
+                uint8_t weak = y < edgeRow ? 0 : 25;
+                weakOnly.at(x, y) = RGBPixel(weak, weak, weak);
+            }
+        }
+        
+        std::vector<std::pair<SobelFilterSIMD::OptimizationLevel, std::string>> levels = {
+            {SobelFilterSIMD::OptimizationLevel::SCALAR, "Scalar"},
+            {SobelFilterSIMD::OptimizationLevel::SSE, "SSE"},
+            {SobelFilterSIMD::OptimizationLevel::AVX2, "AVX2"}
+        };
+        
+        for (int kernelSize : {3, 5, 7}) {
+            SobelConfig config;
+            config.kernel_size = kernelSize;
+            GrayscaleImage scalarEdges;
+            SobelFilterSIMD(config, SobelFilterSIMD::OptimizationLevel::SCALAR).applyCanny(stepImage, scalarEdges);
+            
+            for (const auto& [level, levelName] : levels) {
+                SobelFilterSIMD filter(config, level);
+                GrayscaleImage edges, weakEdges;
+                filter.applyCanny(stepImage, edges);
+                filter.applyCanny(weakOnly, weakEdges);
+                
+                // Exactly one edge pixel per column, on the step, including the weak tail
+                bool thinLine = true;
+                for (size_t x = 4; x < w - 4; ++x) {
+                    size_t count = 0;
+                    for (size_t y = 0; y < h; ++y) count += edges.at(x, y) == 255;
+                    thinLine = thinLine && count == 1 && (edges.at(x, edgeRow - 1) == 255 || edges.at(x, edgeRow) == 255);
+                }
+                bool noWeakOnly = std::all_of(weakEdges.data(), weakEdges.data() + weakEdges.size(),
+                                              [](uint8_t v) { return v == 0; });
+                bool sameAsScalar = std::equal(edges.data(), edges.data() + edges.size(), scalarEdges.data());
+                
+                std::string prefix = "Canny " + std::to_string(kernelSize) + "x" + std::to_string(kernelSize) + " | " + levelName;
+                for (const auto& [ok, what] : {std::make_pair(thinLine, std::string("thin connected edge")),
+                                                std::make_pair(noWeakOnly, std::string("weak-only edges rejected")),
+                                                std::make_pair(sameAsScalar, std::string("matches scalar"))}) {
+                    results_.push_back({ok, prefix + " | " + what, ok ? "OK" : "Mismatch", 0, 0});
+                    std::cout << (ok ? "✅ PASS" : "❌ FAIL") << " " << prefix << " | " << what << std::endl;
+                }
+                
+                GrayscaleImage directions;
+                filter.computeOrientation(stepImage, directions);
+                bool vertical = directions.at(10, edgeRow - 1) == static_cast<uint8_t>(GradientDirection::Vertical);
+                results_.push_back({vertical, prefix + " | step orientation", vertical ? "OK" : "Wrong bin", 0, 0});
+                std::cout << (vertical ? "✅ PASS" : "❌ FAIL") << " " << prefix << " | step orientation" << std::endl;
+            }
+        }
+    }
+    
+    void testMultiOutput() {
+        std::cout << "\n=== Multi-Output Descriptor Tests ===" << std::endl;
+        
+        const size_t w = 45, h = 23, pad = 3;
+        RGBImage input = createRandomImage(w, h, 13);
+        GrayscaleImage gray(w, h);
+        for (size_t y = 0; y < h; ++y) {
+            for (size_t x = 0; x < w; ++x) gray.at(x, y) = input.at(x, y).toGrayscale();
+        }
+        
+        std::vector<std::pair<SobelFilterSIMD::OptimizationLevel, std::string>> levels = {
+            {SobelFilterSIMD::OptimizationLevel::SCALAR, "Scalar"},
+            {SobelFilterSIMD::OptimizationLevel::SSE, "SSE"},
+            {SobelFilterSIMD::OptimizationLevel::AVX2, "AVX2"}
+        };
+        
+        for (int kernelSize : {3, 5, 7}) {
+            std::vector<int32_t> refX = referenceConvolve(gray, ConvolutionKernel::sobelX(kernelSize), BorderMode::Replicate);
+            std::vector<int32_t> refY = referenceConvolve(gray, ConvolutionKernel::sobelY(kernelSize), BorderMode::Replicate);
+            auto saturate = [](int32_t v) { return static_cast<int16_t>(std::clamp(v, -32768, 32767)); };
+            
+            SobelConfig config;
+            config.kernel_size = kernelSize;
+            for (const auto& [level, levelName] : levels) {
+                SobelFilterSIMD filter(config, level);
+                GrayscaleImage expectedEdges;
+                filter.apply(input, expectedEdges);
+                
+                // Padded strides with sentinels to catch writes past the row width
+                const size_t stride = w + pad;
+                std::vector<int16_t> gx(stride * h, 0x5A5A), gy(stride * h, 0x5A5A);
+                std::vector<float> magnitude(stride * h, -1.0f);
+                std::vector<uint8_t> edges(stride * h, 0xA5);
+                SobelFilterSIMD::OutputDescriptor outputs;
+                outputs.gx = gx.data();
+                outputs.gy = gy.data();
+                outputs.magnitude = magnitude.data();
+                outputs.edges = edges.data();
+                outputs.gxStride = outputs.gyStride = outputs.magnitudeStride = outputs.edgesStride = stride;
+                bool ok = filter.apply(input, outputs);
+                
+                bool gradientsMatch = ok, magnitudeMatch = ok, edgesMatch = ok, paddingIntact = true;
+                for (size_t y = 0; y < h; ++y) {
+                    for (size_t x = 0; x < w; ++x) {
+                        const size_t i = y * stride + x;
+                        const int32_t ex = refX[y * w + x], ey = refY[y * w + x];
+                        gradientsMatch = gradientsMatch && gx[i] == saturate(ex) && gy[i] == saturate(ey);
+                        const float fx = static_cast<float>(ex), fy = static_cast<float>(ey);
+                        magnitudeMatch = magnitudeMatch && magnitude[i] == std::sqrt(fx * fx + fy * fy);
+                        edgesMatch = edgesMatch && edges[i] == expectedEdges.at(x, y);
+                    }
+                    for (size_t x = w; x < stride; ++x) {
+                        const size_t i = y * stride + x;
+                        paddingIntact = paddingIntact && gx[i] == 0x5A5A && gy[i] == 0x5A5A &&
+                                        magnitude[i] == -1.0f && edges[i] == 0xA5;
+                    }
+                }
+                
+                // A single plane, tightly packed
+                std::vector<int16_t> gyOnly(w * h);
+                SobelFilterSIMD::OutputDescriptor single;
+                single.gy = gyOnly.data();
+                bool singleMatch = filter.apply(input, single);
+                for (size_t i = 0; i < w * h; ++i) singleMatch = singleMatch && gyOnly[i] == saturate(refY[i]);
+                
+                std::string prefix = "Multi-output " + std::to_string(kernelSize) + "x" + std::to_string(kernelSize) + " | " + levelName;
+                for (const auto& [passed, what] : {std::make_pair(gradientsMatch, std::string("int16 Gx/Gy")),
+                                                    std::make_pair(magnitudeMatch, std::string("float magnitude")),
+                                                    std::make_pair(edgesMatch, std::string("edge map")),
+                                                    std::make_pair(paddingIntact, std::string("stride padding untouched")),
+                                                    std::make_pair(singleMatch, std::string("single plane"))}) {
+                    results_.push_back({passed, prefix + " | " + what, passed ? "OK" : "Mismatch", 0, 0});
+                    std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << prefix << " | " << what << std::endl;
+                }
+            }
+        }
+        
+        SobelFilterSIMD filter;
+        bool rejectsEmpty = !filter.apply(input, SobelFilterSIMD::OutputDescriptor());
+        results_.push_back({rejectsEmpty, "Multi-output | no planes requested", rejectsEmpty ? "OK" : "Accepted", 0, 0});
+        std::cout << (rejectsEmpty ? "✅ PASS" : "❌ FAIL") << " Multi-output | no planes requested" << std::endl;
+    }
+    
+    void testTensorExport() {
+        std::cout << "\n=== Tensor Export Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        
+        // Row conversion kernels agree with the scalar path, including the tails and int8 rounding/saturation
+        {
+            const size_t count = 77;
+            std::mt19937 rng(17);
+            std::vector<uint8_t> u8(count);
+            std::vector<int16_t> i16(count);
+            std::vector<float> f32(count);
+            for (size_t i = 0; i < count; ++i) {
+                u8[i] = static_cast<uint8_t>(rng());
+                i16[i] = static_cast<int16_t>(rng());
+                f32[i] = static_cast<float>(static_cast<int>(rng() % 2001) - 1000) * 0.25f;
+            }
+            bool same = true;
+            for (SimdLevel level : {SimdLevel::SSE, SimdLevel::AVX2}) {
+                auto check = [&](const auto* input, float scale, float offset) {
+                    std::vector<float> f(count), fRef(count);
+                    std::vector<int8_t> q(count), qRef(count);
+                    convertToTensor(SimdLevel::Scalar, input, count, scale, offset, fRef.data());
+                    convertToTensor(level, input, count, scale, offset, f.data());
+                    convertToTensor(SimdLevel::Scalar, input, count, scale, offset, qRef.data());
+                    convertToTensor(level, input, count, scale, offset, q.data());
+                    same = same && f == fRef && q == qRef;
+                };
+                check(u8.data(), 0.5f, -64.0f);
+                check(i16.data(), 0.01f, 3.0f);
+                check(f32.data(), 1.0f, 0.5f);
+            }
+            std::vector<int8_t> saturated(3);
+            const float extremes[3] = {1e9f, -1e9f, 126.5f};
+            convertToTensor(SimdLevel::Scalar, extremes, 3, 1.0f, 0.0f, saturated.data());
+            same = same && saturated[0] == 127 && saturated[1] == -128 && saturated[2] == 126;
+            record(same, "Tensor | conversion kernels match scalar");
+        }
+        
+        const size_t w = 37, h = 19, batch = 5;
+        std::vector<RGBImage> frames;
+        for (size_t n = 0; n < batch; ++n) frames.push_back(createRandomImage(w, h, 100 + static_cast<uint32_t>(n)));
+        const size_t plane = w * h;
+        
+        for (int kernelSize : {3, 7}) {
+            SobelConfig config;
+            config.kernel_size = kernelSize;
+            const std::string suffix = " (" + std::to_string(kernelSize) + "x" + std::to_string(kernelSize) + ")";
+            
+            TensorExportConfig exportConfig;
+            exportConfig.threads = 3;
+            TensorExporter exporter(exportConfig);
+            std::vector<float> tensor(TensorExporter::elementCount(batch, TensorContent::GradientsAndMagnitude, w, h));
+            exporter.exportBatch(frames, config, TensorContent::GradientsAndMagnitude, tensor.data());
+            
+            TensorExportConfig int8Config(1.0f, -128.0f);
+            int8Config.threads = 2;
+            std::vector<int8_t> edgeTensor(TensorExporter::elementCount(batch, TensorContent::EdgeMap, w, h));
+            TensorExporter(int8Config).exportBatch(frames, config, TensorContent::EdgeMap, edgeTensor.data());
+            
+            std::vector<GrayscaleImage> edgeMaps(batch);
+            bool gradientsMatch = true, edgesMatch = true;
+            SobelFilterSIMD filter(config);
+            for (size_t n = 0; n < batch; ++n) {
+                std::vector<int16_t> gx(plane), gy(plane);
+                std::vector<float> magnitude(plane);
+                SobelFilterSIMD::OutputDescriptor outputs;
+                outputs.gx = gx.data();
+                outputs.gy = gy.data();
+                outputs.magnitude = magnitude.data();
+                filter.apply(frames[n], outputs);
+                filter.apply(frames[n], edgeMaps[n]);
+                const float* slice = tensor.data() + n * 3 * plane;
+                for (size_t i = 0; i < plane; ++i) {
+                    gradientsMatch = gradientsMatch && slice[i] == gx[i] && slice[plane + i] == gy[i] &&
+                                     slice[2 * plane + i] == magnitude[i];
+                    edgesMatch = edgesMatch && edgeTensor[n * plane + i] == static_cast<int>(edgeMaps[n].data()[i]) - 128;
+                }
+            }
+            record(gradientsMatch, "Tensor | float NCHW gradients + magnitude" + suffix);
+            record(edgesMatch, "Tensor | int8 NCHW edge maps" + suffix);
+            
+            std::vector<float> mapTensor(TensorExporter::elementCount(batch, TensorContent::EdgeMap, w, h));
+            TensorExporter(TensorExportConfig(1.0f / 255.0f, 0.0f)).exportEdgeMaps(edgeMaps, mapTensor.data());
+            bool mapsMatch = true;
+            for (size_t n = 0; n < batch; ++n) {
+                for (size_t i = 0; i < plane; ++i) {
+                    mapsMatch = mapsMatch && mapTensor[n * plane + i] == edgeMaps[n].data()[i] * (1.0f / 255.0f);
+                }
+            }
+            record(mapsMatch, "Tensor | exported edge maps" + suffix);
+        }
+        
+        bool rejectsMixed = false;
+        try {
+            std::vector<RGBImage> mixed = {createRandomImage(8, 8), createRandomImage(9, 8)};
+            std::vector<float> tensor(2 * 9 * 8);
+            TensorExporter().exportBatch(mixed, SobelConfig(), TensorContent::EdgeMap, tensor.data());
+        } catch (const std::invalid_argument&) {
+            rejectsMixed = true;
+        }
+        record(rejectsMixed, "Tensor | mixed frame sizes rejected");
+    }
+    
+    void testBenchmarkStats() {
+        std::cout << "\n=== Benchmark Statistics Tests ===" << std::endl;
+        
+        // 1..101 shuffled: percentiles land exactly on samples
+        std::vector<double> samples;
+        for (int i = 1; i <= 101; ++i) samples.push_back(i);
+        std::shuffle(samples.begin(), samples.end(), std::mt19937(5));
+        BenchmarkStats stats = computeStats(samples);
+        bool exact = stats.iterations == 101 && stats.min == 1.0 && stats.max == 101.0 && stats.median == 51.0 &&
+                     stats.p90 == 91.0 && stats.p99 == 100.0 && stats.mean == 51.0 &&
+                     std::abs(stats.stddev - std::sqrt(101.0 * 102.0 / 12.0)) < 1e-9;
+        
+        // Interpolation between ranks and the single-sample case
+        BenchmarkStats pair = computeStats({10.0, 20.0});
+        BenchmarkStats single = computeStats({7.0});
+        bool interpolated = pair.median == 15.0 && std::abs(pair.p90 - 19.0) < 1e-9 &&
+                            single.median == 7.0 && single.p99 == 7.0 && single.stddev == 0.0;
+        
+        BenchmarkOptions options;
+        options.warmup_time = std::chrono::milliseconds(0);
+        options.iterations = 7;
+        size_t calls = 0;
+        BenchmarkStats fixed = runBenchmark([&]() { ++calls; }, options);
+        bool fixedCount = fixed.iterations == 7 && fixed.samples.size() == 7 && calls >= 10;
+        
+#if SOBEL_STAGE_TIMERS
+        // Stage timers aggregate across calls and only record the stages a call ran
+        SobelFilterSIMD filter;
+        GrayscaleImage output;
+        RGBImage image = createRandomImage(64, 48);
+        filter.apply(image, output);
+        filter.apply(image, output);
+        const auto& stages = filter.getLastMetrics().stages;
+        const StageTiming& convolution = stages[static_cast<size_t>(PipelineStage::Convolution)];
+        bool stageTimers = convolution.calls == 2 && convolution.minUs <= convolution.meanUs() &&
+                           convolution.meanUs() <= convolution.maxUs && convolution.maxUs > 0.0 &&
+                           stages[static_cast<size_t>(PipelineStage::GrayConversion)].calls == 2 &&
+                           stages[static_cast<size_t>(PipelineStage::Suppression)].calls == 0;
+        filter.resetMetrics();
+        stageTimers = stageTimers && filter.getLastMetrics().stages[static_cast<size_t>(PipelineStage::Convolution)].calls == 0;
+        results_.push_back({stageTimers, "Stage timers | aggregation across calls", stageTimers ? "OK" : "Mismatch", 0, 0});
+        std::cout << (stageTimers ? "✅ PASS" : "❌ FAIL") << " Stage timers | aggregation across calls" << std::endl;
+#endif
+        
+        // Counters either work or explain why not; an unavailable set never reports values
+        PerfCounters counters;
+        counters.start();
+        volatile uint64_t spin = 0;
+        for (int i = 0; i < 100000; ++i) spin = spin + static_cast<uint64_t>(i);
+        PerfSample sample = counters.stop();
+        bool perfConsistent = counters.available()
+            ? (!sample.has(PerfEvent::Cycles) || sample[PerfEvent::Cycles] > 0.0)
+            : (!counters.unavailableReason().empty() && !sample.has(PerfEvent::Cycles) && sample.ipc() == 0.0);
+        results_.push_back({perfConsistent, "Perf counters | available or explained", counters.available() ? "available" : counters.unavailableReason(), 0, 0});
+        std::cout << (perfConsistent ? "✅ PASS" : "❌ FAIL") << " Perf counters | "
+                  << (counters.available() ? "available" : "unavailable: " + counters.unavailableReason()) << std::endl;
+        
+        for (const auto& [passed, name] : {std::make_pair(exact, std::string("Benchmark stats | percentiles and stddev")),
+                                            std::make_pair(interpolated, std::string("Benchmark stats | interpolation")),
+                                            std::make_pair(fixedCount, std::string("Benchmark stats | fixed iteration count"))}) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        }
+    }
+    
+    void testBaselineGate() {
+        std::cout << "\n=== Baseline Regression Gate Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        
+        std::mt19937 rng(23);
+        std::normal_distribution<double> noise(0.0, 20.0);
+        std::vector<double> base, same, slower, faster;
+        for (int i = 0; i < 60; ++i) {
+            base.push_back(1000.0 + noise(rng));
+            same.push_back(1000.0 + noise(rng));
+            slower.push_back(1100.0 + noise(rng));
+            faster.push_back(900.0 + noise(rng));
+        }
+        const double pSame = mannWhitneySlowerPValue(base, same);
+        const double pSlower = mannWhitneySlowerPValue(base, slower);
+        const double pFaster = mannWhitneySlowerPValue(base, faster);
+        const double pTies = mannWhitneySlowerPValue({5.0, 5.0, 5.0}, {5.0, 5.0, 5.0});
+        record(pSame > 0.01 && pSlower < 1e-6 && pFaster > 0.99 && pTies == 1.0, "Baseline | Mann-Whitney p-values");
+        
+        // Save, merge and reload; only the statistically slower entry regresses
+        const std::string path = "validation_baseline.tsv";
+        std::remove(path.c_str());
+        auto makeRecord = [](const std::string& implementation, const std::vector<double>& samples) {
+            BenchmarkRecord r;
+            r.name = "simd";
+            r.implementation = implementation;
+            r.width = 64;
+            r.height = 48;
+            r.stats = computeStats(samples);
+            return r;
+        };
+        saveBaseline(path, "Test CPU", {makeRecord("AVX2", base)});
+        saveBaseline(path, "Test CPU", {makeRecord("SSE4.1", base), makeRecord("AVX2", base)});
+        std::vector<BaselineEntry> loaded = loadBaseline(path);
+        bool roundTrip = loaded.size() == 2 && loaded[0].cpu == "Test CPU" &&
+                         loaded[0].record.stats.iterations == base.size() &&
+                         std::abs(loaded[0].record.stats.median - computeStats(base).median) < 0.1;
+        record(roundTrip, "Baseline | save, merge and reload");
+        
+        std::vector<RegressionCheck> checks = compareToBaseline(
+            loaded, "Test CPU", {makeRecord("SSE4.1", slower), makeRecord("AVX2", same), makeRecord("Scalar", slower)},
+            0.05, 0.01);
+        bool gate = checks.size() == 3 && checks[0].regressed && !checks[1].regressed &&
+                    !checks[2].hasBaseline && !checks[2].regressed;
+        std::vector<RegressionCheck> otherCpu = compareToBaseline(loaded, "Other CPU", {makeRecord("SSE4.1", slower)}, 0.05, 0.01);
+        gate = gate && !otherCpu[0].hasBaseline;
+        record(gate, "Baseline | regression gate keyed by CPU and implementation");
+        std::remove(path.c_str());
+    }
+    
+    void testTracer() {
+        std::cout << "\n=== Tracer Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        auto count = [](const std::string& text, const std::string& needle) {
+            size_t n = 0;
+            for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+            return n;
+        };
+        
+        Tracer::disable();
+        Tracer::clear();
+        RGBImage input = createGradientImage(48, 32);
+        GrayscaleImage output;
+        SobelFilterSIMD filter(SobelFilterSIMD::OptimizationLevel::AUTO);
+        filter.apply(input, output);
+        record(Tracer::spanCount() == 0, "Tracer | nothing recorded while disabled");
+        
+        // One frame on this thread, and enough spans on a worker to span several chunks
+        Tracer::enable();
+        uint64_t frameId = 0;
+        {
+            TraceFrameScope frame;
+            frameId = Tracer::currentFrame();
+            filter.apply(input, output);
+        }
+        const size_t workerSpans = 10000;
+        std::thread worker([&] {
+            TraceFrameScope frame(777);
+            for (size_t i = 0; i < workerSpans; ++i) {
+                TraceScope span("worker");
+            }
+        });
+        worker.join();
+        Tracer::disable();
+        
+        std::ostringstream json;
+        Tracer::writeChromeTrace(json);
+        const std::string trace = json.str();
+        const size_t spans = Tracer::spanCount();
+        const std::string frameTag = "\"args\":{\"frame\":" + std::to_string(frameId) + "}";
+        bool pipeline = frameId != 0 && Tracer::currentFrame() == 0 &&
+                        count(trace, "\"name\":\"apply\"") == 1 &&
+                        count(trace, "\"name\":\"gray_conversion\"") == 1 &&
+                        count(trace, "\"name\":\"gradients\"") == 1 &&
+                        count(trace, "\"name\":\"band\"") == 3 &&   // Gray, gradient and quantize phases
+                        count(trace, frameTag) == 7;
+        record(pipeline, "Tracer | filter stages share one frame id");
+        bool threads = spans == workerSpans + 7 && count(trace, "\"ph\":\"X\"") == spans &&
+                       count(trace, "\"ph\":\"M\"") == 2 && count(trace, "\"frame\":777}") == workerSpans &&
+                       count(trace, "\"tid\":2,") == workerSpans + 1;
+        record(threads, "Tracer | per-thread buffers across chunks");
+        bool document = trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0 &&
+                        trace.find("]}") == trace.size() - 3;
+        record(document, "Tracer | Chrome Trace Event document");
+        Tracer::clear();
+        record(Tracer::spanCount() == 0, "Tracer | clear");
+        
+        // Threaded frames reuse the pool's buffers; threads that exit hand their spans over and
+        // free their buffers, so buffers stay bounded by the live threads
+        Tracer::enable();
+        const size_t baseline = Tracer::bufferCount();
+        const size_t frames = 200, shortLived = 64;
+        size_t pooled = 0;
+        {
+            SobelFilterSIMD banded(SobelFilterSIMD::OptimizationLevel::SCALAR);
+            banded.setTuning({SimdLevel::Scalar, 4, 4});
+            for (size_t i = 0; i < frames; ++i) banded.apply(input, output);
+            pooled = Tracer::bufferCount();
+        }
+        const size_t afterPool = Tracer::bufferCount();
+        for (size_t i = 0; i < shortLived; ++i) {
+            std::thread([] { TraceScope span("short_lived"); }).join();
+        }
+        Tracer::disable();
+        std::ostringstream bounded;
+        Tracer::writeChromeTrace(bounded);
+        const std::string boundedTrace = bounded.str();
+        const size_t live = Tracer::bufferCount();
+        bool reclaimed = pooled <= baseline + 4 && afterPool == live && live <= 1 &&
+                         count(boundedTrace, "\"name\":\"apply\"") == frames &&
+                         count(boundedTrace, "\"name\":\"short_lived\"") == shortLived &&
+                         count(boundedTrace, "\"ph\":\"M\"") <= 4 + shortLived;
+        record(reclaimed, "Tracer | buffers bounded by live threads");
+        Tracer::clear();
+    }
+    
+    void testLatencyHistogram() {
+        std::cout << "\n=== Latency Histogram Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        auto near = [](double value, double expected) { return std::abs(value - expected) <= expected / 128.0 + 1.0; };
+        
+        // 1..10000 us in shuffled order: percentiles within one sub-bucket, extremes exact
+        std::vector<uint64_t> values;
+        for (uint64_t us = 1; us <= 10000; ++us) values.push_back(us * 1000);
+        std::shuffle(values.begin(), values.end(), std::mt19937(5));
+        LatencyHistogram histogram(std::chrono::milliseconds(9));
+        for (uint64_t v : values) histogram.record(v);
+        bool percentiles = histogram.count() == 10000 && histogram.min() == 1000 && histogram.max() == 10000000 &&
+                           near(static_cast<double>(histogram.percentile(50.0)), 5000000.0) &&
+                           near(static_cast<double>(histogram.percentile(99.0)), 9900000.0) &&
+                           near(static_cast<double>(histogram.percentile(99.9)), 9990000.0) &&
+                           histogram.percentile(100.0) == 10000000 && histogram.percentile(0.0) == 1000 &&
+                           std::abs(histogram.mean() - 5000500.0) < 1e-3;
+        record(percentiles, "Latency | percentiles within 1/128 relative error");
+        record(histogram.deadlineMisses() == 1000, "Latency | deadline misses");
+        
+        LatencyHistogram alternating;
+        for (int i = 0; i < 100; ++i) alternating.record(i % 2 ? 3000u : 1000u);
+        alternating.record(std::chrono::nanoseconds(40000000));
+        LatencySummary summary = alternating.summary();
+        bool jitter = std::abs(alternating.jitter() - (99 * 2000.0 + 39997000.0) / 100.0) < 1e-6 &&
+                      summary.frames == 101 && summary.deadlineMisses == 1 && summary.maxUs == 40000.0 &&
+                      near(summary.p50Us * 1e3, 3000.0) && std::abs(summary.deadlineUs - 16670.0) < 1e-9;
+        alternating.reset();
+        jitter = jitter && alternating.count() == 0 && alternating.percentile(99.0) == 0 && alternating.jitter() == 0.0;
+        record(jitter, "Latency | jitter, summary and reset");
+        
+        // Every call of the filter lands in its histogram; a zero deadline makes each one a miss
+        SobelFilterSIMD filter(SobelFilterSIMD::OptimizationLevel::AUTO);
+        filter.setFrameDeadline(std::chrono::nanoseconds(0));
+        RGBImage input = createGradientImage(40, 24);
+        GrayscaleImage output;
+        filter.apply(input, output);
+        filter.applyCanny(input, output);
+        filter.computeOrientation(input, output);
+        filter.apply(RGBImage(), output);
+        LatencySummary filterLatency = filter.getLatencySummary();
+        bool recorded = filterLatency.frames == 3 && filterLatency.deadlineMisses == 3 && filterLatency.p50Us > 0.0 &&
+                        filterLatency.maxUs >= filterLatency.p99Us;
+        filter.resetMetrics();
+        recorded = recorded && filter.getLatencyHistogram().count() == 0;
+        record(recorded, "Latency | filter records every call");
+    }
+    
+    void testAllocationAccounting() {
+        std::cout << "\n=== Allocation Accounting Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        if (!allocationTrackingEnabled()) {
+            AllocationRecorder recorder;
+            recorder.begin();
+            std::vector<uint8_t> bytes(100);
+            recorder.end();
+            record(recorder.total().count == 0, "Allocations | compiled out records nothing");
+            return;
+        }
+        auto stageOf = [](const AllocationStages& stages, PipelineStage stage) {
+            return stages[static_cast<size_t>(stage)];
+        };
+        
+        // Live bytes are net of frees: the peak is the largest set held at once
+        std::vector<std::vector<double>> keep;
+        keep.reserve(2);
+        AllocationRecorder recorder;
+        recorder.begin();
+        {
+            SOBEL_ALLOC_STAGE(PipelineStage::Magnitude);
+            std::vector<double> temporary(1000, 1.0);
+            keep.emplace_back(temporary.begin(), temporary.end());
+        }
+        keep.emplace_back(100, 2.0);
+        recorder.end();
+        keep.emplace_back(10, 3.0);   // After end(): not recorded
+        const AllocationStats magnitude = stageOf(recorder.stages(), PipelineStage::Magnitude);
+        bool counted = magnitude.count == 2 && magnitude.bytes == 16000 && magnitude.peakLiveBytes == 16000 &&
+                       recorder.total().count == 3 && recorder.total().bytes == 16800 &&
+                       recorder.total().peakLiveBytes == 16000 && keep.size() == 3;
+        record(counted, "Allocations | counts, bytes and peak live per stage");
+        
+        // The SIMD filter allocates its scratch once; later calls are allocation-free
+        const size_t w = 64, h = 48;
+        RGBImage input = createRandomImage(w, h);
+        GrayscaleImage output;
+        SobelFilterSIMD filter(SobelFilterSIMD::OptimizationLevel::AUTO);
+        filter.apply(input, output);
+        const AllocationStats firstCall = filter.getLastMetrics().allocationTotal;
+        filter.apply(input, output);
+        const auto& metrics = filter.getLastMetrics();
+        bool steady = firstCall.count > 0 && metrics.allocationTotal.count == firstCall.count &&
+                      stageOf(metrics.allocations, PipelineStage::Setup).count == firstCall.count &&
+                      stageOf(metrics.allocations, PipelineStage::Setup).peakLiveBytes >= w * h * (1 + sizeof(float)) &&
+                      stageOf(metrics.allocations, PipelineStage::GrayConversion).count == 0;
+        record(steady, "Allocations | SIMD filter steady state allocates nothing");
+        
+        // The baseline holds gray, Gx, Gy, double magnitudes, bytes and the result at once
+        SobelFilter baseline;
+        recorder.begin();
+        GrayscaleImage baselineOutput = baseline.apply(input);
+        recorder.end();
+        const size_t pixels = w * h;
+        const AllocationStages& stages = recorder.stages();
+        bool attributed = stageOf(stages, PipelineStage::GrayConversion).bytes >= pixels &&
+                          stageOf(stages, PipelineStage::Convolution).bytes >= 2 * pixels * sizeof(int32_t) &&
+                          stageOf(stages, PipelineStage::Magnitude).bytes == pixels * sizeof(double) &&
+                          stageOf(stages, PipelineStage::Quantization).bytes == pixels &&
+                          stageOf(stages, PipelineStage::Output).bytes == pixels &&
+                          recorder.total().peakLiveBytes >= pixels * (1 + 2 * sizeof(int32_t) + sizeof(double) + 2) &&
+                          baselineOutput.size() == pixels;
+        record(attributed, "Allocations | baseline stages attributed");
+        
+        // Filters (and their recorders) move: return by value and std::vector storage work
+        static_assert(std::is_move_constructible_v<AllocationRecorder> && std::is_move_assignable_v<AllocationRecorder>);
+        static_assert(std::is_move_constructible_v<SobelFilterSIMD> && std::is_move_assignable_v<SobelFilterSIMD>);
+        std::vector<SobelFilterSIMD> filters;
+        filters.push_back(std::move(filter));
+        SobelFilterSIMD threaded(SobelFilterSIMD::OptimizationLevel::SCALAR);
+        threaded.setTuning({SimdLevel::Scalar, 8, 3});
+        filters.push_back(std::move(threaded));
+        filters.emplace_back();
+        GrayscaleImage moved, movedThreaded, reference;
+        filters[0].apply(input, moved);
+        filters[1].apply(input, movedThreaded);
+        filters[2].apply(input, reference);
+        bool movable = moved.size() == reference.size() &&
+                       std::equal(moved.data(), moved.data() + moved.size(), reference.data()) &&
+                       std::equal(movedThreaded.data(), movedThreaded.data() + movedThreaded.size(), reference.data()) &&
+                       filters[0].getLastMetrics().allocationTotal.count == firstCall.count;
+        record(movable, "Allocations | filters and recorders are movable");
+        
+        // Pool helpers record into the forking thread's recorder and stage: each item waits until
+        // all three workers hold one, so both helpers allocate
+        ThreadPool pool(3);
+        std::atomic<int> arrived{0};
+        std::vector<std::unique_ptr<std::vector<uint8_t>>> blocks(3);
+        recorder.begin();
+        {
+            SOBEL_ALLOC_STAGE(PipelineStage::Convolution);
+            const AllocationContext context = currentAllocationContext();
+            pool.parallelFor(3, [&](unsigned, size_t i) {
+                SOBEL_ALLOC_CONTEXT(context);
+                ++arrived;
+                while (arrived < 3) std::this_thread::yield();
+                blocks[i] = std::make_unique<std::vector<uint8_t>>(1000);
+            });
+        }
+        recorder.end();
+        const AllocationStats& gradients = stageOf(recorder.stages(), PipelineStage::Convolution);
+        record(gradients.count == 6 && gradients.bytes == 3 * (1000 + sizeof(std::vector<uint8_t>)) &&
+                   recorder.total().count == 6,
+               "Allocations | pool helpers count towards the caller");
+    }
+    
+    void testAutotuner() {
+        std::cout << "\n=== Autotuner and Banded Execution Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        
+        // Any band height and thread count gives the single-threaded planes bit for bit
+        const size_t w = 53, h = 37;
+        RGBImage input = createRandomImage(w, h, 17);
+        struct Planes {
+            std::vector<int16_t> gx, gy;
+            std::vector<float> magnitude;
+            std::vector<uint8_t> edges;
+        };
+        auto run = [&](const TuningParameters& tuning) {
+            Planes planes{std::vector<int16_t>(w * h), std::vector<int16_t>(w * h), std::vector<float>(w * h),
+                          std::vector<uint8_t>(w * h)};
+            SobelFilterSIMD filter(SobelFilterSIMD::OptimizationLevel::SCALAR);
+            filter.setTuning(tuning);
+            SobelFilterSIMD::OutputDescriptor outputs;
+            outputs.gx = planes.gx.data();
+            outputs.gy = planes.gy.data();
+            outputs.magnitude = planes.magnitude.data();
+            outputs.edges = planes.edges.data();
+            filter.apply(input, outputs);
+            return planes;
+        };
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            const Planes reference = run({level, 0, 1});
+            bool identical = true;
+            for (size_t band : {size_t(1), size_t(7), size_t(64), size_t(0)}) {
+                for (unsigned threads : {1u, 3u, 0u}) {
+                    const Planes banded = run({level, band, threads});
+                    identical = identical && banded.gx == reference.gx && banded.gy == reference.gy &&
+                                banded.magnitude == reference.magnitude && banded.edges == reference.edges;
+                }
+            }
+            record(identical, std::string("Autotune | banded threads match single-threaded | ") + simdLevelName(level));
+        }
+        
+        // The pool runs every loop on the same helper threads, with stable worker indices, and
+        // passes exceptions to the caller
+        {
+            ThreadPool pool(3);
+            std::mutex mutex;
+            std::vector<std::thread::id> ids(3);
+            std::vector<int> hits(100, 0);
+            bool stable = pool.size() == 3;
+            for (int loop = 0; loop < 50; ++loop) {
+                pool.parallelFor(hits.size(), [&](unsigned worker, size_t i) {
+                    ++hits[i];
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (worker >= ids.size()) {
+                        stable = false;
+                        return;
+                    }
+                    if (ids[worker] == std::thread::id()) ids[worker] = std::this_thread::get_id();
+                    stable = stable && ids[worker] == std::this_thread::get_id();
+                });
+            }
+            stable = stable && ids[0] == std::this_thread::get_id() &&
+                     std::all_of(hits.begin(), hits.end(), [](int n) { return n == 50; });
+            bool rethrown = false;
+            try {
+                pool.parallelFor(10, [](unsigned, size_t i) {
+                    if (i == 7) throw std::runtime_error("band failed");
+                });
+            } catch (const std::runtime_error&) {
+                rethrown = true;
+            }
+            size_t items = 0;
+            pool.parallelFor(1, [&](unsigned worker, size_t) { items += worker == 0; });
+            pool.resize(2);
+            pool.parallelFor(20, [&](unsigned worker, size_t) {
+                std::lock_guard<std::mutex> lock(mutex);
+                items += worker < 2;
+            });
+            record(stable && rethrown && items == 21 && pool.size() == 2,
+                   "Autotune | persistent pool reuses its workers");
+        }
+        
+        // Wisdom round trip: entries keyed by CPU and resolution, replaced on save
+        const std::string path = "validation_wisdom.tsv";
+        std::remove(path.c_str());
+        WisdomEntry entry;
+        entry.cpu = cpuModelName();
+        entry.width = w;
+        entry.height = h;
+        entry.parameters = {SimdLevel::Scalar, 8, 4};
+        entry.medianNs = 1234.5;
+        saveWisdom(path, entry);
+        WisdomEntry other = entry;
+        other.width = 64;
+        other.parameters = {SimdLevel::Scalar, 0, 1};
+        saveWisdom(path, other);
+        entry.parameters.threads = 2;
+        saveWisdom(path, entry);
+        std::vector<WisdomEntry> wisdom = loadWisdom(path);
+        auto found = findWisdom(wisdom, entry.cpu, w, h);
+        bool roundTrip = wisdom.size() == 2 && found && found->band_height == 8 && found->threads == 2 &&
+                         found->level == SimdLevel::Scalar && !findWisdom(wisdom, "Other CPU", w, h) &&
+                         std::abs(wisdom[0].medianNs - 1234.5) < 1e-9;
+        record(roundTrip, "Autotune | wisdom save, merge and reload");
+        
+        // AUTO filters pick up the wisdom for their resolution and fall back elsewhere
+        bool autoLoaded = reloadWisdom(path) == 2;
+        SobelFilterSIMD autoFilter(SobelFilterSIMD::OptimizationLevel::AUTO);
+        const TuningParameters featureTuning = autoFilter.getTuning();
+        GrayscaleImage output;
+        autoFilter.apply(input, output);
+        TuningParameters tuned = autoFilter.getTuning();
+        autoLoaded = autoLoaded && tuned.level == SimdLevel::Scalar && tuned.band_height == 8 && tuned.threads == 2;
+        autoFilter.apply(createRandomImage(w + 1, h), output);
+        tuned = autoFilter.getTuning();
+        autoLoaded = autoLoaded && tuned.level == featureTuning.level && tuned.band_height == 0 && tuned.threads == 1;
+        record(autoLoaded, "Autotune | AUTO loads wisdom per resolution");
+        
+        std::ofstream(path) << "broken line\n";
+        bool malformed = false;
+        try {
+            loadWisdom(path);
+        } catch (const std::runtime_error&) {
+            malformed = true;
+        }
+        malformed = malformed && reloadWisdom(path) == 0;
+        record(malformed, "Autotune | malformed wisdom rejected");
+        std::remove(path.c_str());
+        
+        AutotuneOptions options;
+        options.levels = {SimdLevel::Scalar};
+        options.thread_counts = {1, 2};
+        options.band_heights = {8, 0};
+        options.bench.warmup_time = std::chrono::milliseconds(0);
+        options.bench.iterations = 3;
+        AutotuneResult result = autotune(32, 16, SobelConfig(), options);
+        bool tuned3 = result.candidates.size() == 3 && result.bestMedianNs > 0.0;
+        for (const auto& candidate : result.candidates) {
+            tuned3 = tuned3 && candidate.stats.iterations == 3 && candidate.stats.median >= result.bestMedianNs;
+        }
+        record(tuned3, "Autotune | candidates timed and fastest chosen");
+    }
+    
+    void testAdaptiveQuality() {
+        std::cout << "\n=== Adaptive Quality Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        using std::chrono::nanoseconds;
+        
+        // Controller: a miss steps down at once, a slow mean after a full window, headroom steps up
+        AdaptiveQualityConfig adaptive;
+        adaptive.enabled = true;
+        adaptive.budget = nanoseconds(1000);
+        adaptive.window = 4;
+        QualityController controller(adaptive);
+        bool steps = controller.update(nanoseconds(1500)) == QualityTier::L1Magnitude;
+        for (int i = 0; i < 3; ++i) steps = steps && controller.update(nanoseconds(950)) == QualityTier::L1Magnitude;
+        steps = steps && controller.update(nanoseconds(950)) == QualityTier::Kernel3x3;
+        for (int i = 0; i < 3; ++i) steps = steps && controller.update(nanoseconds(100)) == QualityTier::Kernel3x3;
+        steps = steps && controller.update(nanoseconds(100)) == QualityTier::L1Magnitude;
+        record(steps, "Adaptive | controller steps down on misses and up with headroom");
+        
+        // Undoing a step up doubles the hold before the next one
+        bool backoff = controller.update(nanoseconds(2000)) == QualityTier::Kernel3x3;
+        for (int i = 0; i < 7; ++i) backoff = backoff && controller.update(nanoseconds(100)) == QualityTier::Kernel3x3;
+        backoff = backoff && controller.update(nanoseconds(100)) == QualityTier::L1Magnitude;
+        record(backoff, "Adaptive | failed step up backs off");
+        
+        adaptive.lowest_tier = QualityTier::Kernel3x3;
+        controller = QualityController(adaptive);
+        for (int i = 0; i < 5; ++i) controller.update(nanoseconds(5000));
+        record(controller.tier() == QualityTier::Kernel3x3, "Adaptive | lowest tier respected");
+        
+        bool rejected = true;
+        for (int which = 0; which < 3; ++which) {
+            AdaptiveQualityConfig bad = adaptive;
+            if (which == 0) bad.budget = nanoseconds(0);
+            if (which == 1) bad.window = 0;
+            if (which == 2) bad.upshift_ratio = bad.downshift_ratio;
+            try {
+                QualityController invalid(bad);
+                rejected = false;
+            } catch (const std::invalid_argument&) {
+            }
+        }
+        record(rejected, "Adaptive | invalid configuration rejected");
+        
+        // Filter: an impossible budget walks down one tier per frame, reported in the metrics
+        const size_t w = 101, h = 37;
+        const RGBImage input = createRandomImage(w, h, 23);
+        SobelConfig config;
+        config.kernel_size = 5;
+        adaptive = AdaptiveQualityConfig();
+        adaptive.enabled = true;
+        adaptive.budget = nanoseconds(1);
+        std::vector<std::vector<GrayscaleImage>> tiers;
+        bool reported = true;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+            filter.setTuning({level, 0, 1});
+            filter.setAdaptiveQuality(adaptive);
+            tiers.emplace_back();
+            for (size_t t = 0; t < kQualityTierCount; ++t) {
+                GrayscaleImage output;
+                filter.apply(input, output);
+                reported = reported && filter.getLastMetrics().qualityTier == static_cast<QualityTier>(t) &&
+                           output.width() == w && output.height() == h;
+                tiers.back().push_back(output);
+            }
+            for (uint64_t frames : filter.getLastMetrics().tierFrames) reported = reported && frames == 1;
+        }
+        record(reported, "Adaptive | tiers stepped and reported per frame");
+        
+        bool sameAcrossLevels = true;
+        for (const auto& levelTiers : tiers) {
+            for (size_t t = 0; t < kQualityTierCount; ++t) {
+                sameAcrossLevels = sameAcrossLevels && levelTiers[t].data() != nullptr &&
+                                   std::equal(levelTiers[t].data(), levelTiers[t].data() + w * h, tiers[0][t].data());
+            }
+        }
+        record(sameAcrossLevels, "Adaptive | every tier identical across SIMD levels");
+        
+        // Half resolution replicates each processed pixel into a 2x2 block and still finds edges
+        const GrayscaleImage& half = tiers[0][static_cast<size_t>(QualityTier::HalfResolution)];
+        bool blocks = true;
+        size_t edgePixels = 0;
+        for (size_t y = 0; y < h; ++y) {
+            for (size_t x = 0; x < w; ++x) {
+                blocks = blocks && half.at(x, y) == half.at(x & ~size_t(1), y & ~size_t(1));
+                edgePixels += half.at(x, y) > 0;
+            }
+        }
+        record(blocks && edgePixels > 0, "Adaptive | half resolution upsampled 2x");
+        
+        // A generous budget never degrades; plane requests always run at full quality
+        SobelFilterSIMD reference(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+        GrayscaleImage expected, actual;
+        reference.apply(input, expected);
+        adaptive.budget = std::chrono::hours(1);
+        SobelFilterSIMD relaxed(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+        relaxed.setAdaptiveQuality(adaptive);
+        bool fullQuality = true;
+        for (int i = 0; i < 3; ++i) {
+            relaxed.apply(input, actual);
+            fullQuality = fullQuality && relaxed.getLastMetrics().qualityTier == QualityTier::Full &&
+                          std::equal(actual.data(), actual.data() + w * h, expected.data());
+        }
+        adaptive.budget = nanoseconds(1);
+        SobelFilterSIMD planes(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+        planes.setAdaptiveQuality(adaptive);
+        std::vector<float> magnitude(w * h);
+        SobelFilterSIMD::OutputDescriptor outputs;
+        outputs.magnitude = magnitude.data();
+        for (int i = 0; i < 3; ++i) {
+            planes.apply(input, outputs);
+            fullQuality = fullQuality && planes.getLastMetrics().qualityTier == QualityTier::Full;
+        }
+        record(fullQuality && planes.getQualityTier() == QualityTier::Full,
+               "Adaptive | headroom and plane requests keep full quality");
+    }
+    
+    void testImageFormats() {
+        std::cout << "\n=== Image Format I/O Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        auto sameRGB = [](const RGBImage& a, const RGBImage& b) {
+            if (a.width() != b.width() || a.height() != b.height()) return false;
+            for (size_t i = 0; i < a.size(); ++i) {
+                const RGBPixel& p = a.data()[i];
+                const RGBPixel& q = b.data()[i];
+                if (p.r != q.r || p.g != q.g || p.b != q.b) return false;
+            }
+            return true;
+        };
+        auto sameGray = [](const GrayscaleImage& a, const GrayscaleImage& b) {
+            return a.width() == b.width() && a.height() == b.height() &&
+                   std::equal(a.data(), a.data() + a.size(), b.data());
+        };
+        
+        // Odd width: BMP rows carry padding (13 * 3 = 39 -> 40 bytes, 13 -> 16 bytes)
+        const RGBImage rgb = createRandomImage(13, 7, 41);
+        GrayscaleImage gray(13, 7);
+        for (size_t i = 0; i < gray.size(); ++i) gray.data()[i] = rgb.data()[i].toGrayscale();
+        
+        bool rgbRoundTrip = true;
+        for (const char* path : {"validation_io.ppm", "validation_io.bmp", "validation_io.rgb"}) {
+            const ImageFormat format = ImageIO::formatFromExtension(path);
+            auto saved = ImageIO::saveRGBImage(rgb, path, format);
+            auto loaded = format == ImageFormat::Raw ? ImageIO::loadRGBImage(path, 13, 7) : ImageIO::loadRGBImage(path);
+            rgbRoundTrip = rgbRoundTrip && saved && loaded && sameRGB(loaded.getValue(), rgb) &&
+                           ImageIO::detectFormat(path) == format;
+            std::remove(path);
+        }
+        record(rgbRoundTrip, "ImageIO | RGB round trip through PPM, 24-bit BMP and raw");
+        
+        bool grayRoundTrip = true;
+        for (const char* path : {"validation_io.pgm", "validation_io.bmp", "validation_io.gray"}) {
+            const ImageFormat format = ImageIO::formatFromExtension(path);
+            auto saved = ImageIO::saveGrayscaleImage(gray, path, format);
+            auto loaded = format == ImageFormat::Raw ? ImageIO::loadGrayscaleImage(path, 13, 7)
+                                                     : ImageIO::loadGrayscaleImage(path);
+            grayRoundTrip = grayRoundTrip && saved && loaded && sameGray(loaded.getValue(), gray);
+            std::remove(path);
+        }
+        record(grayRoundTrip, "ImageIO | gray round trip through PGM, 8-bit BMP and raw");
+        
+        // Color files load as gray with RGBPixel::toGrayscale; gray files load as replicated RGB
+        ImageIO::saveRGBImage(rgb, "validation_io.ppm", ImageFormat::PPM);
+        ImageIO::saveGrayscaleImage(gray, "validation_io.pgm", ImageFormat::PGM);
+        ImageIO::saveRGBImage(rgb, "validation_io.bmp", ImageFormat::BMP);
+        auto colorAsGray = ImageIO::loadGrayscaleImage("validation_io.ppm");
+        auto bmpAsGray = ImageIO::loadGrayscaleImage("validation_io.bmp");
+        auto grayAsColor = ImageIO::loadRGBImage("validation_io.pgm");
+        bool converted = colorAsGray && sameGray(colorAsGray.getValue(), gray) && bmpAsGray &&
+                         sameGray(bmpAsGray.getValue(), gray) && grayAsColor;
+        for (size_t i = 0; converted && i < gray.size(); ++i) {
+            const RGBPixel& p = grayAsColor.getValue().data()[i];
+            converted = p.r == gray.data()[i] && p.g == gray.data()[i] && p.b == gray.data()[i];
+        }
+        record(converted, "ImageIO | cross-format gray/RGB loading");
+        
+        // Header comments and a top-down BMP (negative height, rows stored first to last)
+        {
+            std::ofstream ppm("validation_io.ppm", std::ios::binary);
+            ppm << "P6\n# comment line\n13 # width\n7\n255\n";
+            ppm.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size() * 3));
+        }
+        auto commented = ImageIO::loadRGBImage("validation_io.ppm");
+        
+        ImageIO::saveRGBImage(rgb, "validation_io.bmp", ImageFormat::BMP);
+        std::ifstream bottomUpFile("validation_io.bmp", std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(bottomUpFile)), std::istreambuf_iterator<char>());
+        bottomUpFile.close();
+        const size_t rowBytes = 40, offset = 54;
+        std::vector<char> topDown(bytes);
+        for (size_t y = 0; y < 7; ++y) {
+            std::copy_n(bytes.begin() + static_cast<std::ptrdiff_t>(offset + (6 - y) * rowBytes), rowBytes,
+                        topDown.begin() + static_cast<std::ptrdiff_t>(offset + y * rowBytes));
+        }
+        const int32_t negativeHeight = -7;
+        for (int i = 0; i < 4; ++i) {
+            topDown[22 + i] = static_cast<char>((static_cast<uint32_t>(negativeHeight) >> (8 * i)) & 0xFF);
+        }
+        std::ofstream("validation_io_td.bmp", std::ios::binary)
+            .write(topDown.data(), static_cast<std::streamsize>(topDown.size()));
+        auto topDownLoaded = ImageIO::loadRGBImage("validation_io_td.bmp");
+        record(commented && sameRGB(commented.getValue(), rgb) && topDownLoaded &&
+               sameRGB(topDownLoaded.getValue(), rgb) && bytes.size() == offset + 7 * rowBytes,
+               "ImageIO | PNM comments and top-down BMP rows");
+        
+        // Truncated data, bad headers and unsupported depths are reported, not read
+        std::ofstream("validation_io_td.bmp", std::ios::binary)
+            .write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 5));
+        std::ofstream("validation_io.pgm", std::ios::binary) << "P5\n13 7\n65535\n";
+        std::ofstream("validation_io.ppm", std::ios::binary) << "P6\nwide 7\n255\n";
+        auto truncated = ImageIO::loadRGBImage("validation_io_td.bmp");
+        auto deep = ImageIO::loadGrayscaleImage("validation_io.pgm");
+        auto malformed = ImageIO::loadRGBImage("validation_io.ppm");
+        auto missing = ImageIO::loadRGBImage("validation_io_missing.ppm");
+        record(!truncated && truncated.getError() == ImageIOError::InvalidFileSize &&
+               !deep && deep.getError() == ImageIOError::UnsupportedFormat &&
+               !malformed && malformed.getError() == ImageIOError::InvalidHeader &&
+               !missing && missing.getError() == ImageIOError::FileNotFound,
+               "ImageIO | malformed files rejected");
+        for (const char* path : {"validation_io.ppm", "validation_io.pgm", "validation_io.bmp", "validation_io_td.bmp"}) {
+            std::remove(path);
+        }
+    }
+    
+    void testGrayFrameInput() {
+        std::cout << "\n=== Fused Gray Loading Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        
+        // Every 24-bit color converts exactly like RGBPixel::toGrayscale at every level
+        std::vector<uint8_t> rgbRow(256 * 256 * 3), grayRow(256 * 256);
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            size_t mismatches = 0;
+            for (int r = 0; r < 256; ++r) {
+                for (size_t i = 0; i < 256 * 256; ++i) {
+                    rgbRow[3 * i] = static_cast<uint8_t>(r);
+                    rgbRow[3 * i + 1] = static_cast<uint8_t>(i >> 8);
+                    rgbRow[3 * i + 2] = static_cast<uint8_t>(i);
+                }
+                const size_t count = 256 * 256 - static_cast<size_t>(r % 7);   // Vary the tail
+                rgbToGrayRow(level, rgbRow.data(), count, grayRow.data());
+                for (size_t i = 0; i < count; ++i) {
+                    const RGBPixel p(rgbRow[3 * i], rgbRow[3 * i + 1], rgbRow[3 * i + 2]);
+                    mismatches += grayRow[i] != p.toGrayscale();
+                }
+            }
+            record(mismatches == 0, std::string("Gray | all 2^24 colors match toGrayscale | ") + simdLevelName(level));
+        }
+        
+        // Streaming loaders fill the padded plane exactly like the image loaders
+        const size_t w = 37, h = 29;
+        const RGBImage rgb = createRandomImage(w, h, 5);
+        GrayscaleImage gray(w, h);
+        for (size_t i = 0; i < gray.size(); ++i) gray.data()[i] = rgb.data()[i].toGrayscale();
+        auto frameEquals = [&](const GrayFrame& frame, const GrayscaleImage& image) {
+            if (frame.width() != image.width() || frame.height() != image.height()) return false;
+            for (size_t y = 0; y < frame.height(); ++y) {
+                const uint8_t* expected = image.data() + y * image.width();
+                if (!std::equal(frame.row(y), frame.row(y) + frame.width(), expected)) return false;
+            }
+            return true;
+        };
+        GrayFrame frame;
+        bool streamed = true;
+        ImageIO::saveRGBImage(rgb, "validation_frame.ppm", ImageFormat::PPM);
+        ImageIO::saveRGBImage(rgb, "validation_frame.bmp", ImageFormat::BMP);
+        ImageIO::saveRGBImage(rgb, "validation_frame.raw", ImageFormat::Raw);
+        ImageIO::saveGrayscaleImage(gray, "validation_frame.pgm", ImageFormat::PGM);
+        ImageIO::saveGrayscaleImage(gray, "validation_frame_8.bmp", ImageFormat::BMP);
+        for (const char* path : {"validation_frame.ppm", "validation_frame.bmp", "validation_frame.pgm",
+                                 "validation_frame_8.bmp"}) {
+            streamed = streamed && ImageIO::loadGrayFrame(path, frame) && frameEquals(frame, gray);
+        }
+        const uint8_t* reused = frame.origin();
+        streamed = streamed && ImageIO::loadGrayFrame("validation_frame.raw", w, h, frame) &&
+                   frameEquals(frame, gray) && frame.origin() == reused &&
+                   reinterpret_cast<uintptr_t>(frame.row(0) - GrayFrame::kHalo) % 32 == 0 && frame.stride() % 32 == 0;
+        auto wrongSize = ImageIO::loadGrayFrame("validation_frame.raw", w + 1, h, frame);
+        streamed = streamed && !wrongSize && wrongSize.getError() == ImageIOError::InvalidFileSize;
+        for (const char* path : {"validation_frame.ppm", "validation_frame.bmp", "validation_frame.raw",
+                                 "validation_frame.pgm", "validation_frame_8.bmp"}) {
+            std::remove(path);
+        }
+        record(streamed, "Gray | streamed PPM/PGM/BMP/raw match, frame reused");
+        
+        // apply(GrayFrame) gives the RGB path's planes at every level, kernel and border mode
+        bool matches = true;
+        frame.resize(w, h);
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (int kernel : {3, 5, 7}) {
+                for (BorderMode border : {BorderMode::Replicate, BorderMode::Zero}) {
+                    SobelConfig config;
+                    config.kernel_size = kernel;
+                    config.border_mode = border;
+                    SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+                    filter.setTuning({level, 0, 1});
+                    std::vector<float> fromRGB(w * h), fromFrame(w * h);
+                    GrayscaleImage edgesRGB, edgesFrame;
+                    SobelFilterSIMD::OutputDescriptor outputs;
+                    outputs.magnitude = fromRGB.data();
+                    filter.apply(rgb, outputs);
+                    filter.apply(rgb, edgesRGB);
+                    for (size_t y = 0; y < h; ++y) std::copy_n(gray.data() + y * w, w, frame.row(y));
+                    outputs.magnitude = fromFrame.data();
+                    matches = matches && filter.apply(frame, outputs) && filter.apply(frame, edgesFrame) &&
+                              fromRGB == fromFrame &&
+                              std::equal(edgesRGB.data(), edgesRGB.data() + w * h, edgesFrame.data());
+                }
+            }
+        }
+        GrayFrame emptyFrame;
+        GrayscaleImage emptyOutput;
+        SobelFilterSIMD plain;
+        matches = matches && !plain.apply(emptyFrame, emptyOutput) && emptyOutput.empty();
+        record(matches, "Gray | apply(GrayFrame) matches RGB input");
+        
+        // Adaptive tiers also run from a frame, including half resolution
+        AdaptiveQualityConfig adaptive;
+        adaptive.enabled = true;
+        adaptive.budget = std::chrono::nanoseconds(1);
+        SobelFilterSIMD adaptiveFilter;
+        adaptiveFilter.setAdaptiveQuality(adaptive);
+        bool tiers = true;
+        for (size_t t = 0; t < kQualityTierCount; ++t) {
+            GrayscaleImage output;
+            tiers = tiers && adaptiveFilter.apply(frame, output) && output.width() == w && output.height() == h &&
+                    adaptiveFilter.getLastMetrics().qualityTier == static_cast<QualityTier>(t);
+        }
+        record(tiers, "Gray | adaptive tiers from a frame");
+    }
+    
+    void testGrayscaleInput() {
+        std::cout << "\n=== Grayscale Input Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        
+        const size_t w = 45, h = 23;
+        const RGBImage rgb = createRandomImage(w, h, 11);
+        GrayscaleImage gray(w, h);
+        for (size_t i = 0; i < gray.size(); ++i) gray.data()[i] = rgb.data()[i].toGrayscale();
+        
+        // Drop-in for SobelFilter::apply(const GrayscaleImage&) at every level and kernel,
+        // and identical to the RGB path for the same luma
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (int kernel : {3, 5, 7}) {
+                SobelConfig config;
+                config.kernel_size = kernel;
+                SobelFilter baseline(config);
+                SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+                filter.setTuning({level, 0, 1});
+                GrayscaleImage fromGray, fromRGB;
+                const bool applied = filter.apply(gray, fromGray) && filter.apply(rgb, fromRGB);
+                const std::string name = std::string("Gray input | ") + std::to_string(kernel) + "x" +
+                                         std::to_string(kernel) + " | " + simdLevelName(level);
+                TestResult result = compareImages(baseline.apply(gray), fromGray, name + " | baseline", 1.0);
+                results_.push_back(result);
+                std::cout << (result.passed ? "✅ PASS" : "❌ FAIL") << " " << result.testName << std::endl;
+                record(applied && std::equal(fromRGB.data(), fromRGB.data() + w * h, fromGray.data()),
+                       name + " | RGB path");
+            }
+        }
+        
+        // Multi-output planes match the RGB path; empty input is rejected
+        SobelFilterSIMD filter;
+        std::vector<int16_t> gxRGB(w * h), gxGray(w * h);
+        std::vector<float> magRGB(w * h), magGray(w * h);
+        SobelFilterSIMD::OutputDescriptor outputs;
+        outputs.gx = gxRGB.data();
+        outputs.magnitude = magRGB.data();
+        bool planes = filter.apply(rgb, outputs);
+        outputs.gx = gxGray.data();
+        outputs.magnitude = magGray.data();
+        planes = planes && filter.apply(gray, outputs) && gxRGB == gxGray && magRGB == magGray;
+        GrayscaleImage emptyOutput(3, 3);
+        planes = planes && !filter.apply(GrayscaleImage(), emptyOutput) && emptyOutput.empty();
+        record(planes, "Gray input | planes match RGB path, empty rejected");
+        
+        // Adaptive tiers, including half resolution from the packed image
+        AdaptiveQualityConfig adaptive;
+        adaptive.enabled = true;
+        adaptive.budget = std::chrono::nanoseconds(1);
+        SobelFilterSIMD adaptiveFilter;
+        adaptiveFilter.setAdaptiveQuality(adaptive);
+        bool tiers = true;
+        for (size_t t = 0; t < kQualityTierCount; ++t) {
+            GrayscaleImage output;
+            tiers = tiers && adaptiveFilter.apply(gray, output) && output.width() == w && output.height() == h &&
+                    adaptiveFilter.getLastMetrics().qualityTier == static_cast<QualityTier>(t);
+        }
+        record(tiers, "Gray input | adaptive tiers");
+    }
+    
+    void testYuvInput() {
+        std::cout << "\n=== YUV Input Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        
+        // YUYV de-interleaving at every level, including vector tails
+        std::mt19937 rng(17);
+        std::vector<uint8_t> packed(2 * 200);
+        for (auto& byte : packed) byte = static_cast<uint8_t>(rng());
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            bool exact = true;
+            for (size_t width : {1, 15, 16, 33, 64, 95, 200}) {
+                std::vector<uint8_t> luma(width);
+                yuyvToGrayRow(level, packed.data(), width, luma.data());
+                for (size_t x = 0; x < width; ++x) exact = exact && luma[x] == packed[2 * x];
+            }
+            record(exact, std::string("YUV | YUYV luma extraction | ") + simdLevelName(level));
+        }
+        
+        // NV12 (packed rows), I420 (padded stride) and YUYV (odd width) give the gray path's output
+        const size_t w = 41, h = 27, padded = 64;
+        const RGBImage rgb = createRandomImage(w, h, 23);
+        GrayscaleImage gray(w, h);
+        for (size_t i = 0; i < gray.size(); ++i) gray.data()[i] = rgb.data()[i].toGrayscale();
+        std::vector<uint8_t> nv12(w * h + w * ((h + 1) / 2));
+        std::vector<uint8_t> i420(padded * h + 2 * (padded / 2) * ((h + 1) / 2));
+        std::vector<uint8_t> yuyv((w + 1) / 2 * 4 * h);
+        for (auto* buffer : {&nv12, &i420, &yuyv}) {
+            for (auto& byte : *buffer) byte = static_cast<uint8_t>(rng());   // Chroma is noise
+        }
+        const size_t yuyvStride = (w + 1) / 2 * 4;
+        for (size_t y = 0; y < h; ++y) {
+            for (size_t x = 0; x < w; ++x) {
+                const uint8_t luma = gray.at(x, y);
+                nv12[y * w + x] = luma;
+                i420[y * padded + x] = luma;
+                yuyv[y * yuyvStride + 2 * x] = luma;
+            }
+        }
+        const std::vector<std::pair<YuvImageView, std::string>> views = {
+            {{YuvFormat::NV12, nv12.data(), w, h, 0}, "NV12"},
+            {{YuvFormat::I420, i420.data(), w, h, padded}, "I420"},
+            {{YuvFormat::YUYV, yuyv.data(), w, h, 0}, "YUYV"}
+        };
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (int kernel : {3, 7}) {
+                SobelConfig config;
+                config.kernel_size = kernel;
+                SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+                filter.setTuning({level, 0, 1});
+                GrayscaleImage expected;
+                filter.apply(gray, expected);
+                for (const auto& [view, name] : views) {
+                    GrayscaleImage edges;
+                    record(filter.apply(view, edges) &&
+                               std::equal(expected.data(), expected.data() + w * h, edges.data()),
+                           "YUV | " + name + " matches gray | " + std::to_string(kernel) + "x" +
+                               std::to_string(kernel) + " | " + simdLevelName(level));
+                }
+            }
+        }
+        
+        // Every adaptive tier, half resolution included, matches the gray path tier for tier
+        AdaptiveQualityConfig adaptive;
+        adaptive.enabled = true;
+        adaptive.budget = std::chrono::nanoseconds(1);
+        bool tiers = true;
+        for (const auto& [view, name] : views) {
+            SobelFilterSIMD grayFilter, yuvFilter;
+            grayFilter.setAdaptiveQuality(adaptive);
+            yuvFilter.setAdaptiveQuality(adaptive);
+            for (size_t t = 0; t < kQualityTierCount; ++t) {
+                GrayscaleImage expected, edges;
+                tiers = tiers && grayFilter.apply(gray, expected) && yuvFilter.apply(view, edges) &&
+                        yuvFilter.getLastMetrics().qualityTier == static_cast<QualityTier>(t) &&
+                        std::equal(expected.data(), expected.data() + w * h, edges.data());
+            }
+        }
+        record(tiers, "YUV | adaptive tiers match gray");
+        
+        // Invalid views are rejected, empty ones return false
+        SobelFilterSIMD filter;
+        GrayscaleImage output;
+        bool rejected = false;
+        try {
+            filter.apply(YuvImageView{YuvFormat::YUYV, yuyv.data(), w, h, w}, output);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        try {
+            filter.apply(YuvImageView{YuvFormat::NV12, nullptr, w, h, 0}, output);
+            rejected = false;
+        } catch (const std::invalid_argument&) {
+        }
+        record(rejected && !filter.apply(YuvImageView{}, output) && output.empty(),
+               "YUV | short stride and null luma rejected");
+    }
+    
+    void testPixelFormats() {
+        std::cout << "\n=== Pixel Format Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        const std::vector<std::pair<PixelFormat, std::string>> formats = {
+            {PixelFormat::RGB, "RGB"}, {PixelFormat::BGR, "BGR"}, {PixelFormat::RGBA, "RGBA"}, {PixelFormat::BGRA, "BGRA"}
+        };
+        // Copy `rgb` into `format`, rows `stride` bytes apart, alpha and padding random
+        auto pack = [](const RGBImage& rgb, PixelFormat format, size_t stride) {
+            std::mt19937 rng(29);
+            std::vector<uint8_t> bytes(stride * rgb.height());
+            for (auto& byte : bytes) byte = static_cast<uint8_t>(rng());
+            const size_t size = pixelFormatBytes(format);
+            const size_t red = pixelFormatRedOffset(format);
+            for (size_t y = 0; y < rgb.height(); ++y) {
+                for (size_t x = 0; x < rgb.width(); ++x) {
+                    uint8_t* p = bytes.data() + y * stride + x * size;
+                    p[red] = rgb.at(x, y).r;
+                    p[1] = rgb.at(x, y).g;
+                    p[2 - red] = rgb.at(x, y).b;
+                }
+            }
+            return bytes;
+        };
+        
+        // Row conversion of every format matches toGrayscale at every level, including tails
+        const RGBImage colors = createRandomImage(203, 1, 31);
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (const auto& [format, name] : formats) {
+                const std::vector<uint8_t> row = pack(colors, format, colors.width() * pixelFormatBytes(format));
+                bool exact = true;
+                for (size_t width : {1, 7, 8, 17, 203}) {
+                    std::vector<uint8_t> gray(width);
+                    packedToGrayRow(level, format, row.data(), width, gray.data());
+                    for (size_t x = 0; x < width; ++x) exact = exact && gray[x] == colors.data()[x].toGrayscale();
+                }
+                record(exact, "Pixel format | " + name + " row matches toGrayscale | " + simdLevelName(level));
+            }
+        }
+        
+        // apply() of each layout, with padded rows, equals the RGBImage path at every tier
+        const size_t w = 39, h = 26;
+        const RGBImage rgb = createRandomImage(w, h, 37);
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (const auto& [format, name] : formats) {
+                const size_t stride = w * pixelFormatBytes(format) + 5;
+                const std::vector<uint8_t> bytes = pack(rgb, format, stride);
+                AdaptiveQualityConfig adaptive;
+                adaptive.enabled = true;
+                adaptive.budget = std::chrono::nanoseconds(1);
+                SobelFilterSIMD rgbFilter(SobelFilterSIMD::OptimizationLevel::SCALAR);
+                SobelFilterSIMD viewFilter(SobelFilterSIMD::OptimizationLevel::SCALAR);
+                for (auto* filter : {&rgbFilter, &viewFilter}) {
+                    filter->setTuning({level, 0, 1});
+                    filter->setAdaptiveQuality(adaptive);
+                }
+                bool matches = true;
+                for (size_t t = 0; t < kQualityTierCount; ++t) {
+                    GrayscaleImage expected, edges;
+                    matches = matches && rgbFilter.apply(rgb, expected) &&
+                              viewFilter.apply(PackedImageView{format, bytes.data(), w, h, stride}, edges) &&
+                              std::equal(expected.data(), expected.data() + w * h, edges.data());
+                }
+                record(matches, "Pixel format | " + name + " apply matches RGB, all tiers | " + simdLevelName(level));
+            }
+        }
+        
+        SobelFilterSIMD filter;
+        GrayscaleImage output;
+        bool rejected = false;
+        try {
+            filter.apply(PackedImageView{PixelFormat::BGRA, nullptr, w, h, 0}, output);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        const std::vector<uint8_t> bgra = pack(rgb, PixelFormat::BGRA, 4 * w);
+        try {
+            filter.apply(PackedImageView{PixelFormat::BGRA, bgra.data(), w, h, 3 * w}, output);
+            rejected = false;
+        } catch (const std::invalid_argument&) {
+        }
+        record(rejected && !filter.apply(PackedImageView{}, output) && output.empty(),
+               "Pixel format | null data and short stride rejected");
+    }
+    
+    // Exact NxN Sobel of a 16-bit image with replicated borders, in int64
+    template<int N>
+    static void referenceGradient16(const GrayscaleImage16& image, size_t x, size_t y, int64_t& gx, int64_t& gy) {
+        constexpr auto s = SobelCoefficients<N>::smoothing();
+        constexpr auto d = SobelCoefficients<N>::derivative();
+        constexpr int r = N / 2;
+        auto sample = [&](int dx, int dy) {
+            const int px = std::clamp(static_cast<int>(x) + dx, 0, static_cast<int>(image.width()) - 1);
+            const int py = std::clamp(static_cast<int>(y) + dy, 0, static_cast<int>(image.height()) - 1);
+            return static_cast<int64_t>(image.at(px, py));
+        };
+        gx = gy = 0;
+        for (int j = 0; j < N; ++j) {
+            for (int i = 0; i < N; ++i) {
+                gx += int64_t(d[i]) * s[j] * sample(i - r, j - r);
+                gy += int64_t(s[i]) * d[j] * sample(i - r, j - r);
+            }
+        }
+    }
+    
+    template<int N>
+    bool magnitudesMatchReference16(const GrayscaleImage16& image, const std::vector<float>& magnitudes) {
+        for (size_t y = 0; y < image.height(); ++y) {
+            for (size_t x = 0; x < image.width(); ++x) {
+                int64_t gx = 0, gy = 0;
+                referenceGradient16<N>(image, x, y, gx, gy);
+                const float fx = static_cast<float>(gx);
+                const float fy = static_cast<float>(gy);
+                if (magnitudes[y * image.width() + x] != std::sqrt(fx * fx + fy * fy)) return false;
+            }
+        }
+        return true;
+    }
+    
+    void testHighBitDepth() {
+        std::cout << "\n=== High Bit Depth Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        std::mt19937 rng(41);
+        std::uniform_int_distribution<int> sample(0, 65535);
+        
+        // 16-bit RGB -> gray matches RGBPixel16::toGrayscale at every level
+        std::vector<uint16_t> rgbRow(3 * 203), grayRow(203);
+        for (auto& v : rgbRow) v = static_cast<uint16_t>(sample(rng));
+        std::fill_n(rgbRow.begin(), 6, uint16_t(65535));   // Saturated white
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            bool exact = true;
+            for (size_t width : {1, 3, 4, 9, 203}) {
+                rgb16ToGrayRow(level, rgbRow.data(), width, grayRow.data());
+                for (size_t x = 0; x < width; ++x) {
+                    const RGBPixel16 p(rgbRow[3 * x], rgbRow[3 * x + 1], rgbRow[3 * x + 2]);
+                    exact = exact && grayRow[x] == p.toGrayscale();
+                }
+            }
+            record(exact, std::string("16-bit | RGB16 row matches toGrayscale | ") + simdLevelName(level));
+        }
+        
+        // Full-range magnitudes are exact against an int64 reference at every level and kernel
+        const size_t w = 37, h = 21;
+        GrayscaleImage16 gray(w, h);
+        RGBImage16 rgb(w, h);
+        for (size_t i = 0; i < rgb.size(); ++i) {
+            rgb.data()[i] = RGBPixel16(static_cast<uint16_t>(sample(rng)), static_cast<uint16_t>(sample(rng)),
+                                       static_cast<uint16_t>(sample(rng)));
+            gray.data()[i] = rgb.data()[i].toGrayscale();
+        }
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (int kernel : {3, 5, 7}) {
+                SobelConfig config;
+                config.kernel_size = kernel;
+                SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+                filter.setTuning({level, 0, 1});
+                std::vector<float> magnitudes(w * h);
+                SobelFilterSIMD::OutputDescriptor outputs;
+                outputs.magnitude = magnitudes.data();
+                bool exact = filter.apply(gray, outputs);
+                switch (kernel) {
+                    case 3: exact = exact && magnitudesMatchReference16<3>(gray, magnitudes); break;
+                    case 5: exact = exact && magnitudesMatchReference16<5>(gray, magnitudes); break;
+                    default: exact = exact && magnitudesMatchReference16<7>(gray, magnitudes); break;
+                }
+                GrayscaleImage fromGray, fromRGB;
+                exact = exact && filter.apply(gray, fromGray) && filter.apply(rgb, fromRGB) &&
+                        std::equal(fromGray.data(), fromGray.data() + w * h, fromRGB.data());
+                record(exact, "16-bit | exact magnitudes, RGB16 = gray16 | " + std::to_string(kernel) + "x" +
+                                  std::to_string(kernel) + " | " + simdLevelName(level));
+            }
+        }
+        
+        // A full-scale step is not clipped: 65535 * smoothing sum * derivative gain
+        GrayscaleImage16 step(40, 8);
+        for (size_t y = 0; y < step.height(); ++y) {
+            for (size_t x = 0; x < step.width(); ++x) step.at(x, y) = x < 20 ? 0 : 65535;
+        }
+        SobelConfig config7;
+        config7.kernel_size = 7;
+        SobelFilterSIMD stepFilter(config7);
+        std::vector<float> stepMagnitudes(step.size());
+        SobelFilterSIMD::OutputDescriptor stepOutputs;
+        stepOutputs.magnitude = stepMagnitudes.data();
+        stepFilter.apply(step, stepOutputs);
+        const float peak = *std::max_element(stepMagnitudes.begin(), stepMagnitudes.end());
+        const float expectedPeak = 65535.0f * SobelCoefficients<7>::smoothingSum() *
+                                   SobelCoefficients<7>::derivativeGain();
+        record(peak == expectedPeak, "16-bit | full-scale 7x7 step keeps its range");
+        
+        // 8-bit data widened by 257 gives the 8-bit edge map (up to rounding of the rescale)
+        const RGBImage rgb8 = createRandomImage(w, h, 43);
+        GrayscaleImage gray8(w, h);
+        GrayscaleImage16 wide(w, h);
+        for (size_t i = 0; i < gray8.size(); ++i) {
+            gray8.data()[i] = rgb8.data()[i].toGrayscale();
+            wide.data()[i] = static_cast<uint16_t>(gray8.data()[i] * 257);
+        }
+        SobelFilterSIMD filter;
+        GrayscaleImage edges8, edges16;
+        filter.apply(gray8, edges8);
+        filter.apply(wide, edges16);
+        TestResult widened = compareImages(edges8, edges16, "16-bit | widened 8-bit data matches 8-bit edges", 1.0);
+        results_.push_back(widened);
+        std::cout << (widened.passed ? "✅ PASS" : "❌ FAIL") << " " << widened.testName << std::endl;
+        
+        // Adaptive tiers, half resolution included, run on 16-bit input; empty input is rejected
+        AdaptiveQualityConfig adaptive;
+        adaptive.enabled = true;
+        adaptive.budget = std::chrono::nanoseconds(1);
+        SobelFilterSIMD adaptiveFilter;
+        adaptiveFilter.setAdaptiveQuality(adaptive);
+        bool tiers = true;
+        for (size_t t = 0; t < kQualityTierCount; ++t) {
+            GrayscaleImage output;
+            tiers = tiers && adaptiveFilter.apply(gray, output) && output.width() == w && output.height() == h &&
+                    adaptiveFilter.getLastMetrics().qualityTier == static_cast<QualityTier>(t);
+        }
+        GrayscaleImage emptyOutput(3, 3);
+        tiers = tiers && !adaptiveFilter.apply(RGBImage16(), emptyOutput) && emptyOutput.empty();
+        record(tiers, "16-bit | adaptive tiers, empty input rejected");
+    }
+    
+    void testColorGradient() {
+        std::cout << "\n=== Color Gradient Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        const std::vector<std::pair<ColorGradientMode, std::string>> modes = {
+            {ColorGradientMode::MaxMagnitude, "max"}, {ColorGradientMode::SumOfSquares, "sum"},
+            {ColorGradientMode::DiZenzo, "Di Zenzo"}
+        };
+        
+        // De-interleaving is exact for every layout at every level, including tails
+        const RGBImage colors = createRandomImage(203, 1, 47);
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            bool exact = true;
+            for (PixelFormat format : {PixelFormat::RGB, PixelFormat::BGR, PixelFormat::RGBA, PixelFormat::BGRA}) {
+                const size_t size = pixelFormatBytes(format);
+                const size_t red = pixelFormatRedOffset(format);
+                std::vector<uint8_t> row(colors.width() * size, 0xA5);
+                for (size_t x = 0; x < colors.width(); ++x) {
+                    row[x * size + red] = colors.data()[x].r;
+                    row[x * size + 1] = colors.data()[x].g;
+                    row[x * size + 2 - red] = colors.data()[x].b;
+                }
+                for (size_t width : {1, 7, 8, 17, 203}) {
+                    std::vector<uint8_t> r(width), g(width), b(width);
+                    uint8_t* const channels[3] = {r.data(), g.data(), b.data()};
+                    deinterleaveRow(level, format, row.data(), width, channels);
+                    for (size_t x = 0; x < width; ++x) {
+                        const RGBPixel& p = colors.data()[x];
+                        exact = exact && r[x] == p.r && g[x] == p.g && b[x] == p.b;
+                    }
+                }
+            }
+            record(exact, std::string("Color | de-interleave, all layouts | ") + simdLevelName(level));
+        }
+        
+        // Magnitudes equal the combination of per-channel gradients from the gray path, and
+        // Gx/Gy come from the strongest channel, for every mode, kernel and level
+        const size_t w = 35, h = 19;
+        const RGBImage rgb = createRandomImage(w, h, 53);
+        std::array<GrayscaleImage, 3> planes;
+        for (auto& plane : planes) plane = GrayscaleImage(w, h);
+        for (size_t i = 0; i < rgb.size(); ++i) {
+            planes[0].data()[i] = rgb.data()[i].r;
+            planes[1].data()[i] = rgb.data()[i].g;
+            planes[2].data()[i] = rgb.data()[i].b;
+        }
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (int kernel : {3, 5}) {   // 7x7 channel gradients would saturate the int16 reference
+                SobelConfig config;
+                config.kernel_size = kernel;
+                SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+                filter.setTuning({level, 0, 1});
+                std::array<std::vector<int16_t>, 3> gx, gy;
+                for (size_t c = 0; c < 3; ++c) {
+                    gx[c].resize(w * h);
+                    gy[c].resize(w * h);
+                    SobelFilterSIMD::OutputDescriptor outputs;
+                    outputs.gx = gx[c].data();
+                    outputs.gy = gy[c].data();
+                    filter.apply(planes[c], outputs);
+                }
+                for (const auto& [mode, name] : modes) {
+                    filter.setColorGradient(mode);
+                    std::vector<float> magnitudes(w * h);
+                    std::vector<int16_t> colorGx(w * h), colorGy(w * h);
+                    SobelFilterSIMD::OutputDescriptor outputs;
+                    outputs.magnitude = magnitudes.data();
+                    outputs.gx = colorGx.data();
+                    outputs.gy = colorGy.data();
+                    bool exact = filter.apply(rgb, outputs);
+                    for (size_t i = 0; i < w * h; ++i) {
+                        float fx[3], fy[3], energy[3];
+                        for (size_t c = 0; c < 3; ++c) {
+                            fx[c] = gx[c][i];
+                            fy[c] = gy[c][i];
+                            energy[c] = fx[c] * fx[c] + fy[c] * fy[c];
+                        }
+                        float expected;
+                        if (mode == ColorGradientMode::DiZenzo) {
+                            const float gxx = (fx[0] * fx[0] + fx[1] * fx[1]) + fx[2] * fx[2];
+                            const float gyy = (fy[0] * fy[0] + fy[1] * fy[1]) + fy[2] * fy[2];
+                            const float gxy = (fx[0] * fy[0] + fx[1] * fy[1]) + fx[2] * fy[2];
+                            const float d = gxx - gyy;
+                            const float e = 2.0f * gxy;
+                            expected = std::sqrt(((gxx + gyy) + std::sqrt(d * d + e * e)) * 0.5f);
+                        } else if (mode == ColorGradientMode::MaxMagnitude) {
+                            expected = std::sqrt(std::max(std::max(energy[0], energy[1]), energy[2]));
+                        } else {
+                            expected = std::sqrt((energy[0] + energy[1]) + energy[2]);
+                        }
+                        size_t dominant = 0;
+                        for (size_t c = 1; c < 3; ++c) dominant = energy[c] > energy[dominant] ? c : dominant;
+                        exact = exact && magnitudes[i] == expected && colorGx[i] == gx[dominant][i] &&
+                                colorGy[i] == gy[dominant][i];
+                    }
+                    record(exact, "Color | " + name + " matches per-channel gradients | " + std::to_string(kernel) +
+                                      "x" + std::to_string(kernel) + " | " + simdLevelName(level));
+                }
+            }
+        }
+        
+        // On a gray image the max mode is the plain gray gradient
+        RGBImage grayRGB(w, h);
+        for (size_t i = 0; i < grayRGB.size(); ++i) {
+            const uint8_t v = planes[1].data()[i];
+            grayRGB.data()[i] = RGBPixel(v, v, v);
+        }
+        SobelFilterSIMD grayFilter, maxFilter;
+        maxFilter.setColorGradient(ColorGradientMode::MaxMagnitude);
+        GrayscaleImage grayEdges, maxEdges;
+        grayFilter.apply(planes[1], grayEdges);
+        maxFilter.apply(grayRGB, maxEdges);
+        record(std::equal(grayEdges.data(), grayEdges.data() + w * h, maxEdges.data()),
+               "Color | max mode on a gray image equals gray edges");
+        
+        // An edge between two colors of equal luminance is invisible to luma only
+        const RGBPixel left(200, 40, 90);
+        const RGBPixel right = [&] {
+            for (int g = 0; g < 256; ++g) {
+                for (int r = 0; r < 256; ++r) {
+                    const RGBPixel candidate(static_cast<uint8_t>(r), static_cast<uint8_t>(g), 200);
+                    if (candidate.g != left.g && candidate.toGrayscale() == left.toGrayscale()) return candidate;
+                }
+            }
+            return left;
+        }();
+        RGBImage isoluminant(24, 12);
+        for (size_t y = 0; y < isoluminant.height(); ++y) {
+            for (size_t x = 0; x < isoluminant.width(); ++x) isoluminant.at(x, y) = x < 12 ? left : right;
+        }
+        bool isolated = right.toGrayscale() == left.toGrayscale();
+        SobelFilterSIMD isoFilter;
+        isolated = isolated && isoFilter.getColorGradient() == ColorGradientMode::Luma;
+        for (ColorGradientMode mode : {ColorGradientMode::Luma, ColorGradientMode::MaxMagnitude,
+                                       ColorGradientMode::SumOfSquares, ColorGradientMode::DiZenzo}) {
+            isoFilter.setColorGradient(mode);
+            std::vector<float> magnitudes(isoluminant.size());
+            SobelFilterSIMD::OutputDescriptor outputs;
+            outputs.magnitude = magnitudes.data();
+            isoFilter.apply(isoluminant, outputs);
+            const float peak = *std::max_element(magnitudes.begin(), magnitudes.end());
+            isolated = isolated && (mode == ColorGradientMode::Luma ? peak == 0.0f : peak > 0.0f);
+        }
+        record(isolated, "Color | isoluminant edge found by color modes only");
+        
+        // Adaptive tiers run in color mode (half resolution falls back to luma)
+        AdaptiveQualityConfig adaptive;
+        adaptive.enabled = true;
+        adaptive.budget = std::chrono::nanoseconds(1);
+        SobelFilterSIMD adaptiveFilter;
+        adaptiveFilter.setAdaptiveQuality(adaptive);
+        adaptiveFilter.setColorGradient(ColorGradientMode::DiZenzo);
+        bool tiers = true;
+        for (size_t t = 0; t < kQualityTierCount; ++t) {
+            GrayscaleImage output;
+            tiers = tiers && adaptiveFilter.apply(rgb, output) && output.width() == w && output.height() == h &&
+                    adaptiveFilter.getLastMetrics().qualityTier == static_cast<QualityTier>(t);
+        }
+        GrayscaleImage afterTiers, expected;
+        adaptiveFilter.setAdaptiveQuality(AdaptiveQualityConfig());
+        SobelFilterSIMD reference;
+        reference.setColorGradient(ColorGradientMode::DiZenzo);
+        tiers = tiers && adaptiveFilter.apply(rgb, afterTiers) && reference.apply(rgb, expected) &&
+                std::equal(expected.data(), expected.data() + w * h, afterTiers.data());
+        record(tiers, "Color | adaptive tiers, back to full quality afterwards");
+    }
+    
+    // Separate blur pass, then NxN Sobel, in double: the blur reads replicated raw pixels,
+    // so the blurred halo is what the fused kernels see
+    template<int N>
+    static std::vector<double> blurThenSobel(const GrayscaleImage& image, double sigma, int radius) {
+        constexpr auto s = SobelCoefficients<N>::smoothing();
+        constexpr auto d = SobelCoefficients<N>::derivative();
+        constexpr int r = N / 2;
+        std::vector<double> gauss(2 * radius + 1);
+        double sum = 0.0;
+        for (int k = -radius; k <= radius; ++k) sum += gauss[k + radius] = std::exp(-0.5 * k * k / (sigma * sigma));
+        for (double& g : gauss) g /= sum;
+
+        const int w = static_cast<int>(image.width());
+        const int h = static_cast<int>(image.height());
+        auto blurred = [&](int x, int y) {
+            double v = 0.0;
+            for (int j = -radius; j <= radius; ++j) {
+                for (int i = -radius; i <= radius; ++i) {
+                    v += gauss[i + radius] * gauss[j + radius] *
+                         image.at(std::clamp(x + i, 0, w - 1), std::clamp(y + j, 0, h - 1));
+                }
+            }
+            return v;
+        };
+        std::vector<double> magnitudes(image.size());
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                double gx = 0.0, gy = 0.0;
+                for (int j = 0; j < N; ++j) {
+                    for (int i = 0; i < N; ++i) {
+                        const double b = blurred(x + i - r, y + j - r);
+                        gx += d[i] * s[j] * b;
+                        gy += s[i] * d[j] * b;
+                    }
+                }
+                magnitudes[y * w + x] = std::sqrt(gx * gx + gy * gy);
+            }
+        }
+        return magnitudes;
+    }
+    
+    void testPreSmoothing() {
+        std::cout << "\n=== Pre-Smoothing Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        const size_t w = 29, h = 17;
+        const RGBImage rgb = createRandomImage(w, h, 59);
+        GrayscaleImage gray(w, h);
+        for (size_t i = 0; i < gray.size(); ++i) gray.data()[i] = rgb.data()[i].toGrayscale();
+        
+        // The fused kernels match blurring first, up to the final rounding of Gx/Gy, and every
+        // level gives the scalar result exactly
+        for (int kernel : {3, 5, 7}) {
+            std::vector<double> reference;
+            switch (kernel) {
+                case 3: reference = blurThenSobel<3>(gray, 1.2, 3); break;
+                case 5: reference = blurThenSobel<5>(gray, 1.2, 3); break;
+                default: reference = blurThenSobel<7>(gray, 1.2, 3); break;
+            }
+            std::vector<float> scalarMagnitudes;
+            for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+                if (!isSimdLevelUsable(level)) continue;
+                SobelConfig config;
+                config.kernel_size = kernel;
+                SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+                filter.setTuning({level, 0, 1});
+                filter.setPreSmoothing({1.2f, 3});
+                std::vector<float> magnitudes(w * h);
+                SobelFilterSIMD::OutputDescriptor outputs;
+                outputs.magnitude = magnitudes.data();
+                bool matches = filter.apply(gray, outputs);
+                for (size_t i = 0; i < w * h; ++i) {
+                    matches = matches && std::abs(magnitudes[i] - reference[i]) <= 1.0 + 1e-5 * reference[i];
+                }
+                if (level == SimdLevel::Scalar) scalarMagnitudes = magnitudes;
+                matches = matches && magnitudes == scalarMagnitudes;
+                record(matches, "Pre-smoothing | fused = blur then Sobel, levels exact | " + std::to_string(kernel) +
+                                    "x" + std::to_string(kernel) + " | " + simdLevelName(level));
+            }
+        }
+        
+        // 16-bit samples: every level agrees with the scalar pass
+        GrayscaleImage16 gray16(w, h);
+        std::mt19937 rng(61);
+        for (size_t i = 0; i < gray16.size(); ++i) gray16.data()[i] = static_cast<uint16_t>(rng() & 0xFFFF);
+        std::vector<float> scalar16;
+        bool levels16 = true;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            SobelFilterSIMD filter(SobelFilterSIMD::OptimizationLevel::SCALAR);
+            filter.setTuning({level, 0, 1});
+            filter.setPreSmoothing({2.0f, 0});
+            std::vector<float> magnitudes(w * h);
+            SobelFilterSIMD::OutputDescriptor outputs;
+            outputs.magnitude = magnitudes.data();
+            levels16 = levels16 && filter.apply(gray16, outputs);
+            if (level == SimdLevel::Scalar) scalar16 = magnitudes;
+            levels16 = levels16 && magnitudes == scalar16;
+        }
+        record(levels16, "Pre-smoothing | 16-bit levels agree");
+        
+        // Noise on a flat field is damped; sigma 0 is the plain filter
+        GrayscaleImage noisy(64, 48);
+        std::normal_distribution<double> noise(0.0, 12.0);
+        for (size_t i = 0; i < noisy.size(); ++i) {
+            noisy.data()[i] = static_cast<uint8_t>(std::clamp(128.0 + noise(rng), 0.0, 255.0));
+        }
+        auto meanMagnitude = [&](SobelFilterSIMD& filter) {
+            std::vector<float> magnitudes(noisy.size());
+            SobelFilterSIMD::OutputDescriptor outputs;
+            outputs.magnitude = magnitudes.data();
+            filter.apply(noisy, outputs);
+            double sum = 0.0;
+            for (float m : magnitudes) sum += m;
+            return sum / magnitudes.size();
+        };
+        SobelFilterSIMD plain, smoothed, disabled;
+        smoothed.setPreSmoothing({1.5f, 0});
+        disabled.setPreSmoothing({1.5f, 0});
+        disabled.setPreSmoothing({});
+        GrayscaleImage plainEdges, disabledEdges;
+        plain.apply(noisy, plainEdges);
+        disabled.apply(noisy, disabledEdges);
+        record(meanMagnitude(smoothed) < 0.5 * meanMagnitude(plain) &&
+               std::equal(plainEdges.data(), plainEdges.data() + noisy.size(), disabledEdges.data()),
+               "Pre-smoothing | damps noise, sigma 0 is the plain filter");
+        
+        // Invalid settings are rejected and leave the filter as it was
+        bool rejected = true;
+        for (const PreSmoothingConfig& bad : {PreSmoothingConfig{-1.0f, 0}, PreSmoothingConfig{NAN, 0},
+                                              PreSmoothingConfig{1.0f, kMaxPreSmoothingRadius + 1},
+                                              PreSmoothingConfig{1.0f, -1}}) {
+            try {
+                smoothed.setPreSmoothing(bad);
+                rejected = false;
+            } catch (const std::invalid_argument&) {
+            }
+        }
+        rejected = rejected && smoothed.getPreSmoothing().sigma == 1.5f;
+        record(rejected, "Pre-smoothing | invalid settings rejected");
+        
+        // Canny, orientation, color modes and every adaptive tier run smoothed
+        AdaptiveQualityConfig adaptive;
+        adaptive.enabled = true;
+        adaptive.budget = std::chrono::nanoseconds(1);
+        SobelFilterSIMD adaptiveFilter;
+        adaptiveFilter.setPreSmoothing({1.0f, 0});
+        adaptiveFilter.setAdaptiveQuality(adaptive);
+        bool runs = true;
+        for (size_t t = 0; t < kQualityTierCount; ++t) {
+            GrayscaleImage output;
+            runs = runs && adaptiveFilter.apply(rgb, output) && output.width() == w && output.height() == h;
+        }
+        GrayscaleImage canny, directions, color;
+        adaptiveFilter.setColorGradient(ColorGradientMode::DiZenzo);
+        runs = runs && adaptiveFilter.applyCanny(rgb, canny) && adaptiveFilter.computeOrientation(rgb, directions) &&
+               adaptiveFilter.apply(rgb, color) && canny.width() == w && directions.height() == h;
+        record(runs, "Pre-smoothing | Canny, orientation, color and adaptive tiers");
+    }
+    
+    void testRegions() {
+        std::cout << "\n=== Region of Interest Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        auto same = [](const RegionOfInterest& a, const RegionOfInterest& b) {
+            return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+        };
+        
+        // Overlaps merge (also through a box that only grows into reach), touching boxes stay
+        // apart, boxes are clipped and empty or outside ones dropped
+        const std::vector<RegionOfInterest> merged = mergeRegions(
+            {{30, 30, 10, 10}, {0, 0, 10, 10}, {12, 0, 5, 5}, {5, 5, 10, 10}, {10, 20, 5, 5}, {16, 4, 2, 2},
+             {90, 5, 50, 50}, {200, 0, 5, 5}, {3, 40, 0, 5}, {18, 0, 3, 3}},
+            100, 50);
+        bool merging = merged.size() == 5 && same(merged[0], {0, 0, 18, 15}) && same(merged[1], {18, 0, 3, 3}) &&
+                       same(merged[2], {90, 5, 10, 45}) && same(merged[3], {10, 20, 5, 5}) &&
+                       same(merged[4], {30, 30, 10, 10});
+        for (size_t i = 0; i < merged.size(); ++i) {
+            for (size_t j = i + 1; j < merged.size(); ++j) merging = merging && !merged[i].overlaps(merged[j]);
+        }
+        record(merging, "ROI | clip, merge and order regions");
+        
+        // Inside the regions every plane equals the full-frame result, including at the frame edge;
+        // outside them the caller's planes are untouched
+        const size_t w = 61, h = 47;
+        const RGBImage rgb = createRandomImage(w, h, 67);
+        const std::vector<RegionOfInterest> regions = {
+            {0, 0, 9, 7}, {20, 10, 15, 12}, {30, 18, 12, 9}, {52, 38, 20, 20}, {3, 30, 1, 1}
+        };
+        const std::vector<RegionOfInterest> union_ = mergeRegions(regions, w, h);
+        auto inside = [&](size_t x, size_t y) {
+            for (const RegionOfInterest& r : union_) {
+                if (x >= r.x && x < r.right() && y >= r.y && y < r.bottom()) return true;
+            }
+            return false;
+        };
+        struct Setting {
+            int kernel;
+            ColorGradientMode color;
+            float sigma;
+            std::string name;
+        };
+        const std::vector<Setting> settings = {
+            {3, ColorGradientMode::Luma, 0.0f, "3x3"}, {5, ColorGradientMode::Luma, 0.0f, "5x5"},
+            {7, ColorGradientMode::Luma, 0.0f, "7x7"}, {5, ColorGradientMode::DiZenzo, 0.0f, "5x5 Di Zenzo"},
+            {3, ColorGradientMode::Luma, 1.5f, "3x3 pre-smoothed"}
+        };
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (const Setting& setting : settings) {
+                SobelConfig config;
+                config.kernel_size = setting.kernel;
+                SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+                filter.setTuning({level, 0, 1});
+                filter.setColorGradient(setting.color);
+                filter.setPreSmoothing({setting.sigma, 0});
+                std::vector<int16_t> fullGx(w * h), fullGy(w * h);
+                std::vector<float> fullMagnitude(w * h);
+                SobelFilterSIMD::OutputDescriptor full;
+                full.gx = fullGx.data();
+                full.gy = fullGy.data();
+                full.magnitude = fullMagnitude.data();
+                filter.apply(rgb, full);
+                
+                const size_t stride = w + 3;
+                std::vector<int16_t> gx(stride * h, 12345), gy(stride * h, 12345);
+                std::vector<float> magnitude(stride * h, -1.0f);
+                SobelFilterSIMD::OutputDescriptor partial;
+                partial.gx = gx.data();
+                partial.gy = gy.data();
+                partial.magnitude = magnitude.data();
+                partial.gxStride = partial.gyStride = partial.magnitudeStride = stride;
+                bool exact = filter.applyRegions(
+                    PackedImageView{PixelFormat::RGB, reinterpret_cast<const uint8_t*>(rgb.data()), w, h, 0}, regions, partial);
+                for (size_t y = 0; y < h; ++y) {
+                    for (size_t x = 0; x < w; ++x) {
+                        const size_t i = y * w + x;
+                        const size_t j = y * stride + x;
+                        exact = exact && (inside(x, y)
+                            ? gx[j] == fullGx[i] && gy[j] == fullGy[i] && magnitude[j] == fullMagnitude[i]
+                            : gx[j] == 12345 && gy[j] == 12345 && magnitude[j] == -1.0f);
+                    }
+                }
+                record(exact, "ROI | planes match the full frame | " + setting.name + " | " + simdLevelName(level));
+            }
+        }
+        
+        // Union normalization of regions tiling the frame is the full-frame edge map; per-region
+        // normalization stretches a faint region to the full range
+        SobelFilterSIMD filter;
+        GrayscaleImage fullEdges, tiledEdges;
+        filter.apply(rgb, fullEdges);
+        filter.applyRegions(rgb, {{0, 0, 30, 20}, {30, 0, 31, 20}, {0, 20, 61, 27}}, tiledEdges);
+        record(std::equal(fullEdges.data(), fullEdges.data() + w * h, tiledEdges.data()),
+               "ROI | union of tiles equals the full edge map");
+        
+        GrayscaleImage contrast(w, h);
+        for (size_t y = 0; y < h; ++y) {
+            for (size_t x = 0; x < w; ++x) {
+                const uint8_t v = rgb.at(x, y).toGrayscale();
+                contrast.at(x, y) = x < w / 2 ? v : static_cast<uint8_t>(100 + v / 16);   // Faint right half
+            }
+        }
+        const std::vector<RegionOfInterest> halves = {{2, 2, 20, 20}, {40, 2, 18, 20}};
+        auto peak = [&](const GrayscaleImage& edges, const RegionOfInterest& r) {
+            uint8_t value = 0;
+            for (size_t y = r.y; y < r.bottom(); ++y) {
+                for (size_t x = r.x; x < r.right(); ++x) value = std::max(value, edges.at(x, y));
+            }
+            return value;
+        };
+        auto sameInside = [&](const GrayscaleImage& a, const GrayscaleImage& b, const RegionOfInterest& r) {
+            bool equal = true;
+            for (size_t y = r.y; y < r.bottom(); ++y) {
+                for (size_t x = r.x; x < r.right(); ++x) equal = equal && a.at(x, y) == b.at(x, y);
+            }
+            return equal;
+        };
+        GrayscaleImage unionEdges, perRegionEdges, firstOnly;
+        filter.applyRegions(contrast, halves, unionEdges, RegionNormalization::Union);
+        filter.applyRegions(contrast, halves, perRegionEdges, RegionNormalization::PerRegion);
+        filter.applyRegions(contrast, {halves[0]}, firstOnly, RegionNormalization::Union);
+        const uint8_t top = peak(perRegionEdges, halves[0]);
+        bool normalized = peak(perRegionEdges, halves[1]) == top && peak(unionEdges, halves[1]) < top / 2 &&
+                          sameInside(firstOnly, perRegionEdges, halves[0]) &&
+                          unionEdges.at(30, 30) == 0;
+        record(normalized, "ROI | per-region and union normalization");
+        
+        // Buffers stay sized for the frame, so a new set of regions allocates nothing
+        bool steady = true;
+        if (allocationTrackingEnabled()) {
+            SobelFilterSIMD tracked;
+            SobelFilterSIMD::OutputDescriptor edgesOnly;
+            std::vector<uint8_t> edges(w * h);
+            edgesOnly.edges = edges.data();
+            tracked.applyRegions(contrast, regions, edgesOnly);
+            const size_t count = tracked.getLastMetrics().allocationTotal.count;
+            tracked.applyRegions(contrast, halves, edgesOnly);
+            tracked.applyRegions(contrast, {{0, 0, w, h}}, edgesOnly, RegionNormalization::PerRegion);
+            steady = tracked.getLastMetrics().allocationTotal.count == count;
+        }
+        GrayscaleImage emptyOutput(3, 3), none;
+        steady = steady && !filter.applyRegions(RGBImage(), regions, emptyOutput) && emptyOutput.empty() &&
+                 filter.applyRegions(rgb, {}, none) && none.width() == w &&
+                 std::all_of(none.data(), none.data() + w * h, [](uint8_t v) { return v == 0; });
+        record(steady, "ROI | no reallocation, empty input and region list");
+    }
+
+    void testPyramid() {
+        std::cout << "\n=== Pyramid Tests ===" << std::endl;
+        auto record = [&](bool passed, const std::string& name) {
+            results_.push_back({passed, name, passed ? "OK" : "Mismatch", 0, 0});
+            std::cout << (passed ? "✅ PASS" : "❌ FAIL") << " " << name << std::endl;
+        };
+        auto decimate = [](const GrayscaleImage& src) {
+            const size_t w = src.width(), h = src.height();
+            GrayscaleImage half((w + 1) / 2, (h + 1) / 2);
+            for (size_t y = 0; y < half.height(); ++y) {
+                const size_t y1 = std::min(2 * y + 1, h - 1);
+                for (size_t x = 0; x < half.width(); ++x) {
+                    const size_t x1 = std::min(2 * x + 1, w - 1);
+                    half.at(x, y) = static_cast<uint8_t>(
+                        (src.at(2 * x, 2 * y) + src.at(x1, 2 * y) + src.at(2 * x, y1) + src.at(x1, y1) + 2) >> 2);
+                }
+            }
+            return half;
+        };
+        
+        // The decimation row matches the 2x2 rounded mean on every level, odd widths and tails included
+        std::mt19937 rng(71);
+        std::vector<uint8_t> top(300), bottom(300);
+        for (auto& v : top) v = static_cast<uint8_t>(rng());
+        for (auto& v : bottom) v = static_cast<uint8_t>(rng());
+        top[0] = bottom[0] = top[1] = bottom[1] = 255;   // Pair sums at the top of the range
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            bool exact = true;
+            for (size_t width : {1, 2, 3, 31, 32, 33, 63, 64, 65, 127, 129, 300}) {
+                std::vector<uint8_t> out((width + 1) / 2 + 1, 77);
+                downsampleRow2x(level, top.data(), bottom.data(), width, out.data());
+                for (size_t x = 0; x < (width + 1) / 2; ++x) {
+                    const size_t x1 = std::min(2 * x + 1, width - 1);
+                    exact = exact && out[x] == ((top[2 * x] + top[x1] + bottom[2 * x] + bottom[x1] + 2) >> 2);
+                }
+                exact = exact && out[(width + 1) / 2] == 77;
+            }
+            record(exact, std::string("Pyramid | downsampleRow2x | ") + simdLevelName(level));
+        }
+        
+        // Every level equals apply() on a decimation chain of the gray image
+        const RGBImage rgb = createRandomImage(77, 53, 73);
+        GrayscaleImage gray(rgb.width(), rgb.height());
+        for (size_t y = 0; y < rgb.height(); ++y) {
+            for (size_t x = 0; x < rgb.width(); ++x) gray.at(x, y) = rgb.at(x, y).toGrayscale();
+        }
+        const size_t levels = 5;
+        std::vector<GrayscaleImage> chain = {gray};
+        for (size_t l = 1; l < levels; ++l) chain.push_back(decimate(chain.back()));
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (!isSimdLevelUsable(level)) continue;
+            for (int kernel : {3, 5, 7}) {
+                SobelConfig config;
+                config.kernel_size = kernel;
+                SobelFilterSIMD filter(config, SobelFilterSIMD::OptimizationLevel::SCALAR);
+                filter.setTuning({level, 8, 2});
+                std::vector<GrayscaleImage> pyramid, fromRgb;
+                bool exact = filter.applyPyramid(gray, levels, pyramid) && pyramid.size() == levels &&
+                             filter.applyPyramid(rgb, levels, fromRgb) && fromRgb.size() == levels;
+                for (size_t l = 0; exact && l < levels; ++l) {
+                    GrayscaleImage expected;
+                    filter.apply(chain[l], expected);
+                    exact = pyramid[l].width() == chain[l].width() && pyramid[l].height() == chain[l].height() &&
+                            std::equal(expected.data(), expected.data() + expected.size(), pyramid[l].data()) &&
+                            std::equal(expected.data(), expected.data() + expected.size(), fromRgb[l].data());
+                }
+                record(exact, "Pyramid | levels match apply() on decimated images | " + std::to_string(kernel) + "x" +
+                                  std::to_string(kernel) + " | " + simdLevelName(level));
+            }
+        }
+        
+        // A second call with the same levels allocates nothing; bad arguments
+        bool steady = true;
+        if (allocationTrackingEnabled()) {
+            SobelFilterSIMD tracked;
+            std::vector<GrayscaleImage> pyramid;
+            tracked.applyPyramid(rgb, levels, pyramid);
+            const size_t count = tracked.getLastMetrics().allocationTotal.count;
+            tracked.applyPyramid(rgb, levels, pyramid);
+            tracked.applyPyramid(gray, 3, pyramid);
+            steady = tracked.getLastMetrics().allocationTotal.count == count;
+        }
+        SobelFilterSIMD filter;
+        std::vector<GrayscaleImage> pyramid(2);
+        bool threw = false;
+        try {
+            filter.applyPyramid(gray, 0, pyramid);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        steady = steady && threw && !filter.applyPyramid(RGBImage(), 3, pyramid) && pyramid.empty();
+        record(steady, "Pyramid | no reallocation, zero levels and empty input");
+    }
+    
+    bool printSummary() {
         std::cout << "\n=== Test Summary ===" << std::endl;
         
         size_t totalTests = results_.size();
@@ -269,24 +2557,47 @@ public:
                 }
             }
         }
+        
+        return passedTests == totalTests;
     }
     
-    void runAllTests() {
+    bool runAllTests() {
         std::cout << "Starting SIMD Sobel Filter Validation Tests..." << std::endl;
         
         testSIMDCorrectness();
         testQuantizationLevels(); 
         testEdgeCases();
+        testKernelSizes();
+        testConvolutionEngine();
+        testOrientationAndCanny();
+        testMultiOutput();
+        testTensorExport();
+        testBenchmarkStats();
+        testBaselineGate();
+        testTracer();
+        testLatencyHistogram();
+        testAllocationAccounting();
+        testAutotuner();
+        testAdaptiveQuality();
+        testImageFormats();
+        testGrayFrameInput();
+        testGrayscaleInput();
+        testYuvInput();
+        testPixelFormats();
+        testHighBitDepth();
+        testColorGradient();
+        testPreSmoothing();
+        testRegions();
+        testPyramid();
         
-        printSummary();
+        return printSummary();
     }
 };
 
 int main() {
     try {
         ValidationTest validator;
-        validator.runAllTests();
-        return 0;
+        return validator.runAllTests() ? 0 : 1;
     } catch (const std::exception& e) {
         std::cerr << "Test framework error: " << e.what() << std::endl;
         return 1;